@@ -18,6 +18,7 @@ HEADERS += src/MPlot/MPlot_global.h \
 		src/MPlot/MPlotLegend.h \
 		src/MPlot/MPlotMarker.h \
 		src/MPlot/MPlotSeriesData.h \
+		src/MPlot/MPlotTypedSeriesData.h \
 		src/MPlot/MPlotTools.h \
 		src/MPlot/MPlotAbstractTool.h \
 		src/MPlot/MPlotItem.h \
@@ -25,6 +26,29 @@ HEADERS += src/MPlot/MPlot_global.h \
 		src/MPlot/MPlotColorMap.h \
 		src/MPlot/MPlotImage.h \
 		src/MPlot/MPlotImageData.h \
+		src/MPlot/MPlotTiledImageData.h \
+		src/MPlot/MPlotTypedImageData.h \
+		src/MPlot/MPlotScrollingImageData.h \
+		src/MPlot/MPlotSlidingExtrema.h \
+		src/MPlot/MPlotMinMax.h \
+		src/MPlot/MPlotExtentsIndex.h \
+		src/MPlot/MPlotIngestBuffer.h \
+		src/MPlot/MPlotSnapshotData.h \
+		src/MPlot/MPlotSeriesTableModel.h \
+		src/MPlot/MPlotSeriesRetention.h \
+		src/MPlot/MPlotCompressedSeriesData.h \
+		src/MPlot/MPlotTieredSeriesData.h \
+		src/MPlot/MPlotDerivedSeriesData.h \
+		src/MPlot/MPlotDecimation.h \
+		src/MPlot/MPlotSharedXSeriesTable.h \
+		src/MPlot/MPlotRollingStatistics.h \
+		src/MPlot/MPlotSeriesBand.h \
+		src/MPlot/MPlotHistogramSeriesData.h \
+		src/MPlot/MPlotSeriesHistogram.h \
+		src/MPlot/MPlotFFT.h \
+		src/MPlot/MPlotSpectrumSeriesData.h \
+		src/MPlot/MPlotParallel.h \
+		src/MPlot/MPlotMappedData.h \
 		src/MPlot/MPlotPoint.h \
 		src/MPlot/MPlotAxisScale.h \
 		src/MPlot/MPlotRectangle.h \
@@ -38,6 +62,28 @@ SOURCES += src/MPlot/MPlot.cpp \
 		src/MPlot/MPlotColorMap.cpp \
 		src/MPlot/MPlotImage.cpp \
 		src/MPlot/MPlotImageData.cpp \
+		src/MPlot/MPlotTiledImageData.cpp \
+		src/MPlot/MPlotScrollingImageData.cpp \
+		src/MPlot/MPlotSlidingExtrema.cpp \
+		src/MPlot/MPlotMinMax.cpp \
+		src/MPlot/MPlotExtentsIndex.cpp \
+		src/MPlot/MPlotIngestBuffer.cpp \
+		src/MPlot/MPlotSnapshotData.cpp \
+		src/MPlot/MPlotSeriesTableModel.cpp \
+		src/MPlot/MPlotSeriesRetention.cpp \
+		src/MPlot/MPlotCompressedSeriesData.cpp \
+		src/MPlot/MPlotTieredSeriesData.cpp \
+		src/MPlot/MPlotDerivedSeriesData.cpp \
+		src/MPlot/MPlotDecimation.cpp \
+		src/MPlot/MPlotSharedXSeriesTable.cpp \
+		src/MPlot/MPlotRollingStatistics.cpp \
+		src/MPlot/MPlotSeriesBand.cpp \
+		src/MPlot/MPlotHistogramSeriesData.cpp \
+		src/MPlot/MPlotSeriesHistogram.cpp \
+		src/MPlot/MPlotFFT.cpp \
+		src/MPlot/MPlotSpectrumSeriesData.cpp \
+		src/MPlot/MPlotParallel.cpp \
+		src/MPlot/MPlotMappedData.cpp \
 		src/MPlot/MPlotItem.cpp \
 		src/MPlot/MPlotLegend.cpp \
 		src/MPlot/MPlotMarker.cpp \
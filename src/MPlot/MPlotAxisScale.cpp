@@ -26,6 +26,7 @@ void MPlotAxisScale::setOrientation(Qt::Orientation orientation)
 
 	emit drawingSizeAboutToChange();	// effective drawing size will change, because we're now using the opposite span (vertical instead of horizontal, or vice versa) for the scaling calculation.
 	orientation_ = orientation;
+	updateMapping();
 	emit drawingSizeChanged();
 }
 
@@ -33,6 +34,7 @@ void MPlotAxisScale::setDrawingSize(const QSizeF &newSize)
 {
 	emit drawingSizeAboutToChange();
 	drawingSize_ = newSize;
+	updateMapping();
 	emit drawingSizeChanged();
 }
 
@@ -94,6 +96,7 @@ void MPlotAxisScale::setDataRange(const MPlotAxisRange &newDataRange, bool apply
 		dataRange_ = MPlotAxisRange(dataRange_.max(), dataRange_.min());
 	}
 
+	updateMapping();
 	emit dataRangeChanged();
 }
 
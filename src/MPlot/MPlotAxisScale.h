@@ -10,6 +10,7 @@
 
 #include <cmath>
 #include <cfloat>
+#include <string.h>
 
 #include <limits>
 
@@ -112,100 +113,141 @@ protected:
 	bool valid_;
 };
 
-/// This class handles all the size aspects for a particular axis.  It manages the range of the axis, how big the axis should be, and some of the other specifics for the axis.  It is kind of like the model for MPlotAxis.  It holds all the relevent information and MPlotAxis paints the axis based on that information.
-class MPLOTSHARED_EXPORT MPlotAxisScale : public QObject
-{
-	Q_OBJECT
-
-public:
-	/// Constructor.  Sets some default values to the \param dataRange, \param drawingSize, and \param axisPaddingPercent.  However, it must be specified whether or not the axis scale is veritcal or horizontal because that effects the calculation of some of the properties.
-	MPlotAxisScale(Qt::Orientation orientation,
-				   const QSizeF& drawingSize = QSizeF(100, 100),
-				   const MPlotAxisRange& dataRange = MPlotAxisRange(0, 10),
-				   qreal axisPaddingPercent = 5,
-				   QObject* parent = 0);
+/// This class maps data values to drawing values along one axis, with coefficients computed once for a given range and drawing size.  MPlotAxisScale keeps one up to date in MPlotAxisScale::mapping().
+/*! Mapping is done in two steps:
+- transform() takes the data value to t: the data value itself on a linear scale, and its log10 on a log scale (-infinity for values <= 0, which have none).  This step doesn't depend on the range, so callers that map the same data many times can keep the transformed values (see transformValues()), and only redo the second step when the range changes.
+- mapTransformed() is affine: drawing = offset() + (t - origin())*scale().  The orientation is folded into the coefficients (a vertical axis has offset() at the drawing length, and a negative scale()).  On a log scale, t = -infinity (data values <= 0) is mapped like the lowest end of the range.
 
-	/// Returns the data value in scene coordinates (ie: is properly scaled within the confines of the minimum and maximum range that is displayed).
-	qreal mapDataToDrawing(qreal dataValue) const {
-		qreal min = dataRange_.min();
-		qreal max = dataRange_.max();
+mapValues() does both.  The loops are templates on the scale (linear or log), chosen once per call, with no divisions and no branches besides the -infinity select, so the compiler can vectorize them.  (log10 itself is not vectorized.)
 
-		if(logScaleEnabled_ && min>0.0 && max>0.0) {
-			if(dataValue <= 0.0)// When log scaling is active, ensure we bound datavalue within (min,max), since it can't be 0 or negative.  Note that min,max might not be in the order you think they are...: min might be > max.
-				dataValue = log10(qBound(qMin(min,max), dataValue, qMax(min,max)));
-			else
-				dataValue = log10(dataValue);
-			min = log10(min);
+The results differ from dividing by the range length for each value (which MPlotAxisScale used to do) by at most 3 ulps of the drawing length (or of the result, for values far outside the range): far below what can be drawn. */
+class MPLOTSHARED_EXPORT MPlotAxisMapping {
+public:
+	/// Constructs the identity mapping.
+	MPlotAxisMapping() { logScale_ = false; origin_ = 0; scale_ = 1; offset_ = 0; logLowest_ = 0; }
+	/// Constructs the mapping of the range from \c min to \c max onto a \c drawingLength long axis with \c orientation, on a log scale if \c logScale (and both \c min and \c max are > 0).
+	MPlotAxisMapping(qreal min, qreal max, qreal drawingLength, Qt::Orientation orientation, bool logScale) {
+		logScale_ = logScale && min > 0.0 && max > 0.0;
+		if(logScale_) {
+			origin_ = log10(min);
 			max = log10(max);
+			logLowest_ = qMin(origin_, max);
+		}
+		else {
+			origin_ = min;
+			logLowest_ = 0;
 		}
 
-		if(orientation_ == Qt::Vertical)
-			return drawingSize_.height() * (1 - (dataValue-min)/(max-min));
-		else
-			return drawingSize_.width() * (dataValue-min)/(max-min);
+		qreal length = max - origin_;
+		if(orientation == Qt::Vertical) {
+			offset_ = drawingLength;
+			scale_ = -drawingLength/length;
+		}
+		else {
+			offset_ = 0;
+			scale_ = drawingLength/length;
+		}
 	}
 
-	/// Maps all of the data values to drawing values.  Size contains the size of the dataValues and outputValues array.
-	void mapDataValuesToDrawingValues(unsigned size, const qreal *dataValues, qreal *outputValues) const
-	{
-		qreal min = dataRange_.min();
-		qreal max = dataRange_.max();
-
-		// Handling the log separately because if we don't have to worry about logging the data we can compute the output values in a tight loop.
-		if (logScaleEnabled_ && min > 0.0 && max > 0.0){
-
-			for (unsigned i = 0; i < size; i++){
-
-				if (dataValues[i] <= 0.0)
-					outputValues[i] = log10(qBound(qMin(min, max), dataValues[i], qMax(min, max)));
-
-				else
-					outputValues[i] = log10(dataValues[i]);
-			}
-
-			min = log10(min);
-			max = log10(max);
-
-			if (orientation_ == Qt::Vertical){
-
-				qreal height = drawingSize_.height();
-				qreal maxMinDifference = max - min;
-
-				for (unsigned i = 0; i < size; i++)
-					outputValues[i] = height * (1 - (outputValues[i]-min)/maxMinDifference);
-			}
-
-			else {
-
-				qreal width = drawingSize_.width();
-				qreal maxMinDifference = max - min;
+	/// Returns true if this is a log scale mapping.
+	bool logScale() const { return logScale_; }
+	/// Returns the value of t at offset(): the minimum of the range, or its log10.
+	qreal origin() const { return origin_; }
+	/// Returns the change in drawing value per unit of t.
+	qreal scale() const { return scale_; }
+	/// Returns the drawing value of origin().
+	qreal offset() const { return offset_; }
+
+	/// Returns t for \c dataValue: log10(\c dataValue) on a log scale (-infinity if \c dataValue <= 0), or \c dataValue itself.
+	qreal transform(qreal dataValue) const { return logScale_ ? (dataValue <= 0.0 ? -std::numeric_limits<qreal>::infinity() : log10(dataValue)) : dataValue; }
+	/// Maps \c transformedValue (from transform()) to its drawing value.
+	qreal mapTransformed(qreal transformedValue) const {
+		if(logScale_ && transformedValue == -std::numeric_limits<qreal>::infinity())
+			transformedValue = logLowest_;
+		return offset_ + (transformedValue - origin_)*scale_;
+	}
+	/// Maps \c dataValue to its drawing value.
+	qreal map(qreal dataValue) const { return mapTransformed(transform(dataValue)); }
+
+	/// Transforms \c size values from \c dataValues into \c outputValues (see transform()).  They can be the same array.
+	void transformValues(unsigned size, const qreal* dataValues, qreal* outputValues) const {
+		if(logScale_)
+			logKernel(size, dataValues, outputValues);
+		else if(outputValues != dataValues)
+			memmove(outputValues, dataValues, size*sizeof(qreal));
+	}
+	/// Maps \c size values from transformValues(), from \c transformedValues into \c outputValues.  They can be the same array.
+	void mapTransformedValues(unsigned size, const qreal* transformedValues, qreal* outputValues) const {
+		if(logScale_)
+			affineKernel<true>(size, transformedValues, outputValues);
+		else
+			affineKernel<false>(size, transformedValues, outputValues);
+	}
+	/// Maps \c size values from \c dataValues into \c outputValues.  They can be the same array.
+	void mapValues(unsigned size, const qreal* dataValues, qreal* outputValues) const {
+		if(logScale_) {
+			logKernel(size, dataValues, outputValues);
+			affineKernel<true>(size, outputValues, outputValues);
+		}
+		else
+			affineKernel<false>(size, dataValues, outputValues);
+	}
 
-				for (unsigned i = 0; i < size; i++)
-					outputValues[i] = width * ((outputValues[i]-min)/maxMinDifference);
+protected:
+	/// The log10 pass of a log scale.
+	static void logKernel(unsigned size, const qreal* dataValues, qreal* outputValues) {
+		const qreal negativeInfinity = -std::numeric_limits<qreal>::infinity();
+		for(unsigned i=0; i<size; ++i)
+			outputValues[i] = dataValues[i] <= 0.0 ? negativeInfinity : log10(dataValues[i]);
+	}
+	/// The multiply-add, with the coefficients in locals so that the loop vectorizes.  On a log scale, -infinity is replaced by the lowest end of the range first.
+	template<bool LogScale>
+	void affineKernel(unsigned size, const qreal* transformedValues, qreal* outputValues) const {
+		const qreal origin = origin_, scale = scale_, offset = offset_;
+
+		if(LogScale) {
+			const qreal negativeInfinity = -std::numeric_limits<qreal>::infinity();
+			const qreal logLowest = logLowest_;
+			for(unsigned i=0; i<size; ++i) {
+				qreal t = transformedValues[i];
+				outputValues[i] = offset + ((t == negativeInfinity ? logLowest : t) - origin)*scale;
 			}
 		}
-
 		else {
+			for(unsigned i=0; i<size; ++i)
+				outputValues[i] = offset + (transformedValues[i] - origin)*scale;
+		}
+	}
 
-			if (orientation_ == Qt::Vertical){
+	/// True for a log scale.
+	bool logScale_;
+	/// Coefficients: drawing = offset_ + (t - origin_)*scale_.
+	qreal origin_, scale_, offset_;
+	/// On a log scale, t for data values <= 0: the log10 of the lowest end of the range.
+	qreal logLowest_;
+};
 
-				qreal height = drawingSize_.height();
-				qreal maxMinDifference = max - min;
+/// This class handles all the size aspects for a particular axis.  It manages the range of the axis, how big the axis should be, and some of the other specifics for the axis.  It is kind of like the model for MPlotAxis.  It holds all the relevent information and MPlotAxis paints the axis based on that information.
+class MPLOTSHARED_EXPORT MPlotAxisScale : public QObject
+{
+	Q_OBJECT
 
-				for (unsigned i = 0; i < size; i++)
-					outputValues[i] = height * (1 - (dataValues[i]-min)/maxMinDifference);
-			}
+public:
+	/// Constructor.  Sets some default values to the \param dataRange, \param drawingSize, and \param axisPaddingPercent.  However, it must be specified whether or not the axis scale is veritcal or horizontal because that effects the calculation of some of the properties.
+	MPlotAxisScale(Qt::Orientation orientation,
+				   const QSizeF& drawingSize = QSizeF(100, 100),
+				   const MPlotAxisRange& dataRange = MPlotAxisRange(0, 10),
+				   qreal axisPaddingPercent = 5,
+				   QObject* parent = 0);
 
-			else {
+	/// Returns the data value in scene coordinates (ie: is properly scaled within the confines of the minimum and maximum range that is displayed).
+	qreal mapDataToDrawing(qreal dataValue) const { return mapping_.map(dataValue); }
 
-				qreal width = drawingSize_.width();
-				qreal maxMinDifference = max - min;
+	/// Maps all of the data values to drawing values.  Size contains the size of the dataValues and outputValues array.
+	void mapDataValuesToDrawingValues(unsigned size, const qreal *dataValues, qreal *outputValues) const { mapping_.mapValues(size, dataValues, outputValues); }
 
-				for (unsigned i = 0; i < size; i++)
-					outputValues[i] = width * ((dataValues[i]-min)/maxMinDifference);
-			}
-		}
-	}
+	/// Returns the current mapping from data values to drawing values, with its coefficients.  It changes when the data range, drawing size, orientation or log scaling change.
+	const MPlotAxisMapping& mapping() const { return mapping_; }
 
 	/// Returns the MPlotAxisRange of the axis scale but within the confines of the scene size.
 	MPlotAxisRange mapDataToDrawing(const MPlotAxisRange& dataRange) const {
@@ -370,6 +412,11 @@ protected:
 	/// True if logarithmic scaling should be applied on this axis.
 	bool logScaleEnabled_;
 
+	/// The mapping from data values to drawing values, updated whenever the data range, drawing size, orientation or log scaling change.
+	MPlotAxisMapping mapping_;
+	/// Recomputes mapping_.
+	void updateMapping() { mapping_ = MPlotAxisMapping(dataRange_.min(), dataRange_.max(), drawingLength(), orientation_, logScaleEnabled_); }
+
 	/// Applied as a constraint on setDataRange().  No matter what data range users attempt to set, it will not extend outside of this range.  (You can use this, for example, to constrain a logScaleEnabled() axis from (1, 1.0/0.0), therefore ensuring that it isn't auto-scaled to include 0 even if the data includes 0.
 	MPlotAxisRange dataRangeConstraint_;
 };
@@ -310,6 +310,11 @@ bool MPlotColorMapData::operator !=(const MPlotColorMapData &other) const
 }
 
 bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range, QRgb *output)
+{
+	return rgbValues(values.constData(), values.size(), range, output);
+}
+
+bool MPlotColorMap::rgbValues(const qreal *values, int count, MPlotInterval range, QRgb *output) const
 {
 	if (d->recomputeCachedColorsRequired_)
 		d->recomputeCachedColors();
@@ -318,7 +323,7 @@ bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range,
 
 		QRgb defaultValue = rgbAtIndex(0);
 
-		for (int i = 0, size = values.size(); i < size; i++)
+		for (int i = 0; i < count; i++)
 			output[i] = defaultValue;
 	}
 
@@ -329,16 +334,16 @@ bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range,
 		qreal contrast = d->contrast_;
 		qreal brightness = d->brightness_;
 		qreal gamma = d->gamma_;
-		QVector<QRgb> colorArray = d->colorArray_;
-		int colorArraySize = colorArray.size();
+		const QRgb* colorArray = d->colorArray_.constData();
+		int colorArraySize = d->colorArray_.size();
 
 		if (d->mustApplyBCG_){
 
 			if (gamma == 1.0){
 
-				for (int i = 0, size = values.size(); i < size; i++){
+				for (int i = 0; i < count; i++){
 
-					int index = (int)qRound((contrast*((values.at(i)-range.first)/rangeDifference+brightness))*lastColorArrayIndex);
+					int index = (int)qRound((contrast*((values[i]-range.first)/rangeDifference+brightness))*lastColorArrayIndex);
 
 					if (index < 0)
 						index = 0;
@@ -346,15 +351,15 @@ bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range,
 					else if (index >= colorArraySize)
 						index = lastColorArrayIndex;
 
-					output[i] = colorArray.at(index);
+					output[i] = colorArray[index];
 				}
 			}
 
 			else{
 
-				for(int i = 0, size = values.size(); i < size; i++){
+				for(int i = 0; i < count; i++){
 
-					int index = (int)qRound((contrast*(pow((values.at(i)-range.first)/rangeDifference, gamma)+brightness))*lastColorArrayIndex);
+					int index = (int)qRound((contrast*(pow((values[i]-range.first)/rangeDifference, gamma)+brightness))*lastColorArrayIndex);
 
 					if (index < 0)
 						index = 0;
@@ -362,16 +367,16 @@ bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range,
 					else if (index >= colorArraySize)
 						index = lastColorArrayIndex;
 
-					output[i] = colorArray.at(index);
+					output[i] = colorArray[index];
 				}
 			}
 		}
 
 		else{
 
-			for(int i = 0, size = values.size(); i < size; i++){
+			for(int i = 0; i < count; i++){
 
-				int index = (int)qRound(((values.at(i)-range.first)/rangeDifference*lastColorArrayIndex));
+				int index = (int)qRound(((values[i]-range.first)/rangeDifference*lastColorArrayIndex));
 
 				if (index < 0)
 					index = 0;
@@ -379,7 +384,7 @@ bool MPlotColorMap::rgbValues(const QVector<qreal> &values, MPlotInterval range,
 				else if (index >= colorArraySize)
 					index = lastColorArrayIndex;
 
-				output[i] = colorArray.at(index);
+				output[i] = colorArray[index];
 			}
 		}
 	}
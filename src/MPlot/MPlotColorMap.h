@@ -167,6 +167,8 @@ public:
 
 	/// Values implementation for returning QRgb values.  The method requires a list of values that need to be converted, the range, and the pointer to the list of QRgb's you want the results saved to.  Returns true if successful.  \param output needs to be properly allocated before being passed in.
 	bool rgbValues(const QVector<qreal> &values, MPlotInterval range, QRgb *output);
+	/// Overloaded to work on a raw array of \c count values, so that callers can colorize directly out of their own buffers (ex: one image scanline at a time).  \param output needs to be properly allocated before being passed in.
+	bool rgbValues(const qreal* values, int count, MPlotInterval range, QRgb *output) const;
 	/// Values implementation for returning QRgb values.  The method requires a list of values between 0 and 1 and the pointer to the list of QRgb values.  \param output needs to be properly allocated before being passed in.
 	bool rgbValues(const QVector<qreal> &values, QRgb *output);
 	/// Values implementation for returning QRgb values.  The method takes a list of indices between 0 and resolution()-1 and sets QRgb values.  \param output needs to be properly allocated before being passed in.
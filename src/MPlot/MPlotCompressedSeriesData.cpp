@@ -0,0 +1,380 @@
+#ifndef MPLOTCOMPRESSEDSERIESDATA_CPP
+#define MPLOTCOMPRESSEDSERIESDATA_CPP
+
+#include "MPlot/MPlotCompressedSeriesData.h"
+
+#include <string.h>
+#include <limits>
+
+/// Appends values of a given number of bits to a stream of 64-bit words, most significant bit first.
+class MPlotBitWriter {
+public:
+	MPlotBitWriter(QVector<quint64>& words) : words_(words), bitCount_(0) { words_.clear(); }
+
+	/// Writes the low \c bits bits of \c value (0 to 64 bits). The other bits of \c value must be 0.
+	void write(quint64 value, int bits) {
+		if(bits == 0)
+			return;
+		int used = bitCount_ & 63;
+		if(used == 0)
+			words_.append(0);
+		int space = 64 - used;
+		if(bits <= space)
+			words_.last() |= value << (space - bits);
+		else {
+			words_.last() |= value >> (bits - space);
+			words_.append(value << (64 - (bits - space)));
+		}
+		bitCount_ += bits;
+	}
+
+protected:
+	QVector<quint64>& words_;
+	qint64 bitCount_;
+};
+
+/// Reads back values written by MPlotBitWriter.
+class MPlotBitReader {
+public:
+	MPlotBitReader(const quint64* words) : words_(words), position_(0) {}
+
+	/// Reads a value of \c bits bits (0 to 64).
+	quint64 read(int bits) {
+		if(bits == 0)
+			return 0;
+		const quint64* word = words_ + (position_ >> 6);
+		int used = int(position_ & 63);
+		int space = 64 - used;
+		quint64 result = (word[0] << used) >> (64 - bits);
+		if(bits > space)
+			result |= word[1] >> (64 - (bits - space));
+		position_ += bits;
+		return result;
+	}
+	/// Reads one bit.
+	bool readBit() { return read(1) != 0; }
+
+protected:
+	const quint64* words_;
+	qint64 position_;
+};
+
+static inline quint64 bitsOf(qreal value) { quint64 bits; memcpy(&bits, &value, sizeof(bits)); return bits; }
+static inline qreal valueOf(quint64 bits) { qreal value; memcpy(&value, &bits, sizeof(value)); return value; }
+
+static inline int leadingZeros(quint64 value) {
+	int n = 0;
+	for(int shift = 32; shift > 0; shift /= 2)
+		if(!(value >> (64 - shift))) { n += shift; value <<= shift; }
+	return n;
+}
+static inline int trailingZeros(quint64 value) {
+	int n = 0;
+	for(int shift = 32; shift > 0; shift /= 2)
+		if(!(value << (64 - shift))) { n += shift; value >>= shift; }
+	return n;
+}
+
+// Delta-of-delta buckets for the x values: (prefix, prefix length, value bits). The last bucket holds anything.
+static const int dodBucketCount = 6;
+static const int dodPrefixes[dodBucketCount] = { 0x0, 0x2, 0x6, 0xE, 0x1E, 0x1F };
+static const int dodPrefixBits[dodBucketCount] = { 1, 2, 3, 4, 5, 5 };
+static const int dodValueBits[dodBucketCount] = { 0, 7, 9, 12, 32, 64 };
+
+void MPlotCompressedSeriesData::encodeBlock(const qreal *xValues, const qreal *yValues, int count, QVector<quint64> &bits)
+{
+	MPlotBitWriter writer(bits);
+	if(count < 1)
+		return;
+
+	quint64 previousX = bitsOf(xValues[0]);
+	quint64 previousY = bitsOf(yValues[0]);
+	quint64 previousDelta = 0;
+	int previousLeading = -1, previousTrailing = 0;
+
+	writer.write(previousX, 64);
+	writer.write(previousY, 64);
+
+	for(int i=1; i<count; ++i) {
+		// x: delta of delta of the bits (wrapping arithmetic, so it's lossless for any values), zigzag-encoded so small negative numbers stay small.
+		quint64 currentX = bitsOf(xValues[i]);
+		quint64 delta = currentX - previousX;
+		qint64 dod = qint64(delta - previousDelta);
+		quint64 zigzag = (quint64(dod) << 1) ^ quint64(dod >> 63);
+
+		int bucket = 0;
+		if(zigzag) {
+			bucket = 1;
+			while(bucket < dodBucketCount-1 && (zigzag >> dodValueBits[bucket]))
+				++bucket;
+		}
+		writer.write(dodPrefixes[bucket], dodPrefixBits[bucket]);
+		writer.write(zigzag, dodValueBits[bucket]);
+
+		previousX = currentX;
+		previousDelta = delta;
+
+		// y: XOR with the previous value, keeping only the meaningful bits.
+		quint64 currentY = bitsOf(yValues[i]);
+		quint64 xorValue = currentY ^ previousY;
+		if(xorValue == 0)
+			writer.write(0, 1);
+		else {
+			int leading = qMin(31, leadingZeros(xorValue));
+			int trailing = trailingZeros(xorValue);
+
+			if(previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+				// fits in the previous window
+				writer.write(0x2, 2);
+				writer.write(xorValue >> previousTrailing, 64 - previousLeading - previousTrailing);
+			}
+			else {
+				int meaningful = 64 - leading - trailing;
+				writer.write(0x3, 2);
+				writer.write(quint64(leading), 5);
+				writer.write(quint64(meaningful & 63), 6);	// 64 is stored as 0: there is always at least one meaningful bit.
+				writer.write(xorValue >> trailing, meaningful);
+				previousLeading = leading;
+				previousTrailing = trailing;
+			}
+		}
+		previousY = currentY;
+	}
+}
+
+void MPlotCompressedSeriesData::decodeBlock(const quint64 *bits, int count, qreal *xValues, qreal *yValues)
+{
+	if(count < 1)
+		return;
+
+	MPlotBitReader reader(bits);
+
+	quint64 previousX = reader.read(64);
+	quint64 previousY = reader.read(64);
+	quint64 previousDelta = 0;
+	int previousLeading = 0, previousTrailing = 0;
+
+	xValues[0] = valueOf(previousX);
+	yValues[0] = valueOf(previousY);
+
+	for(int i=1; i<count; ++i) {
+		int bucket = 0;
+		while(bucket < dodBucketCount-2 && reader.readBit())
+			++bucket;
+		if(bucket == dodBucketCount-2 && reader.readBit())
+			++bucket;
+
+		quint64 zigzag = reader.read(dodValueBits[bucket]);
+		quint64 dod = (zigzag >> 1) ^ (0 - (zigzag & 1));
+		quint64 delta = previousDelta + dod;
+		previousX += delta;
+		previousDelta = delta;
+		xValues[i] = valueOf(previousX);
+
+		if(reader.readBit()) {
+			if(reader.readBit()) {
+				previousLeading = int(reader.read(5));
+				int meaningful = int(reader.read(6));
+				if(meaningful == 0)
+					meaningful = 64;
+				previousTrailing = 64 - previousLeading - meaningful;
+			}
+			previousY ^= reader.read(64 - previousLeading - previousTrailing) << previousTrailing;
+		}
+		yValues[i] = valueOf(previousY);
+	}
+}
+
+MPlotSeriesBlockSummary MPlotCompressedSeriesData::summarize(const qreal *xValues, const qreal *yValues, int count, int first)
+{
+	MPlotMinMax xRange, yRange;
+	xRange.add(xValues, count);
+	yRange.add(yValues, count);
+
+	MPlotSeriesBlockSummary summary;
+	summary.first = first;
+	summary.count = count;
+	summary.minX = xRange.minimum();
+	summary.maxX = xRange.maximum();
+	summary.minY = yRange.minimum();
+	summary.maxY = yRange.maximum();
+	summary.firstX = count ? xValues[0] : std::numeric_limits<qreal>::quiet_NaN();
+	summary.firstY = count ? yValues[0] : std::numeric_limits<qreal>::quiet_NaN();
+	summary.lastX = count ? xValues[count-1] : std::numeric_limits<qreal>::quiet_NaN();
+	summary.lastY = count ? yValues[count-1] : std::numeric_limits<qreal>::quiet_NaN();
+	return summary;
+}
+
+MPlotCompressedSeriesData::MPlotCompressedSeriesData(int blockSize, int cachedBlocks)
+	: MPlotAbstractSeriesData()
+{
+	blockSize_ = qMax(2, blockSize);
+	cacheCapacity_ = qMax(1, cachedBlocks);
+	compressedBytes_ = 0;
+}
+
+MPlotCompressedSeriesData::~MPlotCompressedSeriesData()
+{
+}
+
+qreal MPlotCompressedSeriesData::x(unsigned index) const
+{
+	int block = int(index) / blockSize_;
+	if(block >= blocks_.size())
+		return tailX_.at(int(index) - blocks_.size()*blockSize_);
+	return decodedBlock(block).x.at(int(index) - block*blockSize_);
+}
+
+qreal MPlotCompressedSeriesData::y(unsigned index) const
+{
+	int block = int(index) / blockSize_;
+	if(block >= blocks_.size())
+		return tailY_.at(int(index) - blocks_.size()*blockSize_);
+	return decodedBlock(block).y.at(int(index) - block*blockSize_);
+}
+
+void MPlotCompressedSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	copyValues(indexStart, indexEnd, true, outputValues);
+}
+
+void MPlotCompressedSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	copyValues(indexStart, indexEnd, false, outputValues);
+}
+
+void MPlotCompressedSeriesData::copyValues(unsigned indexStart, unsigned indexEnd, bool isX, qreal *outputValues) const
+{
+	int index = int(indexStart);
+	int end = int(indexEnd);
+	int sealedCount = blocks_.size()*blockSize_;
+
+	while(index <= end) {
+		if(index >= sealedCount) {
+			const QVector<qreal>& tail = isX ? tailX_ : tailY_;
+			memcpy(outputValues, tail.constData() + (index-sealedCount), (end-index+1)*sizeof(qreal));
+			return;
+		}
+
+		int block = index / blockSize_;
+		int offset = index - block*blockSize_;
+		int runLength = qMin(end+1, (block+1)*blockSize_) - index;
+		const DecodedBlock& decoded = decodedBlock(block);
+		memcpy(outputValues, (isX ? decoded.x : decoded.y).constData() + offset, runLength*sizeof(qreal));
+
+		outputValues += runLength;
+		index += runLength;
+	}
+}
+
+QRectF MPlotCompressedSeriesData::boundingRect() const
+{
+	if(count() == 0)
+		return QRectF();
+
+	qreal minX = xRange_.minimum(), maxX = xRange_.maximum();
+	qreal minY = yRange_.minimum(), maxY = yRange_.maximum();
+	return QRectF(minX,
+				  minY,
+				  qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+				  qMax(maxY-minY, std::numeric_limits<qreal>::min()));	// same as MPlotAbstractSeriesData::boundingRect(): keep a single point valid.
+}
+
+bool MPlotCompressedSeriesData::blockSummaries(int first, int last, QVector<MPlotSeriesBlockSummary> &summaries) const
+{
+	summaries.clear();
+	first = qMax(0, first);
+	last = qMin(count()-1, last);
+	if(first > last)
+		return true;
+
+	int lastSealed = qMin(last/blockSize_, blocks_.size()-1);
+	for(int block = first/blockSize_; block <= lastSealed; ++block)
+		summaries << blocks_.at(block).summary;
+
+	// the tail isn't sealed yet: summarize it now (it's shorter than a block).
+	if(last >= blocks_.size()*blockSize_)
+		summaries << summarize(tailX_.constData(), tailY_.constData(), tailX_.size(), blocks_.size()*blockSize_);
+
+	return true;
+}
+
+void MPlotCompressedSeriesData::append(const qreal *xValues, const qreal *yValues, int count)
+{
+	if(count < 1)
+		return;
+
+	int first = this->count();
+	xRange_.add(xValues, count);
+	yRange_.add(yValues, count);
+
+	for(int i=0; i<count; ++i) {
+		tailX_.append(xValues[i]);
+		tailY_.append(yValues[i]);
+		if(tailX_.size() == blockSize_)
+			sealTail();
+	}
+
+	emitRowsAppended(first, first+count-1);
+}
+
+void MPlotCompressedSeriesData::clear()
+{
+	blocks_.clear();
+	tailX_.clear();
+	tailY_.clear();
+	cache_.clear();
+	xRange_ = MPlotMinMax();
+	yRange_ = MPlotMinMax();
+	compressedBytes_ = 0;
+
+	emitDataReset();
+}
+
+void MPlotCompressedSeriesData::setCachedBlocks(int cachedBlocks)
+{
+	cacheCapacity_ = qMax(1, cachedBlocks);
+	while(cache_.size() > cacheCapacity_)
+		cache_.removeLast();
+}
+
+void MPlotCompressedSeriesData::sealTail()
+{
+	Block block;
+	block.summary = summarize(tailX_.constData(), tailY_.constData(), tailX_.size(), blocks_.size()*blockSize_);
+	encodeBlock(tailX_.constData(), tailY_.constData(), tailX_.size(), block.bits);
+	block.bits.squeeze();
+	compressedBytes_ += block.bits.size()*sizeof(quint64);
+	blocks_ << block;
+
+	tailX_.resize(0);
+	tailY_.resize(0);
+
+	blockSealed(blocks_.size()-1);
+}
+
+const MPlotCompressedSeriesData::DecodedBlock & MPlotCompressedSeriesData::decodedBlock(int block) const
+{
+	for(int i=0, size=cache_.size(); i<size; ++i) {
+		if(cache_.at(i).block == block) {
+			if(i > 0)
+				cache_.move(i, 0);
+			return cache_.first();
+		}
+	}
+
+	// not cached: decode it, replacing the least recently used one.
+	if(cache_.size() >= cacheCapacity_)
+		cache_.removeLast();
+
+	DecodedBlock decoded;
+	decoded.block = block;
+	decoded.x.resize(blockSize_);
+	decoded.y.resize(blockSize_);
+	decodeBlock(blockBits(block), blockSize_, decoded.x.data(), decoded.y.data());
+	cache_.prepend(decoded);
+
+	return cache_.first();
+}
+
+#endif // MPLOTCOMPRESSEDSERIESDATA_CPP
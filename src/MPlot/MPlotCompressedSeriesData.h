@@ -0,0 +1,117 @@
+#ifndef MPLOTCOMPRESSEDSERIESDATA_H
+#define MPLOTCOMPRESSEDSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <QVector>
+#include <QList>
+
+/// The default number of points in each compressed block of an MPlotCompressedSeriesData.
+#define MPLOT_COMPRESSED_BLOCK_SIZE 4096
+/// The default number of decompressed blocks an MPlotCompressedSeriesData keeps, for repeated reads.
+#define MPLOT_COMPRESSED_CACHED_BLOCKS 8
+
+/// This class is a series model for long histories, which stores its points compressed in blocks.
+/*! Points are appended at the end.  They collect in an uncompressed tail block, and once blockSize() points have been collected, the block is sealed: it is compressed, losslessly, the way time-series databases do it (Gorilla-style):
+- The x values are stored as the delta of their delta, computed on the bits of the qreal.  Regularly sampled x values (ex: time stamps at a fixed rate) have a delta of delta of 0 almost everywhere, which costs 1 bit.
+- The y values are XOR-ed with the previous value; the result is stored as only its meaningful bits, reusing the previous position of those bits when it fits.  Slowly changing or repeated values take a few bits each.
+
+Regularly sampled x with integer-valued or steady y (ex: ADC counts) takes about 2 bytes per point instead of 16.  Full-precision noisy y values gain little.  compressedBytes() tells the actual size.
+
+Each sealed block keeps an MPlotSeriesBlockSummary (min/max/first/last), returned by blockSummaries(), so that zoomed-out plots (see MPlotSeriesBasic) are drawn without decompressing anything.  x(), y(), xValues() and yValues() decompress the blocks they need, and keep the most recently used ones (cachedBlocks()) for the next reads.  The bounds are tracked as points are appended, so boundingRect() is constant-time.
+
+Since reading can update the cache, concurrentReadsSafe() is false. */
+class MPLOTSHARED_EXPORT MPlotCompressedSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructor. Blocks hold \c blockSize points, and up to \c cachedBlocks decompressed blocks are kept.
+	MPlotCompressedSeriesData(int blockSize = MPLOT_COMPRESSED_BLOCK_SIZE, int cachedBlocks = MPLOT_COMPRESSED_CACHED_BLOCKS);
+	/// Destructor.
+	virtual ~MPlotCompressedSeriesData();
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const;
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the y value at \c index.
+	virtual qreal y(unsigned index) const;
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points.
+	virtual int count() const { return blocks_.size()*blockSize_ + tailX_.size(); }
+	/// Returns the bounds, tracked as the points were appended.
+	virtual QRectF boundingRect() const;
+	/// Returns the summaries of the blocks holding points \c first to \c last, including the tail block.
+	virtual bool blockSummaries(int first, int last, QVector<MPlotSeriesBlockSummary>& summaries) const;
+
+	/// Appends a point at the end.
+	void append(qreal x, qreal y) { append(&x, &y, 1); }
+	/// Appends \c count points at the end, with one rowsAppended() notification.
+	void append(const qreal* xValues, const qreal* yValues, int count);
+	/// Removes all the points.
+	virtual void clear();
+
+	/// Returns the number of points in each block.
+	int blockSize() const { return blockSize_; }
+	/// Returns the number of sealed (compressed) blocks.
+	int sealedBlockCount() const { return blocks_.size(); }
+	/// Returns the memory used by the compressed blocks, in bytes.
+	qint64 compressedBytes() const { return compressedBytes_; }
+
+	/// Returns the number of decompressed blocks kept for repeated reads.
+	int cachedBlocks() const { return cacheCapacity_; }
+	/// Sets the number of decompressed blocks kept for repeated reads (at least 1).
+	void setCachedBlocks(int cachedBlocks);
+
+	/// Compresses \c count points into \c bits.  Used when a block is sealed, and available to other block-based models.
+	static void encodeBlock(const qreal* xValues, const qreal* yValues, int count, QVector<quint64>& bits);
+	/// Decompresses \c count points from \c bits into \c xValues and \c yValues.
+	static void decodeBlock(const quint64* bits, int count, qreal* xValues, qreal* yValues);
+	/// Computes the summary of \c count points, the first of which has index \c first.
+	static MPlotSeriesBlockSummary summarize(const qreal* xValues, const qreal* yValues, int count, int first);
+
+protected:
+	/// A sealed block.
+	struct Block {
+		/// Compressed points.
+		QVector<quint64> bits;
+		/// Summary of the points.
+		MPlotSeriesBlockSummary summary;
+	};
+	/// A decompressed block, in the cache.
+	struct DecodedBlock {
+		int block;
+		QVector<qreal> x, y;
+	};
+
+	/// Returns block \c block decompressed, from the cache if possible.  The reference is valid until the next call.
+	const DecodedBlock& decodedBlock(int block) const;
+	/// Copies the x (\c isX) or y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues, block by block.
+	void copyValues(unsigned indexStart, unsigned indexEnd, bool isX, qreal* outputValues) const;
+	/// Compresses the tail into a new sealed block.
+	void sealTail();
+	/// Called after block \c block was sealed. The base class implementation does nothing; re-implement to move sealed blocks elsewhere.
+	virtual void blockSealed(int block) { Q_UNUSED(block) }
+	/// Returns the compressed points of sealed block \c block.  The pointer is valid until the model is modified or another block is read.
+	virtual const quint64* blockBits(int block) const { return blocks_.at(block).bits.constData(); }
+
+	/// Number of points per block.
+	int blockSize_;
+	/// Sealed blocks.
+	QVector<Block> blocks_;
+	/// Uncompressed points of the tail block (fewer than blockSize_).
+	QVector<qreal> tailX_, tailY_;
+	/// Running extremes of all the points.
+	MPlotMinMax xRange_, yRange_;
+	/// Total size of the sealed blocks' bits, in bytes.
+	qint64 compressedBytes_;
+
+	/// Decompressed blocks, most recently used first.
+	mutable QList<DecodedBlock> cache_;
+	/// Maximum size of cache_.
+	int cacheCapacity_;
+};
+
+#endif // MPLOTCOMPRESSEDSERIESDATA_H
@@ -0,0 +1,343 @@
+#ifndef MPLOTDECIMATION_CPP
+#define MPLOTDECIMATION_CPP
+
+#include "MPlot/MPlotDecimation.h"
+#include "MPlot/MPlotMinMax.h"
+#include "MPlot/MPlotParallel.h"
+
+#include <math.h>
+#include <string.h>
+#include <limits>
+
+/// Processes the buckets of an MPlotDecimation in parts, with MPlotParallel::run().
+class MPlotDecimationJob : public MPlotParallelJob {
+public:
+	MPlotDecimationJob(const MPlotDecimation::Buckets& buckets, MPlotDecimation::Method method, int parts)
+		: buckets_(buckets), method_(method) {
+		bucketsPerPart_ = (buckets.bucketCount + parts - 1) / parts;
+	}
+	virtual void runPart(int part) {
+		int start = part*bucketsPerPart_;
+		int end = qMin(buckets_.bucketCount, start+bucketsPerPart_);
+		if(start < end)
+			MPlotDecimation::processBuckets(buckets_, method_, start, end);
+	}
+
+protected:
+	const MPlotDecimation::Buckets& buckets_;
+	MPlotDecimation::Method method_;
+	int bucketsPerPart_;
+};
+
+void MPlotDecimation::decimate(const MPlotAbstractSeriesData *data, int first, int last, int targetCount, Method method, QVector<qreal> &xValues, QVector<qreal> &yValues, QVector<int> *indexes)
+{
+	QVector<int> kept;
+	int count = last-first+1;
+
+	if(count < 1) {
+		xValues.clear();
+		yValues.clear();
+		if(indexes)
+			indexes->clear();
+		return;
+	}
+
+	// nothing to reduce: keep everything.
+	if(count <= qMax(targetCount, method == LargestTriangleThreeBuckets ? 3 : 1)) {
+		xValues.resize(count);
+		yValues.resize(count);
+		data->xValues(first, last, xValues.data());
+		data->yValues(first, last, yValues.data());
+		if(indexes) {
+			indexes->resize(count);
+			for(int i=0; i<count; ++i)
+				(*indexes)[i] = first+i;
+		}
+		return;
+	}
+
+	Buckets buckets;
+	buckets.data = data;
+
+	if(method == LargestTriangleThreeBuckets) {
+		// the first and last points are always kept; the ones in between are split into targetCount-2 buckets.
+		buckets.first = first+1;
+		buckets.count = count-2;
+		buckets.bucketCount = qMin(qMax(targetCount, 3)-2, buckets.count);
+		QVector<qreal> averages(2*buckets.bucketCount);
+		buckets.indexes = 0;
+		buckets.indexCounts = 0;
+		buckets.averages = averages.data();
+
+		processAllBuckets(buckets, method);
+
+		kept.reserve(buckets.bucketCount+2);
+		kept << first;
+		pickLargestTriangles(buckets, kept);
+		kept << last;
+	}
+
+	else {
+		buckets.first = first;
+		buckets.count = count;
+		buckets.bucketCount = qMin(qMax(1, targetCount/pointsPerBucket(method)), count);
+		QVector<int> bucketIndexes(4*buckets.bucketCount);
+		QVector<int> bucketIndexCounts(buckets.bucketCount);
+		buckets.indexes = bucketIndexes.data();
+		buckets.indexCounts = bucketIndexCounts.data();
+		buckets.averages = 0;
+
+		processAllBuckets(buckets, method);
+
+		kept.reserve(pointsPerBucket(method)*buckets.bucketCount);
+		for(int b=0; b<buckets.bucketCount; ++b)
+			for(int i=0; i<bucketIndexCounts.at(b); ++i)
+				kept << bucketIndexes.at(4*b+i);
+	}
+
+	// only the kept points' x and y values are read now.
+	int keptCount = kept.size();
+	xValues.resize(keptCount);
+	yValues.resize(keptCount);
+	for(int i=0; i<keptCount; ++i) {
+		xValues[i] = data->x(kept.at(i));
+		yValues[i] = data->y(kept.at(i));
+	}
+
+	if(indexes)
+		*indexes = kept;
+}
+
+void MPlotDecimation::processAllBuckets(const Buckets &buckets, Method method)
+{
+	int threads = MPlotParallel::threadCount();
+
+	if(threads < 2 || !buckets.data->concurrentReadsSafe() || buckets.count < MPLOT_MINMAX_CONCURRENT_THRESHOLD || buckets.bucketCount < threads) {
+		processBuckets(buckets, method, 0, buckets.bucketCount);
+		return;
+	}
+
+	// same as MPlotMinMax::search(): split between the shared pool and this thread.  The buckets write their results to separate places.
+	MPlotDecimationJob job(buckets, method, threads);
+	MPlotParallel::run(&job, threads);
+}
+
+void MPlotDecimation::processBuckets(const Buckets &buckets, Method method, int start, int end)
+{
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	int chunkSize = qMin(MPLOT_MINMAX_CHUNK, buckets.bucketStart(end) - buckets.bucketStart(start));
+	QVector<qreal> yBuffer(chunkSize);
+	QVector<qreal> xBuffer(method == LargestTriangleThreeBuckets ? chunkSize : 0);
+
+	for(int b=start; b<end; ++b) {
+		int bucketStart = buckets.bucketStart(b);
+		int bucketEnd = buckets.bucketStart(b+1);
+
+		if(method == LargestTriangleThreeBuckets) {
+			qreal sumX = 0, sumY = 0;
+			int validY = 0;
+
+			for(int chunkStart = bucketStart; chunkStart < bucketEnd; chunkStart += chunkSize) {
+				int chunkCount = qMin(chunkSize, bucketEnd-chunkStart);
+				buckets.data->xValues(chunkStart, chunkStart+chunkCount-1, xBuffer.data());
+				buckets.data->yValues(chunkStart, chunkStart+chunkCount-1, yBuffer.data());
+				for(int i=0; i<chunkCount; ++i) {
+					sumX += xBuffer.at(i);
+					if(yBuffer.at(i) == yBuffer.at(i)) {	// not NaN
+						sumY += yBuffer.at(i);
+						++validY;
+					}
+				}
+			}
+
+			buckets.averages[2*b] = sumX/(bucketEnd-bucketStart);
+			buckets.averages[2*b+1] = validY ? sumY/validY : std::numeric_limits<qreal>::quiet_NaN();
+			continue;
+		}
+
+		// four independent lanes, as in MPlotMinMax::add(). A NaN fails both comparisons, so it's never chosen.
+		qreal minimum[4] = { infinity, infinity, infinity, infinity };
+		qreal maximum[4] = { -infinity, -infinity, -infinity, -infinity };
+		int minimumIndex[4] = { -1, -1, -1, -1 };
+		int maximumIndex[4] = { -1, -1, -1, -1 };
+
+		for(int chunkStart = bucketStart; chunkStart < bucketEnd; chunkStart += chunkSize) {
+			int chunkCount = qMin(chunkSize, bucketEnd-chunkStart);
+			buckets.data->yValues(chunkStart, chunkStart+chunkCount-1, yBuffer.data());
+			const qreal* y = yBuffer.constData();
+
+			int i = 0;
+			for(; i+4 <= chunkCount; i += 4) {
+				for(int lane=0; lane<4; ++lane) {
+					if(y[i+lane] < minimum[lane]) { minimum[lane] = y[i+lane]; minimumIndex[lane] = chunkStart+i+lane; }
+					if(y[i+lane] > maximum[lane]) { maximum[lane] = y[i+lane]; maximumIndex[lane] = chunkStart+i+lane; }
+				}
+			}
+			for(; i < chunkCount; ++i) {
+				if(y[i] < minimum[0]) { minimum[0] = y[i]; minimumIndex[0] = chunkStart+i; }
+				if(y[i] > maximum[0]) { maximum[0] = y[i]; maximumIndex[0] = chunkStart+i; }
+			}
+		}
+
+		// merge the lanes. On ties, the earliest point wins, as it would in a single pass.
+		int minIndex = minimumIndex[0], maxIndex = maximumIndex[0];
+		qreal minValue = minimum[0], maxValue = maximum[0];
+		for(int lane=1; lane<4; ++lane) {
+			if(minimumIndex[lane] >= 0 && (minIndex < 0 || minimum[lane] < minValue || (minimum[lane] == minValue && minimumIndex[lane] < minIndex))) {
+				minValue = minimum[lane];
+				minIndex = minimumIndex[lane];
+			}
+			if(maximumIndex[lane] >= 0 && (maxIndex < 0 || maximum[lane] > maxValue || (maximum[lane] == maxValue && maximumIndex[lane] < maxIndex))) {
+				maxValue = maximum[lane];
+				maxIndex = maximumIndex[lane];
+			}
+		}
+
+		int candidates[4];
+		int candidateCount = 0;
+		if(method == M4 || minIndex < 0)	// a bucket of NaNs keeps its first point, so the gap still shows.
+			candidates[candidateCount++] = bucketStart;
+		if(minIndex >= 0) {
+			candidates[candidateCount++] = minIndex;
+			candidates[candidateCount++] = maxIndex;
+		}
+		if(method == M4)
+			candidates[candidateCount++] = bucketEnd-1;
+
+		// in order, without duplicates.
+		int* kept = buckets.indexes + 4*b;
+		int keptCount = 0;
+		for(int i=0; i<candidateCount; ++i) {
+			int index = candidates[i];
+			int position = keptCount;
+			while(position > 0 && kept[position-1] > index)
+				--position;
+			if(position > 0 && kept[position-1] == index)
+				continue;
+			memmove(kept+position+1, kept+position, (keptCount-position)*sizeof(int));
+			kept[position] = index;
+			++keptCount;
+		}
+		buckets.indexCounts[b] = keptCount;
+	}
+}
+
+void MPlotDecimation::pickLargestTriangles(const Buckets &buckets, QVector<int> &indexes)
+{
+	const MPlotAbstractSeriesData* data = buckets.data;
+	int chunkSize = qMin(MPLOT_MINMAX_CHUNK, buckets.count);
+	QVector<qreal> xBuffer(chunkSize), yBuffer(chunkSize);
+
+	// the point kept in the previous bucket: the first point, to start.
+	qreal ax = data->x(buckets.first-1);
+	qreal ay = data->y(buckets.first-1);
+	int lastIndex = buckets.first+buckets.count;
+
+	for(int b=0; b<buckets.bucketCount; ++b) {
+		// the average of the next bucket, or the last point after the last bucket.
+		qreal cx, cy;
+		if(b+1 < buckets.bucketCount) {
+			cx = buckets.averages[2*(b+1)];
+			cy = buckets.averages[2*(b+1)+1];
+		}
+		else {
+			cx = data->x(lastIndex);
+			cy = data->y(lastIndex);
+		}
+
+		int bucketStart = buckets.bucketStart(b);
+		int bucketEnd = buckets.bucketStart(b+1);
+		qreal largestArea = -1;
+		int largestIndex = bucketStart;
+		qreal largestX = 0, largestY = 0;
+
+		for(int chunkStart = bucketStart; chunkStart < bucketEnd; chunkStart += chunkSize) {
+			int chunkCount = qMin(chunkSize, bucketEnd-chunkStart);
+			data->xValues(chunkStart, chunkStart+chunkCount-1, xBuffer.data());
+			data->yValues(chunkStart, chunkStart+chunkCount-1, yBuffer.data());
+
+			for(int i=0; i<chunkCount; ++i) {
+				// twice the area of the triangle; NaN never wins.
+				qreal area = fabs((ax-cx)*(yBuffer.at(i)-ay) - (ax-xBuffer.at(i))*(cy-ay));
+				if(area > largestArea) {
+					largestArea = area;
+					largestIndex = chunkStart+i;
+					largestX = xBuffer.at(i);
+					largestY = yBuffer.at(i);
+				}
+			}
+		}
+
+		indexes << largestIndex;
+		if(largestArea >= 0) {
+			ax = largestX;
+			ay = largestY;
+		}
+		else {
+			ax = data->x(largestIndex);
+			ay = data->y(largestIndex);
+		}
+	}
+}
+
+
+MPlotDecimatedSeriesData::MPlotDecimatedSeriesData(const MPlotAbstractSeriesData *source, MPlotDecimation::Method method, int targetCount)
+	: MPlotAbstractDerivedSeriesData(source)
+{
+	method_ = method;
+	targetCount_ = qMax(1, targetCount);
+	dirty_ = true;
+}
+
+void MPlotDecimatedSeriesData::setMethod(MPlotDecimation::Method method)
+{
+	if(method == method_)
+		return;
+
+	method_ = method;
+	sourceReset();
+}
+
+void MPlotDecimatedSeriesData::setTargetCount(int targetCount)
+{
+	targetCount = qMax(1, targetCount);
+	if(targetCount == targetCount_)
+		return;
+
+	targetCount_ = targetCount;
+	sourceReset();
+}
+
+void MPlotDecimatedSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	update();
+	memcpy(outputValues, x_.constData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotDecimatedSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	update();
+	memcpy(outputValues, y_.constData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotDecimatedSeriesData::sourceReset()
+{
+	dirty_ = true;
+	x_.clear();
+	y_.clear();
+	indexes_.clear();
+
+	MPlotAbstractDerivedSeriesData::sourceReset();
+}
+
+void MPlotDecimatedSeriesData::update() const
+{
+	if(!dirty_)
+		return;
+
+	dirty_ = false;
+	if(source_)
+		MPlotDecimation::decimate(source_, 0, source_->count()-1, targetCount_, method_, x_, y_, &indexes_);
+}
+
+#endif // MPLOTDECIMATION_CPP
@@ -0,0 +1,105 @@
+#ifndef MPLOTDECIMATION_H
+#define MPLOTDECIMATION_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotDerivedSeriesData.h"
+
+#include <QVector>
+
+/// This class reduces a range of points of any MPlotAbstractSeriesData to about a target number of points, keeping what the eye would notice.
+/*! The range is split into buckets of consecutive points (for uniformly sampled data, buckets of equal x span), and each bucket keeps:
+- MinMax: its points with the minimum and maximum y value.  2 points per bucket.  This is what MPlotSeriesBasic draws in each pixel column.
+- M4: its first and last points, and those with the minimum and maximum y value.  4 points per bucket.  Drawn with one bucket per pixel column, the lines look exactly like those through all the points.
+- LargestTriangleThreeBuckets: the point making the largest triangle with the point kept in the previous bucket and the average of the next bucket.  1 point per bucket, plus the first and last points.  Keeps the visual shape with very few points (ex: for export or markers), but can miss single-point spikes.
+
+The points kept are always in their original order, and the first and last points of the range are always kept (except by MinMax).  NaN y values are never chosen as a minimum, maximum or largest triangle.
+
+MinMax and M4 only read the y values (the x values of the points kept are read afterward), MPLOT_MINMAX_CHUNK values at a time, with independent lanes like MPlotMinMax::add().  Over more than MPLOT_MINMAX_CONCURRENT_THRESHOLD points, if the data's reads are concurrentReadsSafe(), the buckets are split between the threads of the shared MPlotParallel pool.  LTTB computes the bucket averages the same way; picking the points is sequential by nature. */
+class MPLOTSHARED_EXPORT MPlotDecimation {
+public:
+	/// The decimation methods.
+	enum Method { MinMax, M4, LargestTriangleThreeBuckets };
+
+	/// Reduces points \c first to \c last (inclusive) of \c data to about \c targetCount points (never more, unless it is less than pointsPerBucket(), or 3 for LTTB), with \c method.  The kept points are returned in \c xValues and \c yValues, and their indexes in \c indexes if it isn't 0.  If the range has \c targetCount points or fewer, they are all kept.
+	static void decimate(const MPlotAbstractSeriesData* data, int first, int last, int targetCount, Method method, QVector<qreal>& xValues, QVector<qreal>& yValues, QVector<int>* indexes = 0);
+	/// Returns the number of points each bucket contributes, for \c method.
+	static int pointsPerBucket(Method method) { return method == M4 ? 4 : (method == MinMax ? 2 : 1); }
+
+protected:
+	/// Describes how a range of points is split into buckets, and where the per-bucket results go.
+	struct Buckets {
+		const MPlotAbstractSeriesData* data;
+		/// The first point, the number of points, and the number of buckets.
+		int first, count, bucketCount;
+		/// MinMax or M4: up to 4 kept indexes per bucket, and how many.  LTTB: 0.
+		int* indexes;
+		int* indexCounts;
+		/// LTTB: the average x and y of each bucket.  Others: 0.
+		qreal* averages;
+
+		/// Returns the index of the first point in bucket \c bucket.  (bucketCount is the end.)
+		int bucketStart(int bucket) const { return first + int(qint64(bucket)*count/bucketCount); }
+	};
+
+	/// Fills in the results for buckets [\c start, \c end): extremes for MinMax and M4 (\c method), or averages for LTTB.
+	static void processBuckets(const Buckets& buckets, Method method, int start, int end);
+	/// Runs processBuckets() over all the buckets, split between threads if it's worth it.
+	static void processAllBuckets(const Buckets& buckets, Method method);
+	/// Picks the LTTB points, using the bucket averages.  \c buckets covers the points between the first and last ones.
+	static void pickLargestTriangles(const Buckets& buckets, QVector<int>& indexes);
+	friend class MPlotDecimationJob;
+};
+
+
+/// The default number of points an MPlotDecimatedSeriesData reduces its source to.
+#define MPLOT_DECIMATION_DEFAULT_TARGET 2000
+
+/// This class is a series data showing its source decimated with MPlotDecimation, so that it can be plotted, exported or marked directly.
+/*! The decimation is computed the first time the points are read after the source changed, over the whole source, so a burst of changes costs one decimation.  Every change to the source is announced with dataReset(), since the points kept can all change. */
+class MPLOTSHARED_EXPORT MPlotDecimatedSeriesData : public MPlotAbstractDerivedSeriesData {
+
+public:
+	/// Constructor. Reduces \c source to about \c targetCount points with \c method.
+	MPlotDecimatedSeriesData(const MPlotAbstractSeriesData* source = 0, MPlotDecimation::Method method = MPlotDecimation::M4, int targetCount = MPLOT_DECIMATION_DEFAULT_TARGET);
+
+	/// Returns the decimation method.
+	MPlotDecimation::Method method() const { return method_; }
+	/// Sets the decimation method.
+	void setMethod(MPlotDecimation::Method method);
+	/// Returns the target number of points.
+	int targetCount() const { return targetCount_; }
+	/// Sets the target number of points.
+	void setTargetCount(int targetCount);
+
+	/// Returns the index in the source of point \c index.
+	int sourceIndex(unsigned index) const { update(); return indexes_.at(index); }
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const { update(); return x_.at(index); }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the y value at \c index.
+	virtual qreal y(unsigned index) const { update(); return y_.at(index); }
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points kept.
+	virtual int count() const { update(); return x_.size(); }
+
+protected:
+	/// Throws away the decimation.
+	virtual void sourceReset();
+	/// Computes the decimation, if it was thrown away.
+	void update() const;
+
+	/// Decimation method.
+	MPlotDecimation::Method method_;
+	/// Target number of points.
+	int targetCount_;
+	/// The decimated points, and their indexes in the source.
+	mutable QVector<qreal> x_, y_;
+	mutable QVector<int> indexes_;
+	/// True when the decimation must be computed again.
+	mutable bool dirty_;
+};
+
+#endif // MPLOTDECIMATION_H
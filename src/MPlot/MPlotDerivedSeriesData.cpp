@@ -0,0 +1,499 @@
+#ifndef MPLOTDERIVEDSERIESDATA_CPP
+#define MPLOTDERIVEDSERIESDATA_CPP
+
+#include "MPlot/MPlotDerivedSeriesData.h"
+
+#include <string.h>
+#include <math.h>
+#include <limits>
+
+MPlotDerivedSeriesSignalHandler::MPlotDerivedSeriesSignalHandler(MPlotAbstractDerivedSeriesData *parent)
+	: QObject(0)
+{
+	data_ = parent;
+}
+
+void MPlotDerivedSeriesSignalHandler::onDataChanged()
+{
+	if(data_->changeDescribed_)
+		data_->changeDescribed_ = false;
+	else
+		data_->sourceReset();
+}
+
+void MPlotDerivedSeriesSignalHandler::onRowsAppended(int first, int last)
+{
+	data_->changeDescribed_ = true;
+	data_->sourceRowsAppended(first, last);
+}
+
+void MPlotDerivedSeriesSignalHandler::onRowsRemovedFront(int count)
+{
+	data_->changeDescribed_ = true;
+	data_->sourceRowsRemovedFront(count);
+}
+
+void MPlotDerivedSeriesSignalHandler::onValuesChanged(int first, int last)
+{
+	data_->changeDescribed_ = true;
+	data_->sourceValuesChanged(first, last);
+}
+
+void MPlotDerivedSeriesSignalHandler::onDataReset()
+{
+	data_->changeDescribed_ = true;
+	data_->sourceReset();
+}
+
+void MPlotDerivedSeriesSignalHandler::onSourceDestroyed()
+{
+	data_->source_ = 0;
+	data_->changeDescribed_ = false;
+	data_->sourceReset();
+}
+
+
+MPlotAbstractDerivedSeriesData::MPlotAbstractDerivedSeriesData(const MPlotAbstractSeriesData *source)
+	: MPlotAbstractSeriesData()
+{
+	source_ = source;
+	changeDescribed_ = false;
+	signalHandler_ = new MPlotDerivedSeriesSignalHandler(this);
+
+	// not setSource(): there's nothing to reset yet, and sourceReset() is virtual.
+	connectSource();
+}
+
+MPlotAbstractDerivedSeriesData::~MPlotAbstractDerivedSeriesData()
+{
+	delete signalHandler_;
+	signalHandler_ = 0;
+}
+
+void MPlotAbstractDerivedSeriesData::setSource(const MPlotAbstractSeriesData *source)
+{
+	if(source == source_)
+		return;
+
+	if(source_)
+		QObject::disconnect(source_->signalSource(), 0, signalHandler_, 0);
+
+	source_ = source;
+	changeDescribed_ = false;
+
+	connectSource();
+
+	sourceReset();
+}
+
+void MPlotAbstractDerivedSeriesData::connectSource()
+{
+	if(!source_)
+		return;
+
+	QObject::connect(source_->signalSource(), SIGNAL(dataChanged()), signalHandler_, SLOT(onDataChanged()));
+	QObject::connect(source_->signalSource(), SIGNAL(rowsAppended(int,int)), signalHandler_, SLOT(onRowsAppended(int,int)));
+	QObject::connect(source_->signalSource(), SIGNAL(rowsRemovedFront(int)), signalHandler_, SLOT(onRowsRemovedFront(int)));
+	QObject::connect(source_->signalSource(), SIGNAL(valuesChanged(int,int)), signalHandler_, SLOT(onValuesChanged(int,int)));
+	QObject::connect(source_->signalSource(), SIGNAL(dataReset()), signalHandler_, SLOT(onDataReset()));
+	QObject::connect(source_->signalSource(), SIGNAL(destroyed()), signalHandler_, SLOT(onSourceDestroyed()));
+}
+
+
+MPlotLazyDerivedSeriesData::MPlotLazyDerivedSeriesData(const MPlotAbstractSeriesData *source)
+	: MPlotAbstractDerivedSeriesData(source)
+{
+	cachedChunks_ = MPLOT_DERIVED_CACHED_CHUNKS;
+}
+
+qreal MPlotLazyDerivedSeriesData::y(unsigned index) const
+{
+	return chunk(int(index)/MPLOT_DERIVED_CHUNK_SIZE).at(int(index)%MPLOT_DERIVED_CHUNK_SIZE);
+}
+
+void MPlotLazyDerivedSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	int index = int(indexStart);
+	int end = int(indexEnd);
+
+	while(index <= end) {
+		int chunkNumber = index/MPLOT_DERIVED_CHUNK_SIZE;
+		int offset = index - chunkNumber*MPLOT_DERIVED_CHUNK_SIZE;
+		int runLength = qMin(end+1, (chunkNumber+1)*MPLOT_DERIVED_CHUNK_SIZE) - index;
+
+		memcpy(outputValues, chunk(chunkNumber).constData() + offset, runLength*sizeof(qreal));
+		outputValues += runLength;
+		index += runLength;
+	}
+}
+
+void MPlotLazyDerivedSeriesData::setCachedChunks(int cachedChunks)
+{
+	cachedChunks_ = qMax(1, cachedChunks);
+	while(chunkOrder_.size() > cachedChunks_)
+		chunks_.remove(chunkOrder_.takeLast());
+}
+
+const QVector<qreal> & MPlotLazyDerivedSeriesData::chunk(int chunk) const
+{
+	QHash<int, QVector<qreal> >::const_iterator cached = chunks_.constFind(chunk);
+	if(cached != chunks_.constEnd()) {
+		if(chunkOrder_.first() != chunk) {
+			chunkOrder_.removeOne(chunk);
+			chunkOrder_.prepend(chunk);
+		}
+		return cached.value();
+	}
+
+	// not computed yet: compute it, and forget the least recently used one if we have too many.
+	int first = chunk*MPLOT_DERIVED_CHUNK_SIZE;
+	QVector<qreal> values(qMin(MPLOT_DERIVED_CHUNK_SIZE, count()-first));
+	computeY(first, values.size(), values.data());
+
+	chunks_.insert(chunk, values);
+	chunkOrder_.prepend(chunk);
+	while(chunkOrder_.size() > cachedChunks_)
+		chunks_.remove(chunkOrder_.takeLast());
+
+	return chunks_.constFind(chunk).value();
+}
+
+void MPlotLazyDerivedSeriesData::invalidate(int first, int last)
+{
+	int firstChunk = qMax(0, first)/MPLOT_DERIVED_CHUNK_SIZE;
+	int lastChunk = last < 0 ? std::numeric_limits<int>::max() : last/MPLOT_DERIVED_CHUNK_SIZE;
+
+	for(int i=chunkOrder_.size()-1; i>=0; --i) {
+		int chunk = chunkOrder_.at(i);
+		if(chunk >= firstChunk && chunk <= lastChunk) {
+			chunks_.remove(chunk);
+			chunkOrder_.removeAt(i);
+		}
+	}
+}
+
+void MPlotLazyDerivedSeriesData::sourceRowsAppended(int first, int last)
+{
+	// the last points before the new ones may look ahead at them.
+	int changedFirst = qMax(0, first-lookAhead());
+	invalidate(changedFirst);
+
+	if(changedFirst < first)
+		emitValuesChanged(changedFirst, first-1);
+	emitRowsAppended(first, last);
+}
+
+void MPlotLazyDerivedSeriesData::sourceRowsRemovedFront(int count)
+{
+	invalidate(0);
+	emitRowsRemovedFront(count);
+
+	// the first points lost some of the history they look back at.
+	int remaining = this->count();
+	int changed = lookBehind() < 0 ? remaining : qMin(lookBehind(), remaining);
+	if(changed > 0)
+		emitValuesChanged(0, changed-1);
+}
+
+void MPlotLazyDerivedSeriesData::sourceValuesChanged(int first, int last)
+{
+	int count = this->count();
+	int changedFirst = qMax(0, first-lookAhead());
+	int changedLast = lookBehind() < 0 ? count-1 : qMin(count-1, last+lookBehind());
+
+	invalidate(changedFirst, changedLast);
+	if(changedFirst <= changedLast)
+		emitValuesChanged(changedFirst, changedLast);
+}
+
+void MPlotLazyDerivedSeriesData::sourceReset()
+{
+	invalidate(0);
+	MPlotAbstractDerivedSeriesData::sourceReset();
+}
+
+
+MPlotMovingAverageSeriesData::MPlotMovingAverageSeriesData(const MPlotAbstractSeriesData *source, int window)
+	: MPlotLazyDerivedSeriesData(source)
+{
+	window_ = qMax(1, window);
+}
+
+void MPlotMovingAverageSeriesData::setWindow(int window)
+{
+	window = qMax(1, window);
+	if(window == window_)
+		return;
+
+	window_ = window;
+	invalidate(0);
+	if(count() > 0)
+		emitValuesChanged(0, count()-1);
+}
+
+void MPlotMovingAverageSeriesData::computeY(int first, int count, qreal *outputValues) const
+{
+	// read the window before the first point too.
+	int start = qMax(0, first-window_+1);
+	QVector<qreal> y(first+count-start);
+	source_->yValues(start, first+count-1, y.data());
+
+	qreal sum = 0;
+	int valid = 0;
+	for(int i=0, size=y.size(); i<size; ++i) {
+		if(y.at(i) == y.at(i)) {	// not NaN
+			sum += y.at(i);
+			++valid;
+		}
+		if(i >= window_ && y.at(i-window_) == y.at(i-window_)) {
+			sum -= y.at(i-window_);
+			--valid;
+		}
+		if(start+i >= first)
+			outputValues[start+i-first] = valid ? sum/valid : std::numeric_limits<qreal>::quiet_NaN();
+	}
+}
+
+
+MPlotDerivativeSeriesData::MPlotDerivativeSeriesData(const MPlotAbstractSeriesData *source)
+	: MPlotLazyDerivedSeriesData(source)
+{
+}
+
+void MPlotDerivativeSeriesData::computeY(int first, int count, qreal *outputValues) const
+{
+	int size = source_->count();
+	if(size < 2) {
+		for(int i=0; i<count; ++i)
+			outputValues[i] = std::numeric_limits<qreal>::quiet_NaN();
+		return;
+	}
+
+	// one more point on each side, when there is one.
+	int start = qMax(0, first-1);
+	int end = qMin(size-1, first+count);
+	QVector<qreal> x(end-start+1), y(end-start+1);
+	source_->xValues(start, end, x.data());
+	source_->yValues(start, end, y.data());
+
+	for(int i=first; i<first+count; ++i) {
+		int left = qMax(0, i-1) - start;
+		int right = qMin(size-1, i+1) - start;
+		outputValues[i-first] = (y.at(right)-y.at(left)) / (x.at(right)-x.at(left));
+	}
+}
+
+
+MPlotIntegralSeriesData::MPlotIntegralSeriesData(const MPlotAbstractSeriesData *source)
+	: MPlotLazyDerivedSeriesData(source)
+{
+}
+
+qreal MPlotIntegralSeriesData::integrate(int first, int count, qreal start, qreal *outputValues) const
+{
+	QVector<qreal> x(count), y(count);
+	source_->xValues(first, first+count-1, x.data());
+	source_->yValues(first, first+count-1, y.data());
+
+	qreal integral = start;
+	if(outputValues)
+		outputValues[0] = integral;
+
+	for(int i=1; i<count; ++i) {
+		qreal area = (x.at(i)-x.at(i-1)) * (y.at(i)+y.at(i-1)) / 2;
+		if(area == area)	// not NaN
+			integral += area;
+		if(outputValues)
+			outputValues[i] = integral;
+	}
+
+	return integral;
+}
+
+void MPlotIntegralSeriesData::computeY(int first, int count, qreal *outputValues) const
+{
+	int chunkNumber = first/MPLOT_DERIVED_CHUNK_SIZE;
+
+	// the integral at the start of each chunk up to this one. The ones before are complete.
+	if(chunkStarts_.isEmpty())
+		chunkStarts_ << 0.0;
+	while(chunkStarts_.size() <= chunkNumber) {
+		int previous = chunkStarts_.size()-1;
+		int previousFirst = previous*MPLOT_DERIVED_CHUNK_SIZE;
+		qreal integral = integrate(previousFirst, MPLOT_DERIVED_CHUNK_SIZE, chunkStarts_.at(previous), 0);
+
+		// and the segment joining the two chunks
+		int joint = previousFirst + MPLOT_DERIVED_CHUNK_SIZE;
+		qreal area = (source_->x(joint)-source_->x(joint-1)) * (source_->y(joint)+source_->y(joint-1)) / 2;
+		if(area == area)
+			integral += area;
+
+		chunkStarts_ << integral;
+	}
+
+	integrate(first, count, chunkStarts_.at(chunkNumber), outputValues);
+}
+
+void MPlotIntegralSeriesData::invalidate(int first, int last)
+{
+	// the start of chunk c depends on every point up to c*MPLOT_DERIVED_CHUNK_SIZE.
+	int validStarts = (qMax(0, first) + MPLOT_DERIVED_CHUNK_SIZE - 1)/MPLOT_DERIVED_CHUNK_SIZE;
+	if(chunkStarts_.size() > validStarts)
+		chunkStarts_.resize(validStarts);
+
+	MPlotLazyDerivedSeriesData::invalidate(first, last);
+}
+
+
+MPlotResampledSeriesData::MPlotResampledSeriesData(const MPlotAbstractSeriesData *source, qreal step)
+	: MPlotLazyDerivedSeriesData(source)
+{
+	step_ = step > 0 ? step : 1.0;
+}
+
+void MPlotResampledSeriesData::setStep(qreal step)
+{
+	if(!(step > 0) || step == step_)
+		return;
+
+	step_ = step;
+	sourceReset();
+}
+
+int MPlotResampledSeriesData::count() const
+{
+	int size = source_ ? source_->count() : 0;
+	if(size == 0)
+		return 0;
+
+	qreal span = source_->x(size-1) - x0();
+	if(!(span > 0))	// also NaN
+		return 1;
+	return int(floor(span/step_)) + 1;
+}
+
+void MPlotResampledSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	qreal start = x0();
+	for(unsigned i=indexStart; i<=indexEnd; ++i)
+		*(outputValues++) = start + i*step_;
+}
+
+bool MPlotResampledSeriesData::uniformXSpacing(qreal &x0, qreal &dx) const
+{
+	if(count() == 0)
+		return false;
+
+	x0 = this->x0();
+	dx = step_;
+	return true;
+}
+
+int MPlotResampledSeriesData::lowerBound(qreal x) const
+{
+	int low = 0, high = source_->count();
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(source_->x(middle) < x)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+void MPlotResampledSeriesData::computeY(int first, int count, qreal *outputValues) const
+{
+	const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+	int size = source_->count();
+	qreal start = x0();
+
+	// the source points around the chunk: read them all if there aren't many more than the points we compute, otherwise search for each point.
+	int sourceFirst = qMax(0, lowerBound(start + first*step_) - 1);
+	int sourceLast = qMin(size-1, lowerBound(start + (first+count-1)*step_));
+	bool readAll = sourceLast-sourceFirst < 4*count;
+
+	QVector<qreal> x, y;
+	if(readAll) {
+		x.resize(sourceLast-sourceFirst+1);
+		y.resize(sourceLast-sourceFirst+1);
+		source_->xValues(sourceFirst, sourceLast, x.data());
+		source_->yValues(sourceFirst, sourceLast, y.data());
+	}
+
+	int right = sourceFirst;	// first source point with x >= the x we're computing
+	for(int i=0; i<count; ++i) {
+		qreal xi = start + (first+i)*step_;
+		qreal rightX;
+
+		if(readAll) {
+			while(right <= sourceLast && x.at(right-sourceFirst) < xi)
+				++right;
+			rightX = right <= sourceLast ? x.at(right-sourceFirst) : nan;
+		}
+		else {
+			right = lowerBound(xi);
+			rightX = right < size ? source_->x(right) : nan;
+		}
+
+		if(right >= size || (right == 0 && rightX != xi)) {
+			outputValues[i] = nan;
+			continue;
+		}
+
+		qreal rightY = readAll ? y.at(right-sourceFirst) : source_->y(right);
+		if(rightX == xi || right == 0) {
+			outputValues[i] = rightY;
+			continue;
+		}
+
+		qreal leftX = readAll ? x.at(right-1-sourceFirst) : source_->x(right-1);
+		qreal leftY = readAll ? y.at(right-1-sourceFirst) : source_->y(right-1);
+		outputValues[i] = leftY + (rightY-leftY) * (xi-leftX) / (rightX-leftX);
+	}
+}
+
+void MPlotResampledSeriesData::sourceRowsAppended(int first, int last)
+{
+	Q_UNUSED(last)
+
+	if(first == 0) {
+		sourceReset();
+		return;
+	}
+
+	// the points up to the previous last x value don't change.
+	qreal previousSpan = source_->x(first-1) - x0();
+	int previousCount = previousSpan > 0 ? int(floor(previousSpan/step_)) + 1 : 1;
+	int newCount = count();
+
+	invalidate(previousCount);
+	if(newCount > previousCount)
+		emitRowsAppended(previousCount, newCount-1);
+}
+
+void MPlotResampledSeriesData::sourceRowsRemovedFront(int count)
+{
+	Q_UNUSED(count)
+	sourceReset();
+}
+
+void MPlotResampledSeriesData::sourceValuesChanged(int first, int last)
+{
+	int size = source_->count();
+	// the first or last x value moved: every point may have moved.
+	if(first == 0 || last >= size-1) {
+		sourceReset();
+		return;
+	}
+
+	qreal start = x0();
+	int changedFirst = qMax(0, int(ceil((source_->x(first-1) - start)/step_)));
+	int changedLast = qMin(count()-1, int(floor((source_->x(last+1) - start)/step_)));
+
+	invalidate(changedFirst, changedLast);
+	if(changedFirst <= changedLast)
+		emitValuesChanged(changedFirst, changedLast);
+}
+
+#endif // MPLOTDERIVEDSERIESDATA_CPP
@@ -0,0 +1,246 @@
+#ifndef MPLOTDERIVEDSERIESDATA_H
+#define MPLOTDERIVEDSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+class MPlotAbstractDerivedSeriesData;
+
+/// This class receives the signals of the source of an MPlotAbstractDerivedSeriesData. You should never need to use it directly.
+class MPLOTSHARED_EXPORT MPlotDerivedSeriesSignalHandler : public QObject {
+	Q_OBJECT
+protected:
+	/// Builds a signal handler for derived data.
+	MPlotDerivedSeriesSignalHandler(MPlotAbstractDerivedSeriesData* parent);
+	/// Giving access to the derived data's methods.
+	friend class MPlotAbstractDerivedSeriesData;
+
+protected slots:
+	/// Handles changes to the source.
+	void onDataChanged();
+	/// Handles points added at the end of the source. (Always followed by onDataChanged().)
+	void onRowsAppended(int first, int last);
+	/// Handles points removed from the front of the source. (Always followed by onDataChanged().)
+	void onRowsRemovedFront(int count);
+	/// Handles changes to the values of some points of the source. (Always followed by onDataChanged().)
+	void onValuesChanged(int first, int last);
+	/// Handles the source being replaced. (Always followed by onDataChanged().)
+	void onDataReset();
+	/// Forgets the source when it is deleted.
+	void onSourceDestroyed();
+
+protected:
+	/// The derived data we handle signals for.
+	MPlotAbstractDerivedSeriesData* data_;
+};
+
+
+/// This is the base class for series data computed from another series data (the source), like a decimated or smoothed version of it.
+/*! It follows the source's signals, and passes each change on to a virtual function: sourceRowsAppended(), sourceRowsRemovedFront(), sourceValuesChanged() or sourceReset() (for any change that wasn't described more precisely).  The base class implementations of the first three call sourceReset(), which emits dataReset(); re-implement them to update incrementally.
+
+Derived data can be the source of other derived data, so they can be chained.  If the source is deleted, the derived data becomes empty. */
+class MPLOTSHARED_EXPORT MPlotAbstractDerivedSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructor. \c source can be 0.
+	MPlotAbstractDerivedSeriesData(const MPlotAbstractSeriesData* source = 0);
+	/// Destructor.
+	virtual ~MPlotAbstractDerivedSeriesData();
+
+	/// Returns the source, or 0 if there is none.
+	const MPlotAbstractSeriesData* source() const { return source_; }
+	/// Derives from \c source instead (or from nothing, if 0).
+	void setSource(const MPlotAbstractSeriesData* source);
+
+protected:
+	/// Called after points \c first to \c last were appended to the source.  The base class implementation calls sourceReset().
+	virtual void sourceRowsAppended(int first, int last) { Q_UNUSED(first) Q_UNUSED(last) sourceReset(); }
+	/// Called after \c count points were removed from the front of the source.  The base class implementation calls sourceReset().
+	virtual void sourceRowsRemovedFront(int count) { Q_UNUSED(count) sourceReset(); }
+	/// Called after the values of points \c first to \c last of the source changed.  The base class implementation calls sourceReset().
+	virtual void sourceValuesChanged(int first, int last) { Q_UNUSED(first) Q_UNUSED(last) sourceReset(); }
+	/// Called after the source changed in any other way, or was replaced.  Re-implement to throw away what was computed, and call the base class implementation, which emits dataReset().
+	virtual void sourceReset() { emitDataReset(); }
+	/// Connects the source's signals to signalHandler_.
+	void connectSource();
+
+	/// The source.
+	const MPlotAbstractSeriesData* source_;
+	/// Receives signals from the source.
+	MPlotDerivedSeriesSignalHandler* signalHandler_;
+	friend class MPlotDerivedSeriesSignalHandler;
+	/// True when the source described its last change with a specific signal, so the dataChanged() that follows can be ignored.
+	bool changeDescribed_;
+};
+
+
+/// The number of points an MPlotLazyDerivedSeriesData computes at once, and caches together.
+#define MPLOT_DERIVED_CHUNK_SIZE 4096
+/// The default number of computed chunks an MPlotLazyDerivedSeriesData keeps.
+#define MPLOT_DERIVED_CACHED_CHUNKS 64
+
+/// This is the base class for derived series data whose y values are computed from the source on demand, a chunk of MPLOT_DERIVED_CHUNK_SIZE points at a time.
+/*! Only the chunks that are read get computed, and the most recently used ones are kept (cachedChunks()).  Nothing is copied from the source beforehand, so derived data can be chained (ex: the derivative of a moving average) without any intermediate array: each one reads just the points it needs from the one before.
+
+By default, point i of the derived data has the x value of point i of the source.  Subclasses implement computeY(), and say which source points each value depends on with lookBehind() and lookAhead().  With that, changes to the source only throw away the chunks they affect:
+- Points appended to the source: the chunks from the first affected point on (usually only the last, incomplete chunk) are recomputed, and the new points are announced with rowsAppended().
+- Values changed in the source: the affected chunks are recomputed, and announced with valuesChanged().
+- Points removed from the front: the chunks no longer line up, so they are all thrown away, and the change is announced with rowsRemovedFront() (and valuesChanged() for the first points, whose history was removed). */
+class MPLOTSHARED_EXPORT MPlotLazyDerivedSeriesData : public MPlotAbstractDerivedSeriesData {
+
+public:
+	/// Constructor. Derives from \c source.
+	MPlotLazyDerivedSeriesData(const MPlotAbstractSeriesData* source = 0);
+
+	/// Returns the x value at \c index: the source's, by default.
+	virtual qreal x(unsigned index) const { return source_->x(index); }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues: the source's, by default.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const { source_->xValues(indexStart, indexEnd, outputValues); }
+	/// Returns the y value at \c index, computing its chunk if needed.
+	virtual qreal y(unsigned index) const;
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues, computing the chunks needed.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points: the source's, by default.
+	virtual int count() const { return source_ ? source_->count() : 0; }
+
+	/// Returns the number of computed chunks kept.
+	int cachedChunks() const { return cachedChunks_; }
+	/// Sets the number of computed chunks kept (at least 1).
+	void setCachedChunks(int cachedChunks);
+
+protected:
+	/// Computes the y values of points \c first to \c first+\c count-1 into \c outputValues.  \c first is always at the start of a chunk, and the range never goes past the end of it.
+	virtual void computeY(int first, int count, qreal* outputValues) const = 0;
+	/// Returns how many source points before point i its value depends on (ex: window-1 for a moving average), or -1 if it depends on all of them.
+	virtual int lookBehind() const = 0;
+	/// Returns how many source points after point i its value depends on.  The base class implementation returns 0.
+	virtual int lookAhead() const { return 0; }
+
+	/// Throws away the chunks holding points \c first to \c last, or to the end if \c last is -1.  Re-implement to throw away other things that were computed, and call the base class implementation.
+	virtual void invalidate(int first, int last = -1);
+	/// Returns the y values of chunk \c chunk, computing them if needed.  The reference is valid until the next call.
+	const QVector<qreal>& chunk(int chunk) const;
+
+	/// Re-implemented to recompute only the affected chunks.
+	virtual void sourceRowsAppended(int first, int last);
+	/// Re-implemented to keep the points that didn't change.
+	virtual void sourceRowsRemovedFront(int count);
+	/// Re-implemented to recompute only the affected chunks.
+	virtual void sourceValuesChanged(int first, int last);
+	/// Re-implemented to throw away all the chunks.
+	virtual void sourceReset();
+
+	/// Computed chunks, by chunk number.
+	mutable QHash<int, QVector<qreal> > chunks_;
+	/// Chunk numbers, most recently used first.
+	mutable QList<int> chunkOrder_;
+	/// Maximum size of chunks_.
+	int cachedChunks_;
+};
+
+
+/// This class is a moving average of its source's y values: each point is the average of its y value and those of the window()-1 points before it (fewer at the start).  NaN values are left out of the average.
+class MPLOTSHARED_EXPORT MPlotMovingAverageSeriesData : public MPlotLazyDerivedSeriesData {
+
+public:
+	/// Constructor. Averages \c window points.
+	MPlotMovingAverageSeriesData(const MPlotAbstractSeriesData* source = 0, int window = 10);
+
+	/// Returns the number of points averaged.
+	int window() const { return window_; }
+	/// Sets the number of points averaged.
+	void setWindow(int window);
+
+protected:
+	virtual void computeY(int first, int count, qreal* outputValues) const;
+	virtual int lookBehind() const { return window_-1; }
+
+	/// Number of points averaged.
+	int window_;
+};
+
+
+/// This class is the derivative dy/dx of its source, by central differences (one-sided at the ends).
+class MPLOTSHARED_EXPORT MPlotDerivativeSeriesData : public MPlotLazyDerivedSeriesData {
+
+public:
+	/// Constructor.
+	MPlotDerivativeSeriesData(const MPlotAbstractSeriesData* source = 0);
+
+protected:
+	virtual void computeY(int first, int count, qreal* outputValues) const;
+	virtual int lookBehind() const { return 1; }
+	virtual int lookAhead() const { return 1; }
+};
+
+
+/// This class is the running integral of its source, by the trapezoidal rule, starting from 0 at the first point.  Segments with a NaN end add nothing.
+/*! Reading a chunk needs the integral up to its start, so the integral at the start of every chunk is remembered once computed: reading any point costs at most one chunk after the first time, and points appended only extend the integral. */
+class MPLOTSHARED_EXPORT MPlotIntegralSeriesData : public MPlotLazyDerivedSeriesData {
+
+public:
+	/// Constructor.
+	MPlotIntegralSeriesData(const MPlotAbstractSeriesData* source = 0);
+
+protected:
+	virtual void computeY(int first, int count, qreal* outputValues) const;
+	virtual int lookBehind() const { return -1; }
+	virtual void invalidate(int first, int last = -1);
+
+	/// Computes the integral of points \c first to \c first+\c count-1, starting from \c start at point \c first, into \c outputValues (if not 0).  Returns the integral at the last point.
+	qreal integrate(int first, int count, qreal start, qreal* outputValues) const;
+
+	/// The integral at the start of each chunk, for the chunks computed so far.
+	mutable QVector<qreal> chunkStarts_;
+};
+
+
+/// This class resamples its source at evenly spaced x values, by linear interpolation, so that it can be drawn without reading x values (see uniformXSpacing()) or combined with other resampled data.
+/*! The points are at x = x0 + i*step(), from the first x value of the source up to its last.  The source's x values must be increasing.  Points outside the source, or next to a NaN, are NaN.  Appending to the source only adds points at the end. */
+class MPLOTSHARED_EXPORT MPlotResampledSeriesData : public MPlotLazyDerivedSeriesData {
+
+public:
+	/// Constructor. Resamples every \c step in x.
+	MPlotResampledSeriesData(const MPlotAbstractSeriesData* source = 0, qreal step = 1.0);
+
+	/// Returns the spacing of the x values.
+	qreal step() const { return step_; }
+	/// Sets the spacing of the x values.
+	void setStep(qreal step);
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const { return x0() + index*step_; }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points.
+	virtual int count() const;
+	/// The x values are evenly spaced.
+	virtual bool uniformXSpacing(qreal& x0, qreal& dx) const;
+
+protected:
+	virtual void computeY(int first, int count, qreal* outputValues) const;
+	virtual int lookBehind() const { return 1; }
+	virtual int lookAhead() const { return 1; }
+
+	/// Re-implemented: appending to the source only adds points.
+	virtual void sourceRowsAppended(int first, int last);
+	/// Re-implemented: the points move, so they are all thrown away.
+	virtual void sourceRowsRemovedFront(int count);
+	/// Re-implemented: throws away the points around the x values that changed.
+	virtual void sourceValuesChanged(int first, int last);
+
+	/// Returns the first x value of the source.
+	qreal x0() const { return source_->x(0); }
+	/// Returns the index of the first source point with an x value of at least \c x (count() if none).
+	int lowerBound(qreal x) const;
+
+	/// Spacing of the x values.
+	qreal step_;
+};
+
+#endif // MPLOTDERIVEDSERIESDATA_H
@@ -0,0 +1,130 @@
+#ifndef MPLOTEXTENTSINDEX_CPP
+#define MPLOTEXTENTSINDEX_CPP
+
+#include "MPlot/MPlotExtentsIndex.h"
+
+#include <qnumeric.h>
+#include <limits>
+
+MPlotExtentsIndex::MPlotExtentsIndex()
+{
+	count_ = 0;
+}
+
+void MPlotExtentsIndex::build(const qreal *values, int count)
+{
+	count_ = qMax(0, count);
+	values_.resize(count_);
+	minIndexes_.resize(2*count_);
+	maxIndexes_.resize(2*count_);
+
+	for(int i=0; i<count_; ++i) {
+		values_[i] = values[i];
+		minIndexes_[count_+i] = maxIndexes_[count_+i] = i;
+	}
+
+	for(int node=count_-1; node>=1; --node)
+		updateNode(node);
+}
+
+void MPlotExtentsIndex::clear()
+{
+	build(0, 0);
+}
+
+void MPlotExtentsIndex::setValue(int index, qreal value)
+{
+	values_[index] = value;
+
+	for(int node=(count_+index)/2; node>=1; node/=2)
+		updateNode(node);
+}
+
+void MPlotExtentsIndex::setValues(int startIndex, const qreal *values, int count)
+{
+	if(count < 1)
+		return;
+
+	for(int i=0; i<count; ++i)
+		values_[startIndex+i] = values[i];
+
+	// update the parents of the changed nodes one step up at a time: the run of changed nodes halves at each step.  (When the size is not a power of two, a run can hold nodes of different depths; going from the highest node number down still updates every child before its parent.)
+	int first = count_+startIndex;
+	int last = first+count-1;
+	while(last > 1) {
+		first = qMax(1, first/2);
+		last /= 2;
+		for(int node=last; node>=first; --node)
+			updateNode(node);
+	}
+}
+
+bool MPlotExtentsIndex::isValid() const
+{
+	return count_ && !qIsNaN(values_.at(minIndexes_.at(1)));
+}
+
+qreal MPlotExtentsIndex::minimum() const
+{
+	return isValid() ? values_.at(minIndexes_.at(1)) : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+qreal MPlotExtentsIndex::maximum() const
+{
+	return isValid() ? values_.at(maxIndexes_.at(1)) : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+bool MPlotExtentsIndex::rangeMinMax(int first, int last, qreal &minimum, qreal &maximum) const
+{
+	first = qMax(0, first);
+	last = qMin(count_-1, last);
+	if(first > last)
+		return false;
+
+	int minIndex = first, maxIndex = first;
+
+	// standard bottom-up query over the half-open range of leaves [l, r).
+	for(int l = count_+first, r = count_+last+1; l < r; l /= 2, r /= 2) {
+		if(l & 1) {
+			minIndex = pickMinimum(minIndex, minIndexes_.at(l));
+			maxIndex = pickMaximum(maxIndex, maxIndexes_.at(l));
+			++l;
+		}
+		if(r & 1) {
+			--r;
+			minIndex = pickMinimum(minIndex, minIndexes_.at(r));
+			maxIndex = pickMaximum(maxIndex, maxIndexes_.at(r));
+		}
+	}
+
+	if(qIsNaN(values_.at(minIndex)))
+		return false;
+
+	minimum = values_.at(minIndex);
+	maximum = values_.at(maxIndex);
+	return true;
+}
+
+int MPlotExtentsIndex::pickMinimum(int a, int b) const
+{
+	qreal va = values_.at(a), vb = values_.at(b);
+
+	if(vb < va || (qIsNaN(va) && !qIsNaN(vb)))
+		return b;
+	if(va < vb || (qIsNaN(vb) && !qIsNaN(va)))
+		return a;
+	return qMin(a, b);
+}
+
+int MPlotExtentsIndex::pickMaximum(int a, int b) const
+{
+	qreal va = values_.at(a), vb = values_.at(b);
+
+	if(vb > va || (qIsNaN(va) && !qIsNaN(vb)))
+		return b;
+	if(va > vb || (qIsNaN(vb) && !qIsNaN(va)))
+		return a;
+	return qMin(a, b);
+}
+
+#endif // MPLOTEXTENTSINDEX_CPP
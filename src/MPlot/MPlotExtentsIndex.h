@@ -0,0 +1,70 @@
+#ifndef MPLOTEXTENTSINDEX_H
+#define MPLOTEXTENTSINDEX_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QVector>
+
+/// This class is a segment tree that keeps track of the minimum and maximum of an array of values, so that the extremes stay up to date when values are edited.
+/*! After build(), changing one value with setValue() costs O(log n), and changing a run of k values with setValues() costs O(k + log n).  minimum() and maximum() (and the index where they are found) are then available in constant time, and the minimum and maximum over any index range in O(log n) with rangeMinMax().
+
+Each node of the tree remembers the index of the smallest and of the largest value below it.  NaN values are skipped (they never win against a number), the same way MPlotMinMax skips them.  When two values are equal, the lower index wins.
+
+Use it in models that allow editing (ex: dragging a point), where searching the whole data whenever the edited point was the extreme would be too slow.  It takes about 24 bytes per value.
+*/
+class MPLOTSHARED_EXPORT MPlotExtentsIndex {
+public:
+	/// Constructor. Creates an empty index.
+	MPlotExtentsIndex();
+
+	/// Builds the tree over \c count \c values, in O(n).  The values are copied.
+	void build(const qreal* values, int count);
+	/// Removes all the values.
+	void clear();
+
+	/// Returns the number of values.
+	int count() const { return count_; }
+	/// Returns the value at \c index.
+	qreal value(int index) const { return values_.at(index); }
+
+	/// Changes the value at \c index to \c value, and updates the tree in O(log n).
+	void setValue(int index, qreal value);
+	/// Changes \c count values starting at \c startIndex to \c values, and updates the tree in O(count + log n).
+	void setValues(int startIndex, const qreal* values, int count);
+
+	/// Returns true if there is at least one value that is not NaN.
+	bool isValid() const;
+	/// Returns the minimum value, or NaN if !isValid().
+	qreal minimum() const;
+	/// Returns the maximum value, or NaN if !isValid().
+	qreal maximum() const;
+	/// Returns the index of the minimum value, or -1 if empty.
+	int minimumIndex() const { return count_ ? minIndexes_.at(1) : -1; }
+	/// Returns the index of the maximum value, or -1 if empty.
+	int maximumIndex() const { return count_ ? maxIndexes_.at(1) : -1; }
+
+	/// Finds the minimum and maximum of the values from \c first to \c last (inclusive) in O(log n).  Returns false if the range is empty or has only NaN values.
+	bool rangeMinMax(int first, int last, qreal& minimum, qreal& maximum) const;
+
+protected:
+	/// The values. Leaf i of the tree is node count_+i.
+	QVector<qreal> values_;
+	/// For each node (1 to 2*count_-1), the index of the smallest value below it.
+	QVector<int> minIndexes_;
+	/// For each node (1 to 2*count_-1), the index of the largest value below it.
+	QVector<int> maxIndexes_;
+	/// Number of values.
+	int count_;
+
+	/// Returns whichever of the value indexes \c a and \c b has the smaller value (NaN losing, and the lower index winning ties).
+	int pickMinimum(int a, int b) const;
+	/// Returns whichever of the value indexes \c a and \c b has the larger value (NaN losing, and the lower index winning ties).
+	int pickMaximum(int a, int b) const;
+	/// Recomputes internal node \c node from its two children.
+	void updateNode(int node) {
+		minIndexes_[node] = pickMinimum(minIndexes_.at(2*node), minIndexes_.at(2*node+1));
+		maxIndexes_[node] = pickMaximum(maxIndexes_.at(2*node), maxIndexes_.at(2*node+1));
+	}
+};
+
+#endif // MPLOTEXTENTSINDEX_H
@@ -0,0 +1,178 @@
+#ifndef MPLOTFFT_CPP
+#define MPLOTFFT_CPP
+
+#include "MPlot/MPlotFFT.h"
+
+#include <math.h>
+
+MPlotFFT::MPlotFFT(int size)
+{
+	size_ = 0;
+	setSize(size);
+}
+
+void MPlotFFT::setSize(int size)
+{
+	size = qMax(1, size);
+	if(size == size_)
+		return;
+
+	size_ = size;
+	factorize(size_, factors_);
+	makeTwiddles(size_, twiddles_);
+
+	halfFactors_.clear();
+	halfTwiddles_.clear();
+	realTwiddles_.clear();
+	if(size_ % 2 == 0) {
+		factorize(size_/2, halfFactors_);
+		makeTwiddles(size_/2, halfTwiddles_);
+		makeTwiddles(size_, realTwiddles_);
+		realTwiddles_.resize(size_/2+1);
+	}
+
+	packed_.resize(size_);
+	packedOutput_.resize(size_);
+}
+
+void MPlotFFT::transform(const Complex *input, Complex *output)
+{
+	work(output, input, 1, 0, factors_, twiddles_);
+}
+
+void MPlotFFT::transformReal(const qreal *input, Complex *output)
+{
+	if(size_ % 2 != 0) {
+		for(int i=0; i<size_; ++i)
+			packed_[i] = Complex(input[i], 0);
+		work(packedOutput_.data(), packed_.constData(), 1, 0, factors_, twiddles_);
+		for(int k=0, bins=size_/2+1; k<bins; ++k)
+			output[k] = packedOutput_.at(k);
+		return;
+	}
+
+	// the even values as the real parts and the odd values as the imaginary parts: one transform of half the size gives the transforms of both.
+	int half = size_/2;
+	for(int i=0; i<half; ++i)
+		packed_[i] = Complex(input[2*i], input[2*i+1]);
+	work(packedOutput_.data(), packed_.constData(), 1, 0, halfFactors_, halfTwiddles_);
+
+	const Complex* z = packedOutput_.constData();
+	for(int k=0; k<=half; ++k) {
+		Complex a = z[k % half];
+		Complex b = std::conj(z[(half-k) % half]);
+		Complex even = (a + b)*qreal(0.5);
+		Complex odd = (a - b)*Complex(0, -0.5);
+		output[k] = even + realTwiddles_.at(k)*odd;
+	}
+}
+
+void MPlotFFT::work(Complex *output, const Complex *input, int twiddleStride, int factor, const QVector<int> &factors, const QVector<Complex> &twiddles)
+{
+	int radix = factors.at(factor);
+	int length = factors.at(factor+1);
+
+	if(length == 1) {
+		for(int j=0; j<radix; ++j)
+			output[j] = input[j*twiddleStride];
+	}
+	else {
+		for(int j=0; j<radix; ++j)
+			work(output + j*length, input + j*twiddleStride, twiddleStride*radix, factor+2, factors, twiddles);
+	}
+
+	butterfly(output, radix, length, twiddleStride, twiddles);
+}
+
+void MPlotFFT::butterfly(Complex *output, int radix, int length, int twiddleStride, const QVector<Complex> &twiddles)
+{
+	const Complex* w = twiddles.constData();
+
+	if(radix == 2) {
+		for(int u=0; u<length; ++u) {
+			Complex t = output[u+length]*w[u*twiddleStride];
+			output[u+length] = output[u] - t;
+			output[u] += t;
+		}
+		return;
+	}
+
+	if(radix == 4) {
+		for(int u=0; u<length; ++u) {
+			Complex s0 = output[u+length]*w[u*twiddleStride];
+			Complex s1 = output[u+2*length]*w[2*u*twiddleStride];
+			Complex s2 = output[u+3*length]*w[3*u*twiddleStride];
+			Complex s5 = output[u] - s1;
+			Complex s3 = s0 + s2;
+			Complex s4 = s0 - s2;
+			Complex s6 = output[u] + s1;
+
+			// (-i times s4, for the forward transform.)
+			Complex s4i(s4.imag(), -s4.real());
+			output[u] = s6 + s3;
+			output[u+2*length] = s6 - s3;
+			output[u+length] = s5 + s4i;
+			output[u+3*length] = s5 - s4i;
+		}
+		return;
+	}
+
+	// any other radix: the direct DFT of each group, O(radix^2) per group.
+	int size = twiddles.size();
+	scratch_.resize(radix);
+	Complex* scratch = scratch_.data();
+	for(int u=0; u<length; ++u) {
+		for(int q=0; q<radix; ++q)
+			scratch[q] = output[u+q*length];
+
+		for(int q1=0; q1<radix; ++q1) {
+			int k = u+q1*length;
+			Complex sum = scratch[0];
+			int twiddle = 0;
+			for(int q=1; q<radix; ++q) {
+				twiddle += twiddleStride*k;
+				if(twiddle >= size)
+					twiddle -= size;
+				sum += scratch[q]*w[twiddle];
+			}
+			output[k] = sum;
+		}
+	}
+}
+
+void MPlotFFT::factorize(int size, QVector<int> &factors)
+{
+	factors.clear();
+	if(size == 1) {
+		factors << 1 << 1;
+		return;
+	}
+
+	int radix = 4;
+	double root = floor(sqrt(double(size)));
+	while(size > 1) {
+		while(size % radix) {
+			if(radix == 4)
+				radix = 2;
+			else if(radix == 2)
+				radix = 3;
+			else
+				radix += 2;
+			if(radix > root)
+				radix = size;
+		}
+		size /= radix;
+		factors << radix << size;
+	}
+}
+
+void MPlotFFT::makeTwiddles(int size, QVector<Complex> &twiddles)
+{
+	const double pi = 3.14159265358979323846;
+
+	twiddles.resize(size);
+	for(int k=0; k<size; ++k)
+		twiddles[k] = std::polar(qreal(1), qreal(-2*pi*k/size));
+}
+
+#endif // MPLOTFFT_CPP
@@ -0,0 +1,58 @@
+#ifndef MPLOTFFT_H
+#define MPLOTFFT_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QVector>
+#include <complex>
+
+/// This class computes discrete Fourier transforms of a fixed size, with no external library.
+/*! The transform is a mixed-radix decimation-in-time FFT: the size is split into factors of 4, 2, 3, 5 and any other primes, with specialized butterflies for 2 and 4.  Sizes with large prime factors still work, but each prime factor p costs O(p) per value instead of O(log p).
+
+The twiddle factors and the factorization are computed once, in setSize(), and the work buffers are kept between transforms, so transforming many frames of the same size doesn't allocate.  An object can't be used by several threads at once.
+
+The forward transform is X[k] = sum over n of x[n] exp(-2 pi i k n / size()), unnormalized. */
+class MPLOTSHARED_EXPORT MPlotFFT {
+
+public:
+	/// Complex values.
+	typedef std::complex<qreal> Complex;
+
+	/// Constructor. Prepares transforms of \c size values.
+	explicit MPlotFFT(int size = 1);
+
+	/// Returns the number of values transformed.
+	int size() const { return size_; }
+	/// Prepares transforms of \c size values (at least 1).  Does nothing if it's the current size.
+	void setSize(int size);
+
+	/// Transforms size() complex values from \c input into \c output.  They must not overlap.
+	void transform(const Complex* input, Complex* output);
+	/// Transforms size() real values from \c input, and writes the size()/2+1 bins of the non-negative frequencies into \c output.  (The others are their complex conjugates.)  For even sizes, this is done with a complex transform of half the size.
+	void transformReal(const qreal* input, Complex* output);
+
+protected:
+	/// One step of the recursive transform: transforms the values \c twiddleStride apart starting at \c input into \c output, for \c factors from \c factor on.  \c twiddleStride is also the step through \c twiddles at this depth.
+	void work(Complex* output, const Complex* input, int twiddleStride, int factor, const QVector<int>& factors, const QVector<Complex>& twiddles);
+	/// Combines \c radix transforms of \c length values each, at \c output, into one.
+	void butterfly(Complex* output, int radix, int length, int twiddleStride, const QVector<Complex>& twiddles);
+	/// Splits \c size into radixes (4 first, then 2, 3, 5, ...), as pairs of radix and remaining length.
+	static void factorize(int size, QVector<int>& factors);
+	/// Fills \c twiddles with exp(-2 pi i k / \c size) for k < \c size.
+	static void makeTwiddles(int size, QVector<Complex>& twiddles);
+
+	/// Transform size.
+	int size_;
+	/// Factorization and twiddle factors for size_.
+	QVector<int> factors_;
+	QVector<Complex> twiddles_;
+
+	/// For transformReal() with an even size: the half-size transform, and exp(-2 pi i k / size_) for k <= size_/2.
+	QVector<int> halfFactors_;
+	QVector<Complex> halfTwiddles_, realTwiddles_;
+
+	/// Work buffers, kept between transforms.
+	QVector<Complex> scratch_, packed_, packedOutput_;
+};
+
+#endif // MPLOTFFT_H
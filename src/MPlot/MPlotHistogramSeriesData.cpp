@@ -0,0 +1,342 @@
+#ifndef MPLOTHISTOGRAMSERIESDATA_CPP
+#define MPLOTHISTOGRAMSERIESDATA_CPP
+
+#include "MPlot/MPlotHistogramSeriesData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <QDebug>
+
+#include <string.h>
+#include <math.h>
+#include <limits>
+
+MPlotHistogramSeriesData::MPlotHistogramSeriesData(const MPlotAbstractSeriesData *source, qreal binWidth)
+	: MPlotAbstractDerivedSeriesData(source)
+{
+	binning_ = ExpandingBins;
+	origin_ = 0;
+	originBin_ = 0;
+	binWidth_ = binWidth > 0 ? binWidth : 1.0;
+	maxBins_ = MPLOT_HISTOGRAM_MAX_BINS;
+	underflow_ = overflow_ = 0;
+	head_ = 0;
+	changedFirst_ = std::numeric_limits<int>::max();
+	changedLast_ = -1;
+	binsAdded_ = false;
+
+	if(source_ && source_->count() > 0) {
+		values_.resize(source_->count());
+		readSourceValues(0, source_->count()-1, 0);
+	}
+	rebin();
+}
+
+MPlotHistogramSeriesData::MPlotHistogramSeriesData(const MPlotAbstractSeriesData *source, qreal minimum, qreal maximum, int binCount)
+	: MPlotAbstractDerivedSeriesData(source)
+{
+	binning_ = FixedBins;
+	binCount = qMax(1, binCount);
+	origin_ = qMin(minimum, maximum);
+	originBin_ = 0;
+	binWidth_ = qAbs(maximum-minimum)/binCount;
+	if(!(binWidth_ > 0))
+		binWidth_ = 1.0;
+	maxBins_ = binCount;
+	underflow_ = overflow_ = 0;
+	head_ = 0;
+	changedFirst_ = std::numeric_limits<int>::max();
+	changedLast_ = -1;
+	binsAdded_ = false;
+
+	if(source_ && source_->count() > 0) {
+		values_.resize(source_->count());
+		readSourceValues(0, source_->count()-1, 0);
+	}
+	rebin();
+}
+
+void MPlotHistogramSeriesData::setFixedBins(qreal minimum, qreal maximum, int binCount)
+{
+	binning_ = FixedBins;
+	binCount = qMax(1, binCount);
+	origin_ = qMin(minimum, maximum);
+	binWidth_ = qAbs(maximum-minimum)/binCount;
+	if(!(binWidth_ > 0))
+		binWidth_ = 1.0;
+	maxBins_ = binCount;
+
+	rebin();
+	emitDataReset();
+}
+
+void MPlotHistogramSeriesData::setExpandingBins(qreal binWidth, int maxBins)
+{
+	binning_ = ExpandingBins;
+	binWidth_ = binWidth > 0 ? binWidth : 1.0;
+	maxBins_ = qMax(2, maxBins);
+
+	rebin();
+	emitDataReset();
+}
+
+void MPlotHistogramSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	for(unsigned i=indexStart; i<=indexEnd; ++i)
+		*(outputValues++) = origin_ + (i+0.5)*binWidth_;
+}
+
+void MPlotHistogramSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, counts_.constData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+QRectF MPlotHistogramSeriesData::boundingRect() const
+{
+	int count = counts_.size();
+	if(count == 0)
+		return QRectF();
+
+	// there are far fewer bins than values: looking through them is cheap.
+	if(cachedDataRectUpdateRequired_) {
+		qreal maxCount = 0;
+		for(int i=0; i<count; ++i)
+			maxCount = qMax(maxCount, counts_.at(i));
+
+		cachedDataRect_ = QRectF(origin_,
+								 0,
+								 count*binWidth_,
+								 qMax(maxCount, std::numeric_limits<qreal>::min()));
+		cachedDataRectUpdateRequired_ = false;
+	}
+
+	return cachedDataRect_;
+}
+
+void MPlotHistogramSeriesData::sourceRowsAppended(int first, int last)
+{
+	// out of step with the source?
+	if(first != values_.size()-head_) {
+		sourceReset();
+		return;
+	}
+
+	values_.resize(head_ + last+1);
+	readSourceValues(first, last, head_+first);
+
+	for(int i=head_+first, end=head_+last; i<=end; ++i)
+		addValue(values_.at(i));
+
+	emitBinChanges();
+}
+
+void MPlotHistogramSeriesData::sourceRowsRemovedFront(int count)
+{
+	count = qMin(count, values_.size()-head_);
+	if(count < 1)
+		return;
+
+	for(int i=head_, end=head_+count; i<end; ++i)
+		removeValue(values_.at(i));
+	head_ += count;
+
+	if(MPlotFrontCompactionDue(head_, values_.size())) {
+		MPlotRemoveFront(values_, head_);
+		head_ = 0;
+	}
+
+	emitBinChanges();
+}
+
+void MPlotHistogramSeriesData::sourceValuesChanged(int first, int last)
+{
+	last = qMin(last, values_.size()-head_-1);
+	if(first < 0 || first > last) {
+		sourceReset();
+		return;
+	}
+
+	for(int i=head_+first, end=head_+last; i<=end; ++i)
+		removeValue(values_.at(i));
+
+	readSourceValues(first, last, head_+first);
+
+	for(int i=head_+first, end=head_+last; i<=end; ++i)
+		addValue(values_.at(i));
+
+	emitBinChanges();
+}
+
+void MPlotHistogramSeriesData::sourceReset()
+{
+	values_.clear();
+	head_ = 0;
+	if(source_ && source_->count() > 0) {
+		values_.resize(source_->count());
+		readSourceValues(0, source_->count()-1, 0);
+	}
+
+	rebin();
+	MPlotAbstractDerivedSeriesData::sourceReset();
+}
+
+void MPlotHistogramSeriesData::addValue(qreal value)
+{
+	// NaN and infinities don't go anywhere.
+	if(!(qAbs(value) <= std::numeric_limits<qreal>::max()))
+		return;
+
+	qint64 bin;
+	if(binning_ == FixedBins) {
+		bin = binOf(value);
+		int binCount = counts_.size();
+		if(value == origin_ + binCount*binWidth_)	// the top edge belongs to the last bin.
+			bin = binCount-1;
+		if(bin < 0) {
+			++underflow_;
+			return;
+		}
+		if(bin >= binCount) {
+			++overflow_;
+			return;
+		}
+	}
+	else
+		bin = expandTo(value);
+
+	int index = int(bin);
+	counts_[index] += 1;
+	changedFirst_ = qMin(changedFirst_, index);
+	changedLast_ = qMax(changedLast_, index);
+}
+
+void MPlotHistogramSeriesData::removeValue(qreal value)
+{
+	if(!(qAbs(value) <= std::numeric_limits<qreal>::max()))
+		return;
+
+	qint64 bin = binOf(value);
+	int binCount = counts_.size();
+
+	if(binning_ == FixedBins) {
+		if(value == origin_ + binCount*binWidth_)
+			bin = binCount-1;
+		if(bin < 0) {
+			--underflow_;
+			return;
+		}
+		if(bin >= binCount) {
+			--overflow_;
+			return;
+		}
+	}
+	// (expanding bins are never removed, so the value's bin is still there.)
+	else if(bin < 0 || bin >= binCount) {
+		qWarning() << "MPlotHistogramSeriesData: Removing a value that wasn't binned.";
+		return;
+	}
+
+	int index = int(bin);
+	counts_[index] -= 1;
+	changedFirst_ = qMin(changedFirst_, index);
+	changedLast_ = qMax(changedLast_, index);
+}
+
+qint64 MPlotHistogramSeriesData::binOf(qreal value) const
+{
+	// clamped well inside qint64, so that values far away from the bins are still outside them.
+	qreal bin = binning_ == FixedBins ? floor((value - origin_)/binWidth_) : floor(value/binWidth_) - originBin_;
+	const qreal limit = qreal(Q_INT64_C(1) << 60);
+	return qint64(qBound(-limit, bin, limit));
+}
+
+int MPlotHistogramSeriesData::expandTo(qreal value)
+{
+	// the first value decides where the bins are.
+	if(counts_.isEmpty()) {
+		originBin_ = 0;
+		originBin_ = binOf(value);
+		origin_ = originBin_*binWidth_;
+		counts_.resize(1);
+		binsAdded_ = true;
+	}
+
+	for(;;) {
+		qint64 bin = binOf(value);
+		qint64 binCount = counts_.size();
+		if(bin >= 0 && bin < binCount)
+			return int(bin);
+
+		qint64 low = qMin(bin, qint64(0));
+		qint64 high = qMax(bin, binCount-1);
+
+		if(high-low+1 <= maxBins_) {
+			// new empty bins at either end.
+			if(low < 0)
+				counts_.insert(0, int(-low), 0);
+			if(high-low+1 > counts_.size())
+				counts_.resize(int(high-low+1));
+			originBin_ += low;
+			origin_ = originBin_*binWidth_;
+			binsAdded_ = true;
+			return int(bin-low);
+		}
+
+		// too many: merge the bins in pairs, starting on an even bin of the grid so that the merged bins are on the grid of the new width.
+		if(originBin_ % 2 != 0) {
+			counts_.prepend(0);
+			--originBin_;
+		}
+		if(counts_.size() % 2 != 0)
+			counts_.append(0);
+
+		int merged = counts_.size()/2;
+		for(int i=0; i<merged; ++i)
+			counts_[i] = counts_.at(2*i) + counts_.at(2*i+1);
+		counts_.resize(merged);
+
+		// (originBin_ is even, so this is exact.)
+		originBin_ /= 2;
+		binWidth_ *= 2;
+		origin_ = originBin_*binWidth_;
+		binsAdded_ = true;
+	}
+}
+
+void MPlotHistogramSeriesData::rebin()
+{
+	counts_.clear();
+	if(binning_ == FixedBins)
+		counts_.resize(maxBins_);
+	underflow_ = overflow_ = 0;
+
+	for(int i=head_, size=values_.size(); i<size; ++i)
+		addValue(values_.at(i));
+
+	// the caller announces it.
+	changedFirst_ = std::numeric_limits<int>::max();
+	changedLast_ = -1;
+	binsAdded_ = false;
+	cachedDataRectUpdateRequired_ = true;
+}
+
+void MPlotHistogramSeriesData::readSourceValues(int first, int last, int at)
+{
+	for(int start = first; start <= last; start += MPLOT_MINMAX_CHUNK) {
+		int end = qMin(last, start+MPLOT_MINMAX_CHUNK-1);
+		source_->yValues(start, end, values_.data() + at + (start-first));
+	}
+}
+
+void MPlotHistogramSeriesData::emitBinChanges()
+{
+	if(binsAdded_)
+		emitDataReset();
+	else if(changedFirst_ <= changedLast_)
+		emitValuesChanged(changedFirst_, changedLast_);
+
+	changedFirst_ = std::numeric_limits<int>::max();
+	changedLast_ = -1;
+	binsAdded_ = false;
+}
+
+#endif // MPLOTHISTOGRAMSERIESDATA_CPP
@@ -0,0 +1,115 @@
+#ifndef MPLOTHISTOGRAMSERIESDATA_H
+#define MPLOTHISTOGRAMSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotDerivedSeriesData.h"
+
+#include <QVector>
+
+/// The default maximum number of bins of an MPlotHistogramSeriesData with expanding bins.  When the values need more, the bins are merged in pairs.
+#define MPLOT_HISTOGRAM_MAX_BINS 4096
+
+/// This class is a histogram of its source's y values, kept up to date incrementally: appended points are binned, points removed from the front are un-binned, and changed points are moved to their new bin.  So an update costs O(points changed), not O(history).
+/*! The points of this data are the bins: x is the center of the bin, and y is the number of values in it.  Draw it with MPlotSeriesHistogram, which uses the exact bin edges (binLeft() and binRight()).
+
+The bins are either:
+- Fixed: \c binCount bins between \c minimum and \c maximum.  Values outside go to underflow() or overflow(), and aren't drawn.
+- Expanding: bins of a given width, added at either end as values arrive outside them.  If more than maxBins() would be needed, adjacent bins are merged in pairs (doubling the width) until they fit.  Bins are never removed, so the edges don't jump around as the history scrolls.
+
+NaN and infinite values are not counted.  To un-bin points after they are removed from the source, the histogram keeps its own copy of the values of the source's points.
+
+Changes to the counts are announced with valuesChanged() over the bins that changed; new bins, with dataReset(). */
+class MPLOTSHARED_EXPORT MPlotHistogramSeriesData : public MPlotAbstractDerivedSeriesData {
+
+public:
+	/// The ways to place the bins.
+	enum Binning { FixedBins, ExpandingBins };
+
+	/// Constructor. Histogram of \c source with expanding bins \c binWidth wide.
+	MPlotHistogramSeriesData(const MPlotAbstractSeriesData* source = 0, qreal binWidth = 1.0);
+	/// Constructor. Histogram of \c source with \c binCount fixed bins between \c minimum and \c maximum.
+	MPlotHistogramSeriesData(const MPlotAbstractSeriesData* source, qreal minimum, qreal maximum, int binCount);
+
+	/// Returns how the bins are placed.
+	Binning binning() const { return binning_; }
+	/// Uses \c binCount fixed bins between \c minimum and \c maximum.  All the values are binned again.
+	void setFixedBins(qreal minimum, qreal maximum, int binCount);
+	/// Uses expanding bins, starting \c binWidth wide, with at most \c maxBins bins.  All the values are binned again.
+	void setExpandingBins(qreal binWidth, int maxBins = MPLOT_HISTOGRAM_MAX_BINS);
+
+	/// Returns the width of the bins.
+	qreal binWidth() const { return binWidth_; }
+	/// Returns the maximum number of expanding bins.
+	int maxBins() const { return maxBins_; }
+	/// Returns the left edge of bin \c bin.
+	qreal binLeft(int bin) const { return origin_ + bin*binWidth_; }
+	/// Returns the right edge of bin \c bin.
+	qreal binRight(int bin) const { return origin_ + (bin+1)*binWidth_; }
+	/// Returns the number of values below the fixed bins.
+	qint64 underflow() const { return underflow_; }
+	/// Returns the number of values above the fixed bins.
+	qint64 overflow() const { return overflow_; }
+
+	/// Returns the center of bin \c index.
+	virtual qreal x(unsigned index) const { return origin_ + (index+0.5)*binWidth_; }
+	/// Copies the centers of bins \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of values in bin \c index.
+	virtual qreal y(unsigned index) const { return counts_.at(index); }
+	/// Copies the number of values in bins \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of bins.
+	virtual int count() const { return counts_.size(); }
+	/// Re-implemented to cover the bin edges, from 0 to the largest count.
+	virtual QRectF boundingRect() const;
+	/// Re-implemented to return true: reading the bins doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+protected:
+	/// Re-implemented to bin the new points.
+	virtual void sourceRowsAppended(int first, int last);
+	/// Re-implemented to un-bin the removed points.
+	virtual void sourceRowsRemovedFront(int count);
+	/// Re-implemented to move the changed points to their new bins.
+	virtual void sourceValuesChanged(int first, int last);
+	/// Re-implemented to bin all the points again.
+	virtual void sourceReset();
+
+	/// Adds \c value to its bin, adding bins first if needed.
+	void addValue(qreal value);
+	/// Removes \c value from its bin.
+	void removeValue(qreal value);
+	/// Returns the bin \c value falls in (outside [0, count()) if there isn't one yet).  Only call with finite values.
+	qint64 binOf(qreal value) const;
+	/// Adds expanding bins, or merges them, until there is one for \c value.  Returns its index.
+	int expandTo(qreal value);
+	/// Empties the bins, and bins all the values again.
+	void rebin();
+	/// Reads the y values of source points \c first to \c last into values_, starting at values_ index \c at.
+	void readSourceValues(int first, int last, int at);
+	/// Announces the changes to the bins since the last call.
+	void emitBinChanges();
+
+	/// Bin placement.
+	Binning binning_;
+	/// Left edge of bin 0, and width of the bins.
+	qreal origin_, binWidth_;
+	/// For expanding bins: bin 0 as a multiple of the width.  Binning on this grid (not on origin_) puts a value in the same bin when it is removed as when it was added, whatever bins were added in between.
+	qint64 originBin_;
+	/// Maximum number of expanding bins.
+	int maxBins_;
+	/// Number of values in each bin.
+	QVector<qreal> counts_;
+	/// Values outside the fixed bins.
+	qint64 underflow_, overflow_;
+
+	/// The values of the source's points, starting at head_, so that they can be un-binned.
+	QVector<qreal> values_;
+	int head_;
+
+	/// Bins whose counts changed since the last emitBinChanges() (empty if changedFirst_ > changedLast_), and whether bins were added.
+	int changedFirst_, changedLast_;
+	bool binsAdded_;
+};
+
+#endif // MPLOTHISTOGRAMSERIESDATA_H
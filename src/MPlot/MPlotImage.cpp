@@ -17,6 +17,10 @@ void MPlotImageSignalHandler::onDataChanged() {
 	image_->onDataChangedPrivate();
 }
 
+void MPlotImageSignalHandler::onRowsScrolled(int count) {
+	image_->onRowsScrolled(count);
+}
+
 MPlotAbstractImage::MPlotAbstractImage()
 	: MPlotItem()
 {
@@ -85,6 +89,7 @@ void MPlotAbstractImage::setModel(const MPlotAbstractImageData* data, bool ownsM
 	if(data_) {
 		QObject::connect(data_->signalSource(), SIGNAL(dataChanged()), signalHandler_, SLOT(onDataChanged()));
 		QObject::connect(data_->signalSource(), SIGNAL(boundsChanged()), signalHandler_, SLOT(onBoundsChanged()));
+		QObject::connect(data_->signalSource(), SIGNAL(rowsScrolled(int)), signalHandler_, SLOT(onRowsScrolled(int)));
 	}
 
 	clearRange();
@@ -214,12 +219,26 @@ void MPlotAbstractImage::setDefaults() {
 // Constructor
 MPlotImageBasic::MPlotImageBasic(const MPlotAbstractImageData* data)
 	: MPlotAbstractImage(),
-	  image_(1,1, QImage::Format_ARGB32)
+	  image_(1,1, QImage::Format_ARGB32),
+	  viewportCache_(65536)
 {
 	imageRefillRequired_ = true;
+	colorMapRangeUpdateRequired_ = true;
+	colorLookupTableUpdateRequired_ = true;
+	downsamplingMode_ = MPlotAbstractImageData::ReduceMean;
 	setModel(data);
 }
 
+void MPlotImageBasic::setDownsamplingMode(MPlotAbstractImageData::ReductionMode mode)
+{
+	if(downsamplingMode_ == mode)
+		return;
+
+	downsamplingMode_ = mode;
+	viewportCache_.clear();
+	update();
+}
+
 // Paint: must be implemented in subclass.
 void MPlotImageBasic::paint(QPainter* painter,
 							const QStyleOptionGraphicsItem* option,
@@ -235,29 +254,170 @@ void MPlotImageBasic::paint(QPainter* painter,
 
 	if(data_) {
 
-		if(imageRefillRequired_)
-			fillImageFromData();
+		QSize dataSize = data_->size();
+		if(dataSize.width() < 1 || dataSize.height() < 1)
+			return;
 
 		// the MPlotItem implementation of boundingRect() takes our dataRect() and maps it to drawing coordinates... This is where we need to draw into.
 		QRectF destinationRect = MPlotItem::boundingRect();
-		painter->drawImage(destinationRect, image_, QRectF(QPointF(0,0), QSizeF(data_->size())));
-
-		if(selected()) {
-			QColor selectionColor(MPLOT_SELECTION_COLOR);
-			QPen selectionPen(selectionColor, MPLOT_SELECTION_LINEWIDTH);
-			painter->setPen(selectionPen);
-			selectionColor.setAlphaF(MPLOT_SELECTION_OPACITY);
-			painter->setBrush(selectionColor);
-			painter->drawRect(destinationRect);
+		if(!destinationRect.isValid())
+			return;
+
+		// Which part of the image is actually visible in the plot area?
+		QRectF visibleRect = destinationRect.intersected(QRectF(0, 0, xAxisTarget()->drawingSize().width(), yAxisTarget()->drawingSize().height()));
+
+		if(visibleRect.isValid()) {
+
+			// Visible range of image columns and rows. (Image row 0 is at the top, and holds the last data row.)
+			qreal columnsPerUnit = dataSize.width()/destinationRect.width();
+			qreal rowsPerUnit = dataSize.height()/destinationRect.height();
+			int firstColumn = qBound(0, int(floor((visibleRect.left()-destinationRect.left())*columnsPerUnit)), dataSize.width()-1);
+			int lastColumn = qBound(firstColumn, int(ceil((visibleRect.right()-destinationRect.left())*columnsPerUnit))-1, dataSize.width()-1);
+			int firstRow = qBound(0, int(floor((visibleRect.top()-destinationRect.top())*rowsPerUnit)), dataSize.height()-1);
+			int lastRow = qBound(firstRow, int(ceil((visibleRect.bottom()-destinationRect.top())*rowsPerUnit))-1, dataSize.height()-1);
+
+			int visibleColumns = lastColumn-firstColumn+1;
+			int visibleRows = lastRow-firstRow+1;
+
+			// Where those columns and rows get drawn:
+			QRectF targetRect(destinationRect.left() + firstColumn/columnsPerUnit,
+							  destinationRect.top() + firstRow/rowsPerUnit,
+							  visibleColumns/columnsPerUnit,
+							  visibleRows/rowsPerUnit);
+
+			// Match the resolution to the device pixels we're covering, but never go above the data resolution; QPainter can scale up.
+			QTransform wt = painter->deviceTransform();
+			QSize resolution(qBound(1, int(ceil(targetRect.width()*fabs(wt.m11()))), visibleColumns),
+							 qBound(1, int(ceil(targetRect.height()*fabs(wt.m22()))), visibleRows));
+
+			if(visibleColumns == dataSize.width() && visibleRows == dataSize.height() && resolution == dataSize) {
+				// Everything visible, at full resolution: use the cached full image.
+				if(imageRefillRequired_)
+					fillImageFromData();
+
+				painter->drawImage(targetRect, image_, QRectF(QPointF(0,0), QSizeF(dataSize)));
+			}
+			else {
+				// Zoomed in or out: only render what's visible, at the resolution we need. The index rectangle is expressed in data indexes, so we flip the rows.
+				QRect indexRect(firstColumn, dataSize.height()-1-lastRow, visibleColumns, visibleRows);
+				const QImage* viewport = viewportImage(indexRect, resolution);
+
+				if(viewport)
+					painter->drawImage(targetRect, *viewport, QRectF(QPointF(0,0), QSizeF(resolution)));
+			}
 		}
+
+		paintSelection(painter, destinationRect);
 	}
 
 	/// \todo selection border
 }
 
-void MPlotImageBasic::repaintRequired()
+void MPlotImageBasic::paintSelection(QPainter *painter, const QRectF &rect)
+{
+	if(selected()) {
+		QColor selectionColor(MPLOT_SELECTION_COLOR);
+		QPen selectionPen(selectionColor, MPLOT_SELECTION_LINEWIDTH);
+		painter->setPen(selectionPen);
+		selectionColor.setAlphaF(MPLOT_SELECTION_OPACITY);
+		painter->setBrush(selectionColor);
+		painter->drawRect(rect);
+	}
+}
+
+// Converts one scanline of raw integer values into colors, through a lookup table.
+static inline void lookupScanline(const quint16* values, int count, const QRgb* table, QRgb* output)
+{
+	for(int i=0; i<count; ++i)
+		output[i] = table[values[i]];
+}
+
+const QImage* MPlotImageBasic::viewportImage(const QRect &indexRect, const QSize &resolution)
+{
+	MPlotImageViewportKey key(indexRect, resolution);
+
+	QImage* image = viewportCache_.object(key);
+	if(image)
+		return image;
+
+	int width = resolution.width();
+	int height = resolution.height();
+	int integerDepth = data_->integerDepth();
+	image = new QImage(resolution, QImage::Format_ARGB32);
+
+	// note the inversion here: data row yy goes into image scanline (height-1-yy), because we'll be painting in graphics drawing coordinates.
+	if(resolution == indexRect.size() && (integerDepth == 8 || integerDepth == 16)) {
+		// raw integers at full resolution: colorize by table lookup.
+		QVector<quint16> rawBuffer(width*height);
+		data_->integerValuesByScanline(indexRect.left(), indexRect.top(), indexRect.right(), indexRect.bottom(), rawBuffer.data());
+
+		const QRgb* table = colorLookupTable(integerDepth);
+		for(int yy=0; yy<height; ++yy)
+			lookupScanline(rawBuffer.constData()+yy*width, width, table, (QRgb*)image->scanLine(height-1-yy));
+	}
+	else {
+		QVector<qreal> dataBuffer(width*height);
+
+		if(resolution == indexRect.size())
+			data_->zValuesByScanline(indexRect.left(), indexRect.top(), indexRect.right(), indexRect.bottom(), dataBuffer.data());
+		else
+			data_->zValuesReduced(indexRect.left(), indexRect.top(), indexRect.right(), indexRect.bottom(), width, height, downsamplingMode_, dataBuffer.data());
+
+		MPlotInterval range = currentColorMapRange();
+		for(int yy=0; yy<height; ++yy)
+			colorizeScanline(dataBuffer.constData()+yy*width, width, range, (QRgb*)image->scanLine(height-1-yy));
+	}
+
+	// cost in kilobytes.  If it's too big to fit in the cache at all, QCache deletes it right away, so we hang onto a copy for this paint.
+	int cost = qMax(1, width*height*int(sizeof(QRgb))/1024);
+	if(cost > viewportCache_.maxCost()) {
+		lastOversizeViewport_ = *image;
+		delete image;
+		return &lastOversizeViewport_;
+	}
+
+	viewportCache_.insert(key, image, cost);
+	return image;
+}
+
+void MPlotImageBasic::invalidateImageCaches()
 {
 	imageRefillRequired_ = true;
+	colorMapRangeUpdateRequired_ = true;
+	colorLookupTableUpdateRequired_ = true;
+	viewportCache_.clear();
+}
+
+MPlotInterval MPlotImageBasic::currentColorMapRange()
+{
+	if(colorMapRangeUpdateRequired_) {
+		cachedColorMapRange_ = colorMapRange();
+		colorMapRangeUpdateRequired_ = false;
+	}
+
+	return cachedColorMapRange_;
+}
+
+const QRgb * MPlotImageBasic::colorLookupTable(int integerDepth)
+{
+	int entries = 1 << integerDepth;
+
+	if(colorLookupTableUpdateRequired_ || colorLookupTable_.size() != entries) {
+		QVector<qreal> values(entries);
+		for(int i=0; i<entries; ++i)
+			values[i] = i;
+
+		colorLookupTable_.resize(entries);
+		colorizeScanline(values.constData(), entries, currentColorMapRange(), colorLookupTable_.data());
+		colorLookupTableUpdateRequired_ = false;
+	}
+
+	return colorLookupTable_.constData();
+}
+
+void MPlotImageBasic::repaintRequired()
+{
+	invalidateImageCaches();
 	update();
 }
 
@@ -285,22 +445,16 @@ QRectF MPlotImageBasic::boundingRect() const {
 void MPlotImageBasic::onDataChanged() {
 
 	// flag the image as dirty; this avoids the expensive act of re-filling the image every time the data changes, if we're not re-drawing as fast as the data is changing.
-	imageRefillRequired_ = true;
+	invalidateImageCaches();
 
 	// schedule a draw update
 	update();
 
 }
-#include <QTime>
-
 void MPlotImageBasic::fillImageFromData() {
 
 	if(data_) {
 
-//		QTime runTime;
-//		runTime.start();
-//		qDebug() << "MPlotImageBasic: fillImageFromData()";
-
 		imageRefillRequired_ = false;
 
 		// resize if req'd:
@@ -308,83 +462,59 @@ void MPlotImageBasic::fillImageFromData() {
 
 		if(image_.size() != dataSize)
 			image_ = QImage(dataSize, QImage::Format_ARGB32);
-//		qDebug() << "   QImage resize time:" << runTime.restart();
 
 		int yHeight = dataSize.height();
 		int xWidth = dataSize.width();
 
-//		qDebug() << "   data source get height, width:" << runTime.restart();
-
 		if(xWidth > 0 && yHeight > 0) {
-			QVector<qreal> dataBuffer(xWidth*yHeight);
-//			qDebug() << "   vector creation time:" << runTime.restart();
-			data_->zValues(0, 0, xWidth-1, yHeight-1, dataBuffer.data());
-//			qDebug() << "   block data access time:" << runTime.restart();
-
-			qreal minZ, maxZ;
-
-			if (manualMinimum() && manualMaximum()){
-
-				minZ = range().first;
-				maxZ = range().second;
-			}
-
-			else if (manualMinimum()){
-
-				minZ = range().first;
-				maxZ = dataBuffer.at(0);
 
-				foreach(qreal d, dataBuffer) {
-					if(d>maxZ) maxZ = d;
-				}
-			}
+			// Fetch the data by scanlines, in blocks of approximately 1MB (125000 doubles).  Each data row is colorized straight into its QImage scanline, so the image is written sequentially.
+			int rowsAtOnce = 125000 / xWidth;
+			if(rowsAtOnce == 0) rowsAtOnce = 1;
+			if(rowsAtOnce > yHeight) rowsAtOnce = yHeight;
 
-			else if (manualMaximum()){
+			int integerDepth = data_->integerDepth();
 
-				maxZ = range().second;
-				minZ = dataBuffer.at(0);
+			if(integerDepth == 8 || integerDepth == 16) {
+				// Raw 8- or 16-bit integers: no floating-point math at all. Each value indexes straight into the color table.
+				const QRgb* table = colorLookupTable(integerDepth);
+				QVector<quint16> rawBuffer(rowsAtOnce*xWidth);
 
-				foreach(qreal d, dataBuffer) {
+				for(int yrow=0; yrow<yHeight; yrow+=rowsAtOnce) {
+					int maxRow = qMin(yHeight-1, yrow+rowsAtOnce-1);
+					data_->integerValuesByScanline(0, yrow, xWidth-1, maxRow, rawBuffer.data());
 
-					if (d < minZ)
-						minZ = d;
+					for(int yy=yrow; yy<=maxRow; ++yy)
+						lookupScanline(rawBuffer.constData()+(yy-yrow)*xWidth, xWidth, table, (QRgb*)image_.scanLine(yHeight-1-yy));
 				}
 			}
-
 			else {
+				MPlotInterval range = currentColorMapRange();
+				QVector<qreal> dataBuffer(rowsAtOnce*xWidth);
 
-				minZ = maxZ = dataBuffer.at(0);
-				foreach(qreal d, dataBuffer) {
-					if(d<minZ) minZ = d;
-					if(d>maxZ) maxZ = d;
-				}
-			}
-
-			MPlotInterval range(minZ,maxZ);
-//			qDebug() << "   Manually search range:" << runTime.restart() << range;
-//			runTime.start();
-
-			QVector<QRgb> rgbs = QVector<QRgb>(dataBuffer.size());
-			map_.rgbValues(dataBuffer, range, rgbs.data());
-
-//			qDebug() << "   filling rgb data:" << runTime.restart();
+				for(int yrow=0; yrow<yHeight; yrow+=rowsAtOnce) {
+					int maxRow = qMin(yHeight-1, yrow+rowsAtOnce-1);
+					data_->zValuesByScanline(0, yrow, xWidth-1, maxRow, dataBuffer.data());
 
-			QRgb *image = (QRgb *)image_.bits();
-			int heightModifier = (yHeight-1)*xWidth;
-
-			for (int xx = 0; xx < xWidth; xx++){
-
-				int xc = xx*yHeight;
-
-				for (int yy = 0; yy < yHeight; yy++)
-					image[xx-yy*xWidth+heightModifier] = rgbs.at(xc+yy);
+					// note the inversion here: data row yy goes into image scanline (yHeight-1-yy). It's necessary because we'll be painting in graphics drawing coordinates.
+					for(int yy=yrow; yy<=maxRow; ++yy)
+						colorizeScanline(dataBuffer.constData()+(yy-yrow)*xWidth, xWidth, range, (QRgb*)image_.scanLine(yHeight-1-yy));
+				}
 			}
-
-//			qDebug() << "   setting pixels time:" << runTime.restart();
 		}
 	}
 }
 
+MPlotInterval MPlotImageBasic::colorMapRange() const
+{
+	return range();
+}
+
+void MPlotImageBasic::colorizeScanline(const qreal *values, int count, const MPlotInterval &range, QRgb *output) const
+{
+	map_.rgbValues(values, count, range, output);
+}
+
 
 
 // If the bounds of the data change (in x- and y-) this might require re-auto-scaling of a plot.
@@ -393,7 +523,8 @@ void MPlotImageBasic::onBoundsChanged(const QRectF& newBounds) {
 	// signal a re-scaling needed on the plot: (REDUNDANT... already done in base class)
 	// signalSource()->emitBoundsChanged();
 
-	// schedule an update of the plot, but computing a new pixmap is not needed
+	// schedule an update of the plot. Computing a new full image is not needed, but the drawing positions of the cached viewport renderings are no longer valid.
+	viewportCache_.clear();
 	update();
 }
 
@@ -407,105 +538,167 @@ MPlotImageBasicwDefault::MPlotImageBasicwDefault(const MPlotAbstractImageData *d
 	defaultValue_ = 0;
 }
 
-void MPlotImageBasicwDefault::fillImageFromData()
+MPlotInterval MPlotImageBasicwDefault::colorMapRange() const
 {
-	if(data_) {
+	if (manualMinimum() && manualMaximum())
+		return range();
 
-//		QTime runTime;
-//		runTime.start();
-//		qDebug() << "MPlotImageBasic: fillImageFromData()";
+	// Need a search through the data: the minimum must ignore default-valued and invalid points.  (Note: -1.0 here is from AMNUMBER_INVALID_FLOATINGPOINT)
+	QSize dataSize = data_->size();
+	int yHeight = dataSize.height();
+	int xWidth = dataSize.width();
 
-		imageRefillRequired_ = false;
+	int rowsAtOnce = 125000 / xWidth;
+	if(rowsAtOnce == 0) rowsAtOnce = 1;
+	if(rowsAtOnce > yHeight) rowsAtOnce = yHeight;
 
-		// resize if req'd:
-		QSize dataSize = data_->size();
+	QVector<qreal> dataBuffer(rowsAtOnce*xWidth);
+	bool minFound = false;
+	qreal minZ = 0, maxZ = data_->z(0,0);
 
-		if(image_.size() != dataSize)
-			image_ = QImage(dataSize, QImage::Format_ARGB32);
-//		qDebug() << "   QImage resize time:" << runTime.restart() << "ms" ;
+	for(int yrow=0; yrow<yHeight; yrow+=rowsAtOnce) {
+		int maxRow = qMin(yHeight-1, yrow+rowsAtOnce-1);
+		int blockSize = (maxRow-yrow+1)*xWidth;
+		data_->zValuesByScanline(0, yrow, xWidth-1, maxRow, dataBuffer.data());
 
-		int yHeight = dataSize.height();
-		int xWidth = dataSize.width();
+		for(int i=0; i<blockSize; ++i) {
+			qreal d = dataBuffer.at(i);
 
-//		qDebug() << "   data source get height, width:" << runTime.restart() << "ms" ;
+			if(d > maxZ)
+				maxZ = d;
 
-		if(xWidth > 0 && yHeight > 0) {
-			QVector<qreal> dataBuffer(xWidth*yHeight);
-//			qDebug() << "   vector creation time:" << runTime.restart() << "ms" ;
-			data_->zValues(0, 0, xWidth-1, yHeight-1, dataBuffer.data());
-//			qDebug() << "   block data access time:" << runTime.restart() << "ms" ;
+			if(d != defaultValue_ && d != -1.0 && (!minFound || d < minZ)) {
+				minZ = d;
+				minFound = true;
+			}
+		}
+	}
 
-			qreal minZ, maxZ;
+	if(!minFound)
+		minZ = maxZ;
 
-			if (manualMinimum() && manualMaximum()){
+	if (manualMinimum())
+		minZ = range().first;
 
-				minZ = range().first;
-				maxZ = range().second;
-			}
+	else if (manualMaximum())
+		maxZ = range().second;
 
-			else if (manualMinimum()){
+	return MPlotInterval(minZ, maxZ);
+}
 
-				minZ = range().first;
-				maxZ = dataBuffer.at(0);
+void MPlotImageBasicwDefault::colorizeScanline(const qreal *values, int count, const MPlotInterval &range, QRgb *output) const
+{
+	map_.rgbValues(values, count, range, output);
 
-				foreach(qreal d, dataBuffer) {
-					if(d>maxZ) maxZ = d;
-				}
-			}
+	QRgb defaultRgb = defaultColor_.rgb();
 
-			else if (manualMaximum()){
+	for (int i = 0; i < count; i++){
 
-				maxZ = range().second;
-				minZ = dataBuffer.at(0);
+		if (values[i] == defaultValue_ || values[i] == -1.0) // NOTE: -1.0 here is from AMNUMBER_INVALID_FLOATINGPOINT
+			output[i] = defaultRgb;
+	}
+}
 
-				foreach(qreal d, dataBuffer) {
+// MPlotScrollingImageBasic
+//////////////////////////////////////
 
-					if (d < minZ && d != defaultValue_ && d != -1.0)
-						minZ = d;
-				}
-			}
+MPlotScrollingImageBasic::MPlotScrollingImageBasic(const MPlotAbstractImageData *data)
+	: MPlotImageBasic(data)
+{
+	newestImageRow_ = 0;
+	pendingRows_ = 0;
+	scrollInProgress_ = false;
+	imageColorMapRange_ = MPlotInterval(0,0);
+}
 
-			else {
+void MPlotScrollingImageBasic::onRowsScrolled(int count)
+{
+	// no need to count past a full image's worth; at that point, the whole image gets refilled anyway.
+	pendingRows_ = qMin(pendingRows_ + count, data_ ? data_->size().height() : 0);
+	scrollInProgress_ = true;
+}
 
-				minZ = maxZ = dataBuffer.at(0);
-				foreach(qreal d, dataBuffer) {
-					if(d<minZ && d != defaultValue_ && d != -1.0) minZ = d;
-					if(d>maxZ) maxZ = d;
-				}
-			}
+void MPlotScrollingImageBasic::onDataChanged()
+{
+	if(!scrollInProgress_) {
+		MPlotImageBasic::onDataChanged();
+		return;
+	}
 
-			MPlotInterval range(minZ,maxZ);
-//			qDebug() << "   Manually search range:" << runTime.restart() << range;
-//			runTime.start();
+	// This dataChanged() is the one that follows rowsScrolled(): the rows already in the image are still good, as long as the color map range doesn't change. We'll find out at the next paint.
+	scrollInProgress_ = false;
+	colorMapRangeUpdateRequired_ = true;
+	colorLookupTableUpdateRequired_ = true;
+	viewportCache_.clear();
+	update();
+}
 
-			QVector<QRgb> rgbs = QVector<QRgb>(dataBuffer.size());
-			map_.rgbValues(dataBuffer, range, rgbs.data());
+void MPlotScrollingImageBasic::colorizeNewRows(int count)
+{
+	QSize dataSize = data_->size();
+	int xWidth = dataSize.width();
+	int yHeight = dataSize.height();
 
-//			qDebug() << "   filling rgb data:" << runTime.restart();
+	QVector<qreal> dataBuffer(count*xWidth);
+	data_->zValuesByScanline(0, yHeight-count, xWidth-1, yHeight-1, dataBuffer.data());
 
-			QRgb *image = (QRgb *)image_.bits();
-			int heightModifier = (yHeight-1)*xWidth;
-			QRgb defaultRgb = defaultColor_.rgb();
+	MPlotInterval range = currentColorMapRange();
 
-			for (int xx = 0; xx < xWidth; xx++){
+	// oldest of the new rows first: each one takes over the image row of the oldest row, which becomes the newest.
+	for(int r=0; r<count; ++r) {
+		newestImageRow_ = (newestImageRow_ - 1 + yHeight) % yHeight;
+		colorizeScanline(dataBuffer.constData()+r*xWidth, xWidth, range, (QRgb*)image_.scanLine(newestImageRow_));
+	}
+}
 
-				int xc = xx*yHeight;
+void MPlotScrollingImageBasic::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	Q_UNUSED(option)
+	Q_UNUSED(widget)
 
-				for (int yy = 0; yy < yHeight; yy++){
+	if(!yAxisTarget() || !xAxisTarget()) {
+		qWarning() << "MPlotScrollingImageBasic: No axis scale set. Abandoning painting because we don't know what scale to use.";
+		return;
+	}
 
-					double val = dataBuffer.at(xc+yy);
+	if(!data_)
+		return;
 
-					if (val != defaultValue_ && val != -1.0) // NOTE: -1.0 here is from AMNUMBER_INVALID_FLOATINGPOINT
-						image[xx-yy*xWidth+heightModifier] = rgbs.at(xc+yy);// note the inversion here. It's necessary because we'll be painting in graphics drawing coordinates.
+	QSize dataSize = data_->size();
+	if(dataSize.width() < 1 || dataSize.height() < 1)
+		return;
 
-					else
-						image[xx-yy*xWidth+heightModifier] = defaultRgb;// note the inversion here. It's necessary because we'll be painting in graphics drawing coordinates.
-				}
-			}
+	QRectF destinationRect = MPlotItem::boundingRect();
+	if(!destinationRect.isValid())
+		return;
 
-//			qDebug() << "   setting pixels time:" << runTime.restart();
-		}
+	// bring the image up to date: a full refill if the colors of the old rows are no longer right, otherwise just the new rows.
+	MPlotInterval range = currentColorMapRange();
+	if(imageRefillRequired_ || image_.size() != dataSize || range != imageColorMapRange_ || pendingRows_ >= dataSize.height()) {
+		fillImageFromData();	// the newest data row ends up in image row 0.
+		newestImageRow_ = 0;
+		imageColorMapRange_ = range;
 	}
+	else if(pendingRows_ > 0)
+		colorizeNewRows(pendingRows_);
+
+	pendingRows_ = 0;
+
+	// Two blits: image rows from newestImageRow_ to the bottom hold the newest data, and go at the top. Image rows above newestImageRow_ hold the oldest data, and go underneath.
+	int yHeight = dataSize.height();
+	int topRows = yHeight - newestImageRow_;
+	qreal rowHeight = destinationRect.height()/yHeight;
+
+	painter->drawImage(QRectF(destinationRect.left(), destinationRect.top(), destinationRect.width(), topRows*rowHeight),
+					   image_,
+					   QRectF(0, newestImageRow_, dataSize.width(), topRows));
+
+	if(newestImageRow_ > 0)
+		painter->drawImage(QRectF(destinationRect.left(), destinationRect.top() + topRows*rowHeight, destinationRect.width(), newestImageRow_*rowHeight),
+						   image_,
+						   QRectF(0, 0, dataSize.width(), newestImageRow_));
+
+	paintSelection(painter, destinationRect);
 }
 
 #endif // MPLOTIMAGE_H
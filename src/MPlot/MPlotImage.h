@@ -7,6 +7,8 @@
 #include "MPlot/MPlotColorMap.h"
 #include "MPlot/MPlotItem.h"
 
+#include <QCache>
+#include <QImage>
 
 class MPlotAbstractImage;
 
@@ -25,6 +27,8 @@ protected slots:
 	void onDataChanged();
 		/// Slot that handles updating the bounds of the image.
 	void onBoundsChanged();
+		/// Slot that handles the data scrolling by \c count rows.
+	void onRowsScrolled(int count);
 
 protected:
 		/// Pointer to the image this signal handler manages.
@@ -97,6 +101,8 @@ protected:
 	virtual void onDataChanged() = 0;
 	/// When the bounds change, this is called to allow whatever needs to happen for computing a new raster grid, etc.
 	virtual void onBoundsChanged(const QRectF& newBounds) = 0;
+	/// When the data scrolls by \c count rows (see MPlotImageDataSignalSource::rowsScrolled()), this is called just before onDataChanged().  The base class does nothing; re-implement to update only the new rows.
+	virtual void onRowsScrolled(int count) { Q_UNUSED(count) }
 	/// Virtual helper method to help notify that the image needs to be repainted.
 	virtual void repaintRequired() = 0;
 
@@ -128,13 +134,54 @@ private:
 };
 
 
+/// Identifies one viewport rendering of an image: the sub-rectangle of data indexes that was visible, and the resolution it was rendered at.  Used as the key for MPlotImageBasic's cache of viewport renderings.
+class MPlotImageViewportKey {
+public:
+	/// Constructor. \c indexRect is the visible range of data indexes, and \c resolution is the size of the rendered QImage.
+	MPlotImageViewportKey(const QRect& indexRect = QRect(), const QSize& resolution = QSize()) : indexRect_(indexRect), resolution_(resolution) {}
+
+	/// The visible range of data indexes.
+	QRect indexRect() const { return indexRect_; }
+	/// The size of the rendered QImage.
+	QSize resolution() const { return resolution_; }
+
+	/// Two keys are equal when both the index range and the resolution match.
+	bool operator==(const MPlotImageViewportKey& other) const { return indexRect_ == other.indexRect_ && resolution_ == other.resolution_; }
+
+protected:
+	/// The visible range of data indexes.
+	QRect indexRect_;
+	/// The size of the rendered QImage.
+	QSize resolution_;
+};
+
+/// Hash function, so that MPlotImageViewportKey can be used in a QCache.
+inline uint qHash(const MPlotImageViewportKey& key) {
+	QRect r = key.indexRect();
+	return uint(r.x()) ^ (uint(r.y()) << 8) ^ (uint(r.width()) << 16) ^ (uint(r.height()) << 24) ^ uint(key.resolution().width()*31 + key.resolution().height());
+}
+
 /// This class implements an image (2d intensity plot), using a cached, scaled QImage for drawing
+/*! When the whole image is visible and the plot has at least as many device pixels as the data has values, the full-resolution QImage is cached and re-used for every paint.
+
+When the plot is zoomed in (only part of the image is visible) or zoomed out (fewer device pixels than data values), only the visible sub-rectangle of the data is fetched and colorized, at a resolution matching the device pixels.  Data is downsampled with MPlotAbstractImageData::zValuesReduced(), using the downsamplingMode().  These viewport renderings are cached per zoom level (visible index range and resolution), up to viewportCacheLimit() kilobytes, until the data, the color map, or the range changes.
+*/
 class MPLOTSHARED_EXPORT MPlotImageBasic : public MPlotAbstractImage {
 
 public:
 	/// Constructor
 	MPlotImageBasic(const MPlotAbstractImageData* data = 0);
 
+	/// Returns how blocks of data values are combined when the image is drawn at a lower resolution than the data.
+	MPlotAbstractImageData::ReductionMode downsamplingMode() const { return downsamplingMode_; }
+	/// Sets how blocks of data values are combined when the image is drawn at a lower resolution than the data.  The default is MPlotAbstractImageData::ReduceMean.  Use ReduceMaximum to make sure isolated peaks stay visible when zoomed out.
+	void setDownsamplingMode(MPlotAbstractImageData::ReductionMode mode);
+
+	/// Returns the maximum memory used to cache viewport renderings, in kilobytes.
+	int viewportCacheLimit() const { return viewportCache_.maxCost(); }
+	/// Sets the maximum memory used to cache viewport renderings, in kilobytes.  The default is 65536 (64MB).
+	void setViewportCacheLimit(int kilobytes) { viewportCache_.setMaxCost(kilobytes); }
+
 		/// The paint function.  Paints the image.
 	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget);
 
@@ -159,8 +206,39 @@ protected:
 	/// indicates that the data has changed, and that the image_ cache is out of date. re-filling the image_ from the data is necessary before redrawing
 	bool imageRefillRequired_;
 
-	/// helper function to fill image_ based on the data
+	/// Cache of viewport renderings (partial and/or downsampled images), with costs in kilobytes.
+	QCache<MPlotImageViewportKey, QImage> viewportCache_;
+	/// Holds the last viewport rendering that was too big to fit in viewportCache_.
+	QImage lastOversizeViewport_;
+	/// How blocks of data values are combined when drawing at a lower resolution than the data.
+	MPlotAbstractImageData::ReductionMode downsamplingMode_;
+	/// The colorMapRange(), cached until the data or range changes.
+	MPlotInterval cachedColorMapRange_;
+	/// Indicates that cachedColorMapRange_ is out of date.
+	bool colorMapRangeUpdateRequired_;
+	/// For data with an integerDepth() of 8 or 16: the color of every possible raw value, over the current color map range.
+	QVector<QRgb> colorLookupTable_;
+	/// Indicates that colorLookupTable_ is out of date.
+	bool colorLookupTableUpdateRequired_;
+
+	/// Flags all cached renderings (the full image_, and the viewport cache) and the cached color map range as out of date.
+	void invalidateImageCaches();
+	/// Returns colorMapRange(), re-computing it only if the data or range changed since the last call.
+	MPlotInterval currentColorMapRange();
+	/// Returns the lookup table (2^\c integerDepth entries) that maps raw integer values to colors, re-building it only if the data or range changed since the last call.  The table is built by colorizeScanline(), so re-implementations of it are respected.
+	const QRgb* colorLookupTable(int integerDepth);
+	/// Returns the rendering of the data indexes in \c indexRect at \c resolution, from the viewport cache or newly computed.
+	const QImage* viewportImage(const QRect& indexRect, const QSize& resolution);
+	/// Draws the selection highlight over \c rect, if the image is selected.
+	void paintSelection(QPainter* painter, const QRectF& rect);
+
+	/// helper function to fill image_ based on the data.  The data is fetched in scanline order (MPlotAbstractImageData::zValuesByScanline()), in blocks of about 1MB, and each data row is colorized directly into its QImage scanline.  Data stored as 8- or 16-bit unsigned integers (see MPlotAbstractImageData::integerDepth()) is fetched raw and colorized through colorLookupTable() instead.
 	virtual void fillImageFromData();
+
+	/// Returns the z-range that is mapped onto the color map when filling the image. The base class implementation returns range().
+	virtual MPlotInterval colorMapRange() const;
+	/// Converts one scanline of \c count z-values into colors, writing them to \c output. The base class implementation uses the color map over \c range.
+	virtual void colorizeScanline(const qreal* values, int count, const MPlotInterval& range, QRgb* output) const;
 };
 
 /// This class is a simple extension to MPlotImageBasic where you can define a colour for pixels that are invalid (ie: not range.min <= z <= range.max).  The default is white, but can be customized.
@@ -189,8 +267,10 @@ public:
 	void setDefaultColor(QColor color) { defaultColor_ = color; onDataChanged(); }
 
 protected:
-	/// Reimplemented to utilize the default color.  Fills image_ based on the data.
-	virtual void fillImageFromData();
+	/// Re-implemented to leave default-valued (and invalid) data points out of the minimum when the range is automatic.
+	virtual MPlotInterval colorMapRange() const;
+	/// Re-implemented to utilize the default color for default-valued (and invalid) data points.
+	virtual void colorizeScanline(const qreal* values, int count, const MPlotInterval& range, QRgb* output) const;
 
 	/// The default color.
 	QColor defaultColor_;
@@ -198,4 +278,40 @@ protected:
 	qreal defaultValue_;
 };
 
+/// This class is an image for data that scrolls, such as a live spectrogram or waterfall plot (see MPlotScrollingImageData).
+/*! Instead of re-filling the whole image when rows are appended, it keeps its QImage as a circular buffer: only the new rows are colorized, into the slots of the rows that dropped off.  The image is drawn in two blits, one for each side of the wrap-around point.
+
+The whole image needs to be recolored whenever the color map range changes.  With an automatic range, this happens every time the data reaches a new minimum or maximum (or one expires); for the lowest cost per row, set a manual range with setMinimum() and setMaximum().
+
+It always draws the full image, scaled by QPainter, instead of rendering the visible region like MPlotImageBasic does.  Scrolling images are usually small enough that this is the faster choice.
+*/
+class MPLOTSHARED_EXPORT MPlotScrollingImageBasic : public MPlotImageBasic
+{
+
+public:
+	/// Constructor.
+	MPlotScrollingImageBasic(const MPlotAbstractImageData* data = 0);
+
+	/// The paint function. Colorizes any new rows, and paints the image in two parts.
+	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget);
+
+protected:
+	/// Re-implemented to remember how many rows have to be colorized at the next paint.
+	virtual void onRowsScrolled(int count);
+	/// Re-implemented to skip re-filling the whole image when the change was a scroll.
+	virtual void onDataChanged();
+
+	/// Image row where the newest data row is. The image is drawn from here to the bottom, and then from the top to just above here.
+	int newestImageRow_;
+	/// Number of rows appended since the image was last brought up to date.
+	int pendingRows_;
+	/// True between onRowsScrolled() and the onDataChanged() that follows it.
+	bool scrollInProgress_;
+	/// The color map range used when the rows in image_ were colorized.
+	MPlotInterval imageColorMapRange_;
+
+	/// Colorizes the newest \c count data rows into the image, moving newestImageRow_ back around the circle.
+	void colorizeNewRows(int count);
+};
+
 #endif // MPLOTIMAGE_H
@@ -2,6 +2,36 @@
 #define MPLOTIMAGEDATA_CPP
 
 #include "MPlot/MPlotImageData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <limits>
+
+MPlotImageSnapshot::MPlotImageSnapshot(const QVector<qreal> &values, const QSize &size, const QRectF &bounds, quint64 version)
+{
+	Data* d = new Data();
+	d->values = values;
+	d->count = QPoint(qMax(0, size.width()), qMax(0, size.height()));
+	d->boundingRect = bounds;
+	d->range = MPlotInterval(0,1);
+	d->version = version;
+
+	// every index inside count() must be readable: missing values are NaN (this copies the vector).
+	int valueCount = d->count.x()*d->count.y();
+	if(d->values.size() < valueCount) {
+		int given = d->values.size();
+		d->values.resize(valueCount);
+		for(int i=given; i<valueCount; ++i)
+			d->values[i] = std::numeric_limits<qreal>::quiet_NaN();
+	}
+
+	if(valueCount > 0) {
+		MPlotMinMax result;
+		result.add(d->values.constData(), valueCount);
+		d->range = MPlotInterval(result.minimum(), result.maximum());
+	}
+
+	d_ = QSharedPointer<const Data>(d);
+}
 
 MPlotImageDataSignalSource::MPlotImageDataSignalSource(MPlotAbstractImageData *parent)
 	: QObject(0) {
@@ -12,6 +42,7 @@ MPlotAbstractImageData::MPlotAbstractImageData()
 {
 	signalSource_ = new MPlotImageDataSignalSource(this);
 	minMaxCacheUpdateRequired_ = true;
+	dataVersion_ = 0;
 }
 
 MPlotAbstractImageData::~MPlotAbstractImageData()
@@ -20,6 +51,24 @@ MPlotAbstractImageData::~MPlotAbstractImageData()
 	signalSource_ = 0;
 }
 
+/// Provides the z values of an image to MPlotMinMax::search(), one column (constant x) per unit.
+class MPlotImageDataMinMaxSource : public MPlotMinMaxSource {
+public:
+	MPlotImageDataMinMaxSource(const MPlotAbstractImageData* data) : data_(data), size_(data->count()) {}
+
+	virtual qint64 units() const { return size_.x(); }
+	virtual int unitLength() const { return size_.y(); }
+	virtual void read(int channel, qint64 start, qint64 count, qreal* outputValues) const {
+		Q_UNUSED(channel)
+		data_->zValues(int(start), 0, int(start+count-1), size_.y()-1, outputValues);
+	}
+	virtual bool concurrentReadsSafe() const { return data_->concurrentReadsSafe(); }
+
+protected:
+	const MPlotAbstractImageData* data_;
+	QPoint size_;
+};
+
 void MPlotAbstractImageData::minMaxSearch() const {
 	QPoint c = count();
 	int sizeX = c.x();
@@ -28,54 +77,158 @@ void MPlotAbstractImageData::minMaxSearch() const {
 	if(sizeX == 0 || sizeY == 0)
 		return;
 
-	// performance optimization.  If total points is less than 500, just call z() repeatedly.  If total points is over that, usually faster to allocate a vector and use the block zValues().  However, to limit memory usage, don't allocate blocks over 1MB (125000 doubles).
-	if(sizeX*sizeY < 500) {
-		qreal minZ, maxZ, d;
-		minZ = maxZ = z(0,0);
-		for(int xx=0; xx<sizeX; ++xx)
-			for(int yy=0; yy<sizeY; ++yy) {
-				d = z(xx,yy);
-				if(d<minZ) minZ=d;
-				if(d>maxZ) maxZ=d;
+	// single fused pass, in blocks of columns that fit in cache (never a full copy of the data).
+	MPlotMinMax result;
+	MPlotImageDataMinMaxSource source(this);
+	MPlotMinMax::search(&source, &result);
+
+	minMaxCache_.first = result.minimum();
+	minMaxCache_.second = result.maximum();
+	minMaxCacheUpdateRequired_ = false;
+}
+
+// Edge length of the square tiles used by the cache-blocked transpose.  32x32 doubles (8kB) for the source and destination tiles together fit comfortably in L1 cache.
+#define MPLOT_TRANSPOSE_TILE 32
+
+// Transposes \c in (\c rows x \c cols, stored row after row) into \c out, where element (r,c) lands at out[c*outStride + r].  Working tile-by-tile keeps both the reads and the strided writes inside cache.
+static void transposeBlocked(const qreal* in, int rows, int cols, qreal* out, int outStride)
+{
+	for(int r0=0; r0<rows; r0+=MPLOT_TRANSPOSE_TILE) {
+		int r1 = qMin(rows, r0+MPLOT_TRANSPOSE_TILE);
+
+		for(int c0=0; c0<cols; c0+=MPLOT_TRANSPOSE_TILE) {
+			int c1 = qMin(cols, c0+MPLOT_TRANSPOSE_TILE);
+
+			for(int r=r0; r<r1; ++r) {
+				const qreal* src = in + r*cols;
+				qreal* dest = out + r;
+				for(int c=c0; c<c1; ++c)
+					dest[c*outStride] = src[c];
 			}
-		minMaxCache_.first = minZ;
-		minMaxCache_.second = maxZ;
-		minMaxCacheUpdateRequired_ = false;
-	}
-	else if(sizeX*sizeY < 125000) {	// less than 1MB buffer: do in one shot
-		QVector<qreal> dataBuffer(sizeX*sizeY);
-		zValues(0,0, sizeX-1, sizeY-1, dataBuffer.data());
-		qreal minZ, maxZ;
-		minZ = maxZ = dataBuffer.at(0);
-		foreach(qreal d, dataBuffer) {
-			if(d<minZ) minZ=d;
-			if(d>maxZ) maxZ=d;
 		}
-		minMaxCache_.first = minZ;
-		minMaxCache_.second = maxZ;
-		minMaxCacheUpdateRequired_ = false;
 	}
-	else {	// large array; don't want to allocate more than 1MB buffer. Do in sections of approximately 1MB.
-		int rowsAtOnce = 125000 / sizeY;
-		if(rowsAtOnce == 0) rowsAtOnce = 1;
-		qreal minZ, maxZ;
-		minZ = maxZ = z(0,0);
-		QVector<qreal> dataBuffer(rowsAtOnce*sizeY);
-
-		for(int xrow=0; xrow<sizeX; xrow+=rowsAtOnce) {
-			int maxRow = qMin(sizeX-1, xrow+rowsAtOnce-1);
-			dataBuffer.resize((maxRow-xrow+1)*sizeY);	// for all blocks except the last block, will do nothing. Resizing on the last (partial) block allows us to use foreach, which is faster than a for-loop over the space we know we have.
-			zValues(xrow, 0, maxRow, sizeY-1, dataBuffer.data());
-
-			foreach(qreal d, dataBuffer) {
-				if(d<minZ) minZ=d;
-				if(d>maxZ) maxZ=d;
+}
+
+void MPlotAbstractImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int sizeX = xEnd-xStart+1;
+	int sizeY = yEnd-yStart+1;
+
+	// fetch stripes of whole columns (x-major, as zValues() delivers them) of approximately 1MB (125000 doubles), and transpose each stripe into place.
+	int columnsAtOnce = 125000 / sizeY;
+	if(columnsAtOnce == 0) columnsAtOnce = 1;
+	if(columnsAtOnce > sizeX) columnsAtOnce = sizeX;
+
+	QVector<qreal> dataBuffer(columnsAtOnce*sizeY);
+
+	for(int xcol=xStart; xcol<=xEnd; xcol+=columnsAtOnce) {
+		int maxCol = qMin(xEnd, xcol+columnsAtOnce-1);
+		zValues(xcol, yStart, maxCol, yEnd, dataBuffer.data());
+		transposeBlocked(dataBuffer.constData(), maxCol-xcol+1, sizeY, outputValues+(xcol-xStart), sizeX);
+	}
+}
+
+void MPlotAbstractImageData::zValuesReduced(int xStart, int yStart, int xEnd, int yEnd, int outputWidth, int outputHeight, ReductionMode mode, qreal *outputValues) const
+{
+	int sizeX = xEnd-xStart+1;
+	int sizeY = yEnd-yStart+1;
+
+	QVector<qreal> dataBuffer;
+
+	for(int oy=0; oy<outputHeight; ++oy) {
+		// the band of source rows covered by this output row:
+		int rowStart = int(qint64(oy)*sizeY/outputHeight);
+		int rowEnd = int(qint64(oy+1)*sizeY/outputHeight)-1;
+		int bandRows = rowEnd-rowStart+1;
+
+		dataBuffer.resize(bandRows*sizeX);
+		zValuesByScanline(xStart, yStart+rowStart, xEnd, yStart+rowEnd, dataBuffer.data());
+		reduceBlock(dataBuffer.constData(), sizeX, bandRows, outputWidth, 1, mode, outputValues + oy*outputWidth);
+	}
+}
+
+void MPlotAbstractImageData::reduceBlock(const qreal *values, int width, int height, int outputWidth, int outputHeight, ReductionMode mode, qreal *outputValues)
+{
+	// first source column covered by each output column. (columnStart[outputWidth] == width)
+	QVector<int> columnStart(outputWidth+1);
+	for(int ox=0; ox<=outputWidth; ++ox)
+		columnStart[ox] = int(qint64(ox)*width/outputWidth);
+
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	// number of (non-NaN) values combined into each output value of the current row.
+	QVector<int> validCount(outputWidth);
+
+	for(int oy=0; oy<outputHeight; ++oy) {
+		// the band of source rows covered by this output row:
+		int rowStart = int(qint64(oy)*height/outputHeight);
+		int rowEnd = int(qint64(oy+1)*height/outputHeight)-1;
+		int bandRows = rowEnd-rowStart+1;
+
+		qreal* output = outputValues + oy*outputWidth;
+		const qreal* band = values + rowStart*width;
+
+		// seed each output value with an empty result, and then combine the band row by row so that the source is read sequentially.  NaN values are skipped: they fail the comparisons, and aren't added to the mean or counted.
+		for(int ox=0; ox<outputWidth; ++ox) {
+			output[ox] = (mode == ReduceMean) ? 0 : (mode == ReduceMinimum) ? infinity : -infinity;
+			validCount[ox] = 0;
+		}
+
+		for(int r=0; r<bandRows; ++r) {
+			const qreal* row = band + r*width;
+
+			for(int ox=0; ox<outputWidth; ++ox) {
+				int c1 = columnStart.at(ox+1);
+				qreal result = output[ox];
+				int valid = 0;
+
+				if(mode == ReduceMean) {
+					for(int c=columnStart.at(ox); c<c1; ++c)
+						if(row[c] == row[c]) {
+							result += row[c];
+							++valid;
+						}
+				}
+				else if(mode == ReduceMinimum) {
+					for(int c=columnStart.at(ox); c<c1; ++c) {
+						if(row[c] < result)
+							result = row[c];
+						valid += (row[c] == row[c]);
+					}
+				}
+				else {
+					for(int c=columnStart.at(ox); c<c1; ++c) {
+						if(row[c] > result)
+							result = row[c];
+						valid += (row[c] == row[c]);
+					}
+				}
+
+				output[ox] = result;
+				validCount[ox] += valid;
 			}
 		}
-		minMaxCache_.first = minZ;
-		minMaxCache_.second = maxZ;
-		minMaxCacheUpdateRequired_ = false;
+
+		// (only NaN in the block: NaN.)
+		for(int ox=0; ox<outputWidth; ++ox) {
+			if(validCount.at(ox) == 0)
+				output[ox] = std::numeric_limits<qreal>::quiet_NaN();
+			else if(mode == ReduceMean)
+				output[ox] /= validCount.at(ox);
+		}
+	}
+}
+
+MPlotImageSnapshot MPlotAbstractImageData::snapshot() const
+{
+	if(cachedSnapshot_.isNull() || cachedSnapshot_.version() != dataVersion_) {
+		QPoint c = count();
+		QVector<qreal> values(c.x()*c.y());
+		if(!values.isEmpty())
+			zValuesByScanline(0, 0, c.x()-1, c.y()-1, values.data());
+		cachedSnapshot_ = MPlotImageSnapshot(values, QSize(c.x(), c.y()), boundingRect(), dataVersion_);
 	}
+
+	return cachedSnapshot_;
 }
 
 MPlotInterval MPlotAbstractImageData::range() const {
@@ -201,4 +354,14 @@ void MPlotSimpleImageData::zValues(int xStart, int yStart, int xEnd, int yEnd, q
 			*(outputValues++) = d_[yy][xx];
 }
 
+void MPlotSimpleImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int rowLength = xEnd-xStart+1;
+
+	for(int yy=yStart; yy<=yEnd; ++yy) {
+		memcpy(outputValues, d_.at(yy).constData()+xStart, rowLength*sizeof(qreal));
+		outputValues += rowLength;
+	}
+}
+
 #endif // MPLOTIMAGEDATA_H
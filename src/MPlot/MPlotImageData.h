@@ -8,6 +8,7 @@
 #include <QRectF>
 #include <QPair>
 #include <QVector>
+#include <QSharedPointer>
 
 
 /// An MPlotInterval is just a typedef for a pair of qreals
@@ -16,6 +17,52 @@ typedef QPair<qreal,qreal> MPlotInterval;
 class MPlotAbstractImageData;
 
 
+/// This class is an immutable, versioned copy of image data. Copying it is O(1), and it can be read from any thread, however the data it came from changes afterwards.
+/*! See MPlotSeriesSnapshot; this is the same idea for z = f(x,y) data.  The z values are kept in scanline order (y varying the slowest), and the range of z values is computed once, when the snapshot is created.  The x and y values are spread evenly over the bounding rect, like MPlotSimpleImageData. */
+class MPLOTSHARED_EXPORT MPlotImageSnapshot {
+public:
+	/// Creates a null snapshot, with no values and version 0.
+	MPlotImageSnapshot() {}
+	/// Creates a snapshot of the \c size.width() x \c size.height() z \c values (in scanline order), covering \c bounds, identified by \c version.  The vector is shared, not copied.  (If it holds fewer values, it is copied, and the missing values are NaN.)
+	MPlotImageSnapshot(const QVector<qreal>& values, const QSize& size, const QRectF& bounds, quint64 version);
+
+	/// Returns true if this snapshot was default-constructed.
+	bool isNull() const { return !d_; }
+	/// Returns the version of the data this snapshot was taken from.  Versions increase with each change of the data.
+	quint64 version() const { return d_ ? d_->version : 0; }
+
+	/// Returns the number of values in x and y.
+	QPoint count() const { return d_ ? d_->count : QPoint(0,0); }
+	/// Returns the bounds of the data.
+	QRectF boundingRect() const { return d_ ? d_->boundingRect : QRectF(); }
+	/// Returns the minimum and maximum z values, or (0,1) if there are none.
+	MPlotInterval range() const { return d_ ? d_->range : MPlotInterval(0,1); }
+
+	/// Returns the x value corresponding to \c indexX.
+	qreal x(int indexX) const { return d_->boundingRect.left() + d_->boundingRect.width()*indexX/d_->count.x(); }
+	/// Returns the y value corresponding to \c indexY.
+	qreal y(int indexY) const { return d_->boundingRect.top() + d_->boundingRect.height()*indexY/d_->count.y(); }
+	/// Returns the z value at (\c indexX, \c indexY).
+	qreal z(int indexX, int indexY) const { return d_->values.at(indexY*d_->count.x() + indexX); }
+	/// Returns all the z values, in scanline order. (Shared, not copied.)
+	QVector<qreal> values() const { return d_ ? d_->values : QVector<qreal>(); }
+	/// Returns a pointer to the z values, in scanline order, or 0 if there are none.
+	const qreal* data() const { return d_ && !d_->values.isEmpty() ? d_->values.constData() : 0; }
+
+protected:
+	/// The shared, never modified contents of a snapshot.
+	struct Data {
+		QVector<qreal> values;
+		QPoint count;
+		QRectF boundingRect;
+		MPlotInterval range;
+		quint64 version;
+	};
+	/// Shared contents; null for a null snapshot.
+	QSharedPointer<const Data> d_;
+};
+
+
 /// This class acts as a proxy to emit signals for MPlotAbstractImageData. You can receive the dataChanged() signal by hooking up to MPlotAbstractImage::signalSource().
 /*! To allow classes that implement MPlotAbstractImageData to also inherit QObject, MPlotAbstractImageData does NOT inherit QObject.  However, it still needs a way to emit signals notifying of changes to the data, which is the role of this class.
   */
@@ -31,6 +78,8 @@ protected:
 	void emitDataChanged() { emit dataChanged(); }
 	/// Emits the bounds changed signal for the image.
 	void emitBoundsChanged() { emit boundsChanged(); }
+	/// Emits the rows scrolled signal for the image.
+	void emitRowsScrolled(int count) { emit rowsScrolled(count); }
 
 	/// Pointer to the data model.
 	MPlotAbstractImageData* data_;
@@ -42,6 +91,8 @@ signals:
 	void dataChanged();	/// < the z = f(x,y) data has changed
 	/// Notifier that the bounds of the data have changed.
 	void boundsChanged();/// < The limits / bounds of the x-y grid have changed
+	/// Notifier that the data has scrolled by \c count rows: the oldest \c count rows were dropped, every other row moved down by \c count, and \c count new rows were added at the end (the highest y indexes).  It is always followed by dataChanged(), so views that don't care about scrolling can ignore it.
+	void rowsScrolled(int count);
 };
 
 
@@ -51,6 +102,9 @@ signals:
 class MPLOTSHARED_EXPORT MPlotAbstractImageData {
 
 public:
+	/// How blocks of values are combined into one value when data is requested at a lower resolution than it is stored. (See zValuesReduced().)
+	enum ReductionMode { ReduceMean, ReduceMinimum, ReduceMaximum };
+
 	/// Constructor.  Builds a data model for the image.
 	MPlotAbstractImageData();
 	/// Destructor.
@@ -67,6 +121,18 @@ public:
 	virtual qreal z(int indexX, int indexY) const = 0;
 	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues. The data is copied in row-major order, ie: with the x-axis varying the slowest. (Can assume \c outputValues has enough room to hold all the values, that (xStart,yStart) <= (xEnd,yEnd), and that the indexes are not out of range.)
 	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const = 0;
+	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues, in scanline order: ie: with the y-axis varying the slowest, so that each run of (xEnd-xStart+1) values is one row of constant y. (Same assumptions as zValues().)
+	/*! This is the order that image plots need to fill their QImage scanlines sequentially.  The base class implementation fetches the data with zValues() in stripes of about 1MB, and transposes them using a cache-blocked transpose.  If your data is already stored by rows, re-implement this with a straight copy. */
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Copy the block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive into \c outputValues, downsampled to \c outputWidth x \c outputHeight values, in scanline order (like zValuesByScanline()).  Each output value combines the block of source values it covers, according to \c mode.  NaN values are skipped (the mean is over the other values); a block of only NaN values gives NaN.
+	/*! \c outputWidth and \c outputHeight must be >= 1, and no larger than the number of source values in each direction. The base class implementation reads every source value in the block through zValuesByScanline(), one band of rows at a time. Implementations that keep pre-computed reduced data (ex: a mip pyramid) should re-implement this. */
+	virtual void zValuesReduced(int xStart, int yStart, int xEnd, int yEnd, int outputWidth, int outputHeight, ReductionMode mode, qreal* outputValues) const;
+
+	/// If the z values are stored natively as unsigned integers of 8 or 16 bits, returns the number of bits (8 or 16).  Otherwise returns 0, which is the base class behaviour.
+	/*! Image plots use this to skip floating-point math altogether: they fetch the raw values with integerValuesByScanline(), and colorize them through a 256- or 65536-entry lookup table. */
+	virtual int integerDepth() const { return 0; }
+	/// When integerDepth() is 8 or 16, copy the block of raw values from (xStart,yStart) to (xEnd,yEnd) inclusive into \c outputValues, in scanline order (like zValuesByScanline()), without converting them to floating point.  Only called when integerDepth() is non-zero; the base class does nothing.
+	virtual void integerValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, quint16* outputValues) const { Q_UNUSED(xStart) Q_UNUSED(yStart) Q_UNUSED(xEnd) Q_UNUSED(yEnd) Q_UNUSED(outputValues) }
 
 	/// Convenience function overloads:
 	/// Returns the x position for a given point.
@@ -89,6 +155,14 @@ public:
 	virtual QRectF boundingRect() const = 0;
 	/// Return the minimum and maximum z values. The base implementation does a search through all data values, and caches the result until the z-values change (ie: until emitDataChanged() is called.)  If your implementation has a faster way of doing this, please re-implement.
 	virtual MPlotInterval range() const;
+	/// Returns true if zValues() can be called from several threads at once, which lets the range() search of large data use more than one thread.  The base class implementation returns false; re-implement if your model's reads don't modify anything.
+	virtual bool concurrentReadsSafe() const { return false; }
+
+	/// Returns an immutable copy of the data: see MPlotImageSnapshot.
+	/*! The base class implementation copies all the values with zValuesByScanline(), and keeps that copy until the data or bounds change, so asking again without changes is O(1).  It must be called from the thread that modifies the data.  Models that are written from other threads (like MPlotSnapshotImageData) re-implement this to return their latest published version in O(1), from any thread. */
+	virtual MPlotImageSnapshot snapshot() const;
+	/// Returns a number that increases each time the data or bounds change (ie: each time emitDataChanged() or emitBoundsChanged() is called).
+	quint64 dataVersion() const { return dataVersion_; }
 
 private:
 	/// Proxy object for emitting signals:
@@ -99,21 +173,28 @@ private:
 protected:
 
 	/// Implementing classes should call this when their z- data changes in value
-	void emitDataChanged() { minMaxCacheUpdateRequired_ = true; signalSource_->emitDataChanged(); }
+	void emitDataChanged() { ++dataVersion_; minMaxCacheUpdateRequired_ = true; signalSource_->emitDataChanged(); }
 	/// Implementing classes should call this when their x- y- data changes in extent
-	void emitBoundsChanged() { signalSource_->emitBoundsChanged(); }
+	void emitBoundsChanged() { ++dataVersion_; signalSource_->emitBoundsChanged(); }
+	/// Implementing classes that scroll (drop their oldest rows and append new rows at the end, without changing size) should call this instead of emitDataChanged().  Emits rowsScrolled(\c count), followed by dataChanged().
+	void emitRowsScrolled(int count) { signalSource_->emitRowsScrolled(count); emitDataChanged(); }
 
 	/// Used to cache the minimum and maximum Z-values
 	mutable MPlotInterval minMaxCache_;
 	/// Used to cache the minimum and maximum Z-values
 	mutable bool minMaxCacheUpdateRequired_;
-	/// Searches for minimum and maximum z value; stores in minMaxCache_.  Used by the base-class implementation of range().
+	/// Incremented on every change. See dataVersion().
+	quint64 dataVersion_;
+	/// The copy returned by the base-class implementation of snapshot(), kept until dataVersion_ changes.
+	mutable MPlotImageSnapshot cachedSnapshot_;
+	/// Searches for minimum and maximum z value; stores in minMaxCache_.  Used by the base-class implementation of range().  The base class implementation reads the data with zValues() in blocks of columns, using MPlotMinMax::search(). NaN values are skipped.
 	virtual void minMaxSearch() const;
 
+	/// Reduces a block of \c width x \c height \c values (in scanline order) to \c outputWidth x \c outputHeight \c outputValues, combining the values covered by each output value according to \c mode.  (The output size must be >= 1 and no larger than the input size in each direction.)  Used by zValuesReduced(), and available to implementations that re-implement it.
+	static void reduceBlock(const qreal* values, int width, int height, int outputWidth, int outputHeight, ReductionMode mode, qreal* outputValues);
+
 
-	// todo: to support multi-threading, consider a
-	// void pauseUpdates();	// to tell nothing to redraw using the plot because the data is currently invalid; a dataChanged will be emitted when it is valid again.
-	// This would need to be deterministic, so maybe we need to use function calls instead of signals.
+	// For multi-threading, readers use snapshot(), and data written from other threads goes through MPlotSnapshotImageData, which publishes whole versions instead of pausing updates.
 };
 
 
@@ -135,6 +216,10 @@ public:
 
 	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues. The data is copied in row-major order, ie: with the x-axis varying the slowest. (Can assume \c outputValues has enough room to hold all the values, that (xStart,yStart) <= (xEnd,yEnd), and that the indexes are not out of range.)
 	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to copy straight out of our row storage, without any transposing.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to return true: reading the rows doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
 
 
 
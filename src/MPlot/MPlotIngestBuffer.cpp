@@ -0,0 +1,142 @@
+#ifndef MPLOTINGESTBUFFER_CPP
+#define MPLOTINGESTBUFFER_CPP
+
+#include "MPlot/MPlotIngestBuffer.h"
+#include "MPlot/MPlotSeriesData.h"
+
+#include <QTimer>
+
+MPlotIngestBuffer::MPlotIngestBuffer(int capacity, QObject *parent)
+	: QObject(parent)
+{
+	capacity_ = 2;
+	while(capacity_ < capacity && capacity_ < (1 << 30))
+		capacity_ *= 2;
+	mask_ = capacity_-1;
+
+	xValues_.resize(capacity_);
+	yValues_.resize(capacity_);
+	xRing_ = xValues_.data();
+	yRing_ = yValues_.data();
+
+	droppedCountAtLastDrain_ = 0;
+	drainedCount_ = 0;
+	highWaterMark_ = 0;
+	model_ = 0;
+
+	drainTimer_ = new QTimer(this);
+	connect(drainTimer_, SIGNAL(timeout()), this, SLOT(onDrainTimer()));
+}
+
+MPlotIngestBuffer::~MPlotIngestBuffer()
+{
+}
+
+int MPlotIngestBuffer::push(const qreal *xValues, const qreal *yValues, int count)
+{
+	// positions count up forever and wrap around; their difference is still the number of waiting points.
+	int write = writePosition_.fetchAndAddRelaxed(0);	// only this thread stores it
+	int read = readPosition_.fetchAndAddAcquire(0);		// acquire: the consumer is done with the slots before read
+	int space = capacity_ - int(uint(write) - uint(read));
+
+	int accepted = qMin(count, space);
+	for(int i=0; i<accepted; ++i) {
+		int slot = (write+i) & mask_;
+		xRing_[slot] = xValues[i];
+		yRing_[slot] = yValues[i];
+	}
+
+	// release: the values above are visible before the new write position.
+	if(accepted > 0)
+		writePosition_.fetchAndStoreRelease(int(uint(write) + uint(accepted)));
+	if(accepted < count)
+		droppedCount_.fetchAndAddRelaxed(count-accepted);
+
+	return accepted;
+}
+
+int MPlotIngestBuffer::pendingCount() const
+{
+	int write = const_cast<QAtomicInt&>(writePosition_).fetchAndAddAcquire(0);
+	int read = const_cast<QAtomicInt&>(readPosition_).fetchAndAddAcquire(0);
+	return int(uint(write) - uint(read));
+}
+
+int MPlotIngestBuffer::droppedCount() const
+{
+	return const_cast<QAtomicInt&>(droppedCount_).fetchAndAddRelaxed(0);
+}
+
+int MPlotIngestBuffer::take(qreal *xValues, qreal *yValues, int maxCount)
+{
+	int read = readPosition_.fetchAndAddRelaxed(0);		// only this thread stores it
+	int write = writePosition_.fetchAndAddAcquire(0);	// acquire: see the values the producer wrote before publishing
+	int available = int(uint(write) - uint(read));
+
+	int count = maxCount < 0 ? available : qMin(available, maxCount);
+	for(int i=0; i<count; ++i) {
+		int slot = (read+i) & mask_;
+		xValues[i] = xRing_[slot];
+		yValues[i] = yRing_[slot];
+	}
+
+	// release: we're done reading the slots before the producer can reuse them.
+	if(count > 0)
+		readPosition_.fetchAndStoreRelease(int(uint(read) + uint(count)));
+
+	return count;
+}
+
+int MPlotIngestBuffer::drain(MPlotRealtimeModel *model)
+{
+	if(!model)
+		model = model_;
+
+	int dropped = droppedCount();
+	if(dropped != droppedCountAtLastDrain_) {
+		int newlyDropped = dropped - droppedCountAtLastDrain_;
+		droppedCountAtLastDrain_ = dropped;
+		emit pointsDropped(newlyDropped);
+	}
+
+	if(!model)
+		return 0;
+
+	int available = pendingCount();
+	if(available == 0)
+		return 0;
+	highWaterMark_ = qMax(highWaterMark_, available);
+
+	if(drainX_.size() < available) {
+		drainX_.resize(available);
+		drainY_.resize(available);
+	}
+
+	int count = take(drainX_.data(), drainY_.data(), available);
+	model->insertPointsBack(drainX_.constData(), drainY_.constData(), count);
+	drainedCount_ += count;
+
+	return count;
+}
+
+void MPlotIngestBuffer::startDraining(MPlotRealtimeModel *model, int intervalMs)
+{
+	model_ = model;
+	drainTimer_->start(intervalMs);
+}
+
+void MPlotIngestBuffer::stopDraining()
+{
+	drainTimer_->stop();
+}
+
+void MPlotIngestBuffer::resetCounters()
+{
+	// subtract instead of storing 0, so that drops counted by the producer meanwhile aren't lost.
+	droppedCount_.fetchAndAddRelaxed(-droppedCountAtLastDrain_);
+	droppedCountAtLastDrain_ = 0;
+	drainedCount_ = 0;
+	highWaterMark_ = 0;
+}
+
+#endif // MPLOTINGESTBUFFER_CPP
@@ -0,0 +1,115 @@
+#ifndef MPLOTINGESTBUFFER_H
+#define MPLOTINGESTBUFFER_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QVector>
+
+class QTimer;
+class MPlotRealtimeModel;
+
+/// The default interval, in milliseconds, at which an MPlotIngestBuffer drains into its model: about once per frame.
+#define MPLOT_INGEST_DRAIN_INTERVAL 16
+
+/// This class is a lock-free staging buffer that lets one acquisition thread feed (x,y) points into a series model, which must only be touched from the GUI thread.
+/*! It's a single-producer / single-consumer ring buffer:
+- The producer (acquisition) thread calls push(), without any locks or signals.  If the buffer is full, the points are dropped and counted in droppedCount(); push() returns how many points fit, so the producer can also apply its own back-pressure using freeSpace().
+- The consumer (GUI) thread drains the buffer into an MPlotRealtimeModel, either by calling drain() itself, or automatically every MPLOT_INGEST_DRAIN_INTERVAL ms after startDraining().  Each drain appends all the waiting points with MPlotRealtimeModel::insertPointsBack(), so the model sends a single notification (and the plot repaints once) per drain, no matter how many points arrived.
+
+The only shared state is the two ring positions, which are QAtomicInts: the producer publishes new points by storing the write position with release semantics, and the consumer frees space the same way with the read position.  Only one thread may push, and only one thread may drain.
+
+The MPlotIngestBuffer must live in the GUI thread (the thread that drains).
+*/
+class MPLOTSHARED_EXPORT MPlotIngestBuffer : public QObject {
+	Q_OBJECT
+
+public:
+	/// Constructor. The buffer holds up to \c capacity points, rounded up to a power of 2.
+	MPlotIngestBuffer(int capacity = 65536, QObject* parent = 0);
+	/// Destructor.
+	virtual ~MPlotIngestBuffer();
+
+	// Producer thread:
+	///////////////////////
+
+	/// Adds one point. Returns false (and counts it as dropped) if the buffer is full.  Only call from the producer thread.
+	bool push(qreal x, qreal y) { return push(&x, &y, 1) == 1; }
+	/// Adds \c count points. Returns how many fit; the rest are dropped and counted in droppedCount().  Only call from the producer thread.
+	int push(const qreal* xValues, const qreal* yValues, int count);
+
+	// Either thread:
+	///////////////////////
+
+	/// Returns the number of points the buffer can hold.
+	int capacity() const { return capacity_; }
+	/// Returns the number of points waiting to be drained.
+	int pendingCount() const;
+	/// Returns the number of points that can be pushed before the buffer is full.
+	int freeSpace() const { return capacity_ - pendingCount(); }
+	/// Returns the number of points dropped because the buffer was full, since construction or resetCounters().
+	int droppedCount() const;
+
+	// Consumer (GUI) thread:
+	///////////////////////
+
+	/// Copies up to \c maxCount waiting points (all of them if \c maxCount < 0) into \c xValues and \c yValues, and frees their space. Returns how many were copied.
+	int take(qreal* xValues, qreal* yValues, int maxCount);
+	/// Appends all the waiting points to the model set with startDraining() (or \c model, if given) with one bulk insert. Returns the number of points appended.  Emits pointsDropped() if points were dropped since the last drain.
+	int drain(MPlotRealtimeModel* model = 0);
+
+	/// Starts draining into \c model every \c intervalMs milliseconds.
+	void startDraining(MPlotRealtimeModel* model, int intervalMs = MPLOT_INGEST_DRAIN_INTERVAL);
+	/// Stops draining automatically. Points stay in the buffer until drained.
+	void stopDraining();
+
+	/// Returns the number of points drained so far.
+	qint64 drainedCount() const { return drainedCount_; }
+	/// Returns the largest number of points that were waiting at the start of a drain. If this gets close to capacity(), the buffer is too small for the data rate.
+	int highWaterMark() const { return highWaterMark_; }
+	/// Resets drainedCount() and highWaterMark() to 0, and droppedCount() to the number of drops not yet reported by pointsDropped().
+	void resetCounters();
+
+signals:
+	/// Emitted (from drain()) when \c count points were dropped since the last drain because the buffer was full.
+	void pointsDropped(int count);
+
+protected slots:
+	/// Drains into the model set with startDraining().
+	void onDrainTimer() { drain(); }
+
+protected:
+	/// Ring storage for the x values.
+	QVector<qreal> xValues_;
+	/// Ring storage for the y values.
+	QVector<qreal> yValues_;
+	/// Direct pointers into the ring storage, taken once, so the two threads never go through QVector's (detaching) accessors.
+	qreal* xRing_;
+	qreal* yRing_;
+	/// Number of slots (a power of 2).
+	int capacity_;
+	/// capacity_-1, to wrap positions into the ring.
+	int mask_;
+	/// Total number of points written (wrapping). Only stored by the producer.
+	QAtomicInt writePosition_;
+	/// Total number of points read (wrapping). Only stored by the consumer.
+	QAtomicInt readPosition_;
+	/// Number of dropped points. Only increased by the producer.
+	QAtomicInt droppedCount_;
+	/// Value of droppedCount_ at the last drain, to report new drops.
+	int droppedCountAtLastDrain_;
+
+	/// Number of points drained. (Consumer only.)
+	qint64 drainedCount_;
+	/// Largest number of waiting points seen by drain(). (Consumer only.)
+	int highWaterMark_;
+	/// Model to drain into.
+	MPlotRealtimeModel* model_;
+	/// Timer for automatic draining.
+	QTimer* drainTimer_;
+	/// Drain buffers, kept between drains to avoid allocating.
+	QVector<qreal> drainX_, drainY_;
+};
+
+#endif // MPLOTINGESTBUFFER_H
@@ -0,0 +1,515 @@
+#ifndef MPLOTMAPPEDDATA_CPP
+#define MPLOTMAPPEDDATA_CPP
+
+#include "MPlot/MPlotMappedData.h"
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegExp>
+#include <QDebug>
+
+#include <limits>
+
+MPlotMappedArray::MPlotMappedArray()
+{
+	mapping_ = 0;
+	data_ = 0;
+	type_ = InvalidType;
+	elementSize_ = 0;
+	rows_ = 0;
+	columns_ = 0;
+	fortranOrder_ = false;
+}
+
+MPlotMappedArray::~MPlotMappedArray()
+{
+	close();
+}
+
+void MPlotMappedArray::close()
+{
+	if(mapping_)
+		file_.unmap(mapping_);
+	file_.close();
+
+	mapping_ = 0;
+	data_ = 0;
+	type_ = InvalidType;
+	elementSize_ = 0;
+	rows_ = 0;
+	columns_ = 0;
+	fortranOrder_ = false;
+	columnRanges_.clear();
+}
+
+bool MPlotMappedArray::openNpy(const QString &fileName)
+{
+	close();
+
+	file_.setFileName(fileName);
+	if(!file_.open(QIODevice::ReadOnly)) {
+		qWarning() << "MPlotMappedArray: Could not open" << fileName;
+		return false;
+	}
+
+	// The preamble is the magic string, the format version, and the header length: 2 bytes in version 1.0, and 4 bytes after that.
+	QByteArray preamble = file_.read(12);
+	if(preamble.size() < 10 || !preamble.startsWith("\x93" "NUMPY")) {
+		qWarning() << "MPlotMappedArray:" << fileName << "is not a NumPy .npy file.";
+		close();
+		return false;
+	}
+
+	qint64 headerStart, headerLength;
+	if(preamble.at(6) == 1) {
+		headerStart = 10;
+		headerLength = qFromLittleEndian<quint16>((const uchar*)preamble.constData()+8);
+	}
+	else {
+		headerStart = 12;
+		headerLength = qFromLittleEndian<quint32>((const uchar*)preamble.constData()+8);
+	}
+
+	file_.seek(headerStart);
+	QString header = QString::fromLatin1(file_.read(headerLength));
+
+	// The header is a Python dictionary literal, ex: {'descr': '<f4', 'fortran_order': False, 'shape': (1000, 2), }
+	QRegExp descrExp("'descr'\\s*:\\s*'([<>|=])([fiu])(\\d+)'");
+	QRegExp fortranExp("'fortran_order'\\s*:\\s*(True|False)");
+	QRegExp shapeExp("'shape'\\s*:\\s*\\(([^)]*)\\)");
+
+	if(descrExp.indexIn(header) < 0 || fortranExp.indexIn(header) < 0 || shapeExp.indexIn(header) < 0) {
+		qWarning() << "MPlotMappedArray: Could not understand the header of" << fileName;
+		close();
+		return false;
+	}
+
+	QString kind = descrExp.cap(2) + descrExp.cap(3);
+	if(descrExp.cap(1) == ">" || (descrExp.cap(1) == "=" && Q_BYTE_ORDER == Q_BIG_ENDIAN))
+		type_ = InvalidType;
+	else if(kind == "f4")
+		type_ = Float32;
+	else if(kind == "f8")
+		type_ = Float64;
+	else if(kind == "i2")
+		type_ = Int16;
+	else if(kind == "u2")
+		type_ = UInt16;
+
+	if(type_ == InvalidType) {
+		qWarning() << "MPlotMappedArray: Unsupported element type" << descrExp.cap(0) << "in" << fileName << ". Supported types are little-endian float32, float64, int16 and uint16.";
+		close();
+		return false;
+	}
+
+	fortranOrder_ = (fortranExp.cap(1) == "True");
+
+	QList<qint64> shape;
+	foreach(QString dimension, shapeExp.cap(1).split(',')) {
+		if(!dimension.trimmed().isEmpty())
+			shape << dimension.trimmed().toLongLong();
+	}
+
+	if(shape.count() == 1) {
+		rows_ = shape.at(0);
+		columns_ = 1;
+	}
+	else if(shape.count() == 2) {
+		rows_ = shape.at(0);
+		columns_ = int(shape.at(1));
+	}
+	else {
+		qWarning() << "MPlotMappedArray: Only one- and two-dimensional arrays are supported, but" << fileName << "has" << shape.count() << "dimensions.";
+		close();
+		return false;
+	}
+
+	return mapFile(headerStart + headerLength);
+}
+
+bool MPlotMappedArray::openRaw(const QString &fileName, ElementType type, qint64 rows, int columns, bool fortranOrder, qint64 headerBytes)
+{
+	close();
+
+	file_.setFileName(fileName);
+	if(!file_.open(QIODevice::ReadOnly)) {
+		qWarning() << "MPlotMappedArray: Could not open" << fileName;
+		return false;
+	}
+
+	type_ = type;
+	rows_ = rows;
+	columns_ = columns;
+	fortranOrder_ = fortranOrder;
+
+	return mapFile(headerBytes);
+}
+
+bool MPlotMappedArray::mapFile(qint64 headerBytes)
+{
+	switch(type_) {
+	case Float32: elementSize_ = 4; break;
+	case Float64: elementSize_ = 8; break;
+	case Int16:
+	case UInt16: elementSize_ = 2; break;
+	default: elementSize_ = 0; break;
+	}
+
+	qint64 dataBytes = rows_*columns_*elementSize_;
+	if(dataBytes <= 0 || file_.size() < headerBytes + dataBytes) {
+		qWarning() << "MPlotMappedArray:" << file_.fileName() << "is empty, or too small for the array it should hold.";
+		close();
+		return false;
+	}
+
+	// map from the start of the file, so the operating system doesn't need the offset to be page-aligned.
+	mapping_ = file_.map(0, headerBytes + dataBytes);
+	if(!mapping_) {
+		qWarning() << "MPlotMappedArray: Could not map" << file_.fileName() << ":" << file_.errorString();
+		close();
+		return false;
+	}
+
+	data_ = mapping_ + headerBytes;
+	return true;
+}
+
+void MPlotMappedArray::convert(qint64 firstElement, qint64 count, qint64 stride, qreal *outputValues) const
+{
+	const uchar* p = data_ + firstElement*elementSize_;
+	qint64 step = stride*elementSize_;
+
+	// the values are little-endian. On a little-endian machine, qFromLittleEndian() is just a load.
+	switch(type_) {
+	case Float32:
+		for(qint64 i=0; i<count; ++i, p+=step) {
+			quint32 bits = qFromLittleEndian<quint32>(p);
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			outputValues[i] = value;
+		}
+		break;
+	case Float64:
+		for(qint64 i=0; i<count; ++i, p+=step) {
+			quint64 bits = qFromLittleEndian<quint64>(p);
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			outputValues[i] = value;
+		}
+		break;
+	case Int16:
+		for(qint64 i=0; i<count; ++i, p+=step)
+			outputValues[i] = qFromLittleEndian<qint16>(p);
+		break;
+	case UInt16:
+		for(qint64 i=0; i<count; ++i, p+=step)
+			outputValues[i] = qFromLittleEndian<quint16>(p);
+		break;
+	default:
+		break;
+	}
+}
+
+qreal MPlotMappedArray::value(qint64 row, int column) const
+{
+	qreal result;
+	convert(elementIndex(row, column), 1, 1, &result);
+	return result;
+}
+
+void MPlotMappedArray::readColumn(int column, qint64 rowStart, qint64 count, qreal *outputValues) const
+{
+	convert(elementIndex(rowStart, column), count, fortranOrder_ ? 1 : columns_, outputValues);
+}
+
+void MPlotMappedArray::readRow(qint64 row, int columnStart, int count, qreal *outputValues) const
+{
+	convert(elementIndex(row, columnStart), count, fortranOrder_ ? rows_ : 1, outputValues);
+}
+
+QVector<MPlotInterval> MPlotMappedArray::columnRanges(bool useSidecar) const
+{
+	if(!isValid() || !columnRanges_.isEmpty())
+		return columnRanges_;
+
+	if(useSidecar && readSidecar())
+		return columnRanges_;
+
+	// search in storage order, so the whole file is read sequentially exactly once. Work in blocks of approximately 1MB (125000 doubles).
+	qint64 total = rows_*columns_;
+	int blockSize = int(qMin(total, qint64(125000)));
+	QVector<qreal> dataBuffer(blockSize);
+
+	// starting from an empty range, NaN values fail both comparisons and are skipped, as in MPlotMinMax.
+	QVector<qreal> minimums(columns_, std::numeric_limits<qreal>::infinity()), maximums(columns_, -std::numeric_limits<qreal>::infinity());
+
+	for(qint64 start=0; start<total; start+=blockSize) {
+		int n = int(qMin(qint64(blockSize), total-start));
+		convert(start, n, 1, dataBuffer.data());
+		const qreal* values = dataBuffer.constData();
+
+		if(fortranOrder_) {
+			int column = int(start / rows_);
+			qint64 row = start % rows_;
+			for(int i=0; i<n; ++i) {
+				if(values[i] < minimums[column]) minimums[column] = values[i];
+				if(values[i] > maximums[column]) maximums[column] = values[i];
+				if(++row == rows_) { row = 0; column++; }
+			}
+		}
+		else {
+			int column = int(start % columns_);
+			for(int i=0; i<n; ++i) {
+				if(values[i] < minimums[column]) minimums[column] = values[i];
+				if(values[i] > maximums[column]) maximums[column] = values[i];
+				if(++column == columns_) column = 0;
+			}
+		}
+	}
+
+	columnRanges_.resize(columns_);
+	for(int c=0; c<columns_; ++c) {
+		if(minimums.at(c) <= maximums.at(c))
+			columnRanges_[c] = MPlotInterval(minimums.at(c), maximums.at(c));
+		else	// (only NaN in the column.)
+			columnRanges_[c] = MPlotInterval(std::numeric_limits<qreal>::quiet_NaN(), std::numeric_limits<qreal>::quiet_NaN());
+	}
+
+	if(useSidecar)
+		writeSidecar();
+
+	return columnRanges_;
+}
+
+// The first line of a sidecar file identifies the version of the data file it was written for.
+static QString sidecarSignature(const QString& fileName)
+{
+	QFileInfo info(fileName);
+	return QString("MPlotMappedArray %1 %2").arg(info.size()).arg(info.lastModified().toString(Qt::ISODate));
+}
+
+bool MPlotMappedArray::readSidecar() const
+{
+	QFile sidecar(sidecarFileName());
+	if(!sidecar.open(QIODevice::ReadOnly | QIODevice::Text))
+		return false;
+
+	QTextStream in(&sidecar);
+	if(in.readLine() != sidecarSignature(fileName()))
+		return false;
+
+	// one line per column: minimum maximum
+	QVector<MPlotInterval> ranges;
+	while(!in.atEnd()) {
+		QStringList parts = in.readLine().split(' ', QString::SkipEmptyParts);
+		if(parts.count() != 2)
+			return false;
+
+		bool minOk, maxOk;
+		ranges << MPlotInterval(parts.at(0).toDouble(&minOk), parts.at(1).toDouble(&maxOk));
+		if(!minOk || !maxOk)
+			return false;
+	}
+
+	if(ranges.count() != columns_)
+		return false;
+
+	columnRanges_ = ranges;
+	return true;
+}
+
+bool MPlotMappedArray::writeSidecar() const
+{
+	QFile sidecar(sidecarFileName());
+	if(!sidecar.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+		qWarning() << "MPlotMappedArray: Could not write the sidecar file" << sidecarFileName();
+		return false;
+	}
+
+	QTextStream out(&sidecar);
+	out << sidecarSignature(fileName()) << "\n";
+	foreach(MPlotInterval range, columnRanges_)
+		out << QString::number(range.first, 'g', 17) << " " << QString::number(range.second, 'g', 17) << "\n";
+
+	return true;
+}
+
+
+
+MPlotMappedSeriesData::MPlotMappedSeriesData(const QString &fileName, int xColumn, int yColumn)
+	: MPlotAbstractSeriesData()
+{
+	xColumn_ = xColumn;
+	yColumn_ = yColumn;
+	sidecarEnabled_ = false;
+
+	array_.openNpy(fileName);
+}
+
+MPlotMappedSeriesData::MPlotMappedSeriesData(const QString &fileName, MPlotMappedArray::ElementType type, qint64 rows, int columns, int xColumn, int yColumn, bool fortranOrder, qint64 headerBytes)
+	: MPlotAbstractSeriesData()
+{
+	xColumn_ = xColumn;
+	yColumn_ = yColumn;
+	sidecarEnabled_ = false;
+
+	array_.openRaw(fileName, type, rows, columns, fortranOrder, headerBytes);
+}
+
+int MPlotMappedSeriesData::count() const
+{
+	if(!isValid())
+		return 0;
+
+	return int(qMin(array_.rows(), qint64(std::numeric_limits<int>::max())));
+}
+
+qreal MPlotMappedSeriesData::x(unsigned index) const
+{
+	if(xColumn_ < 0)
+		return index;
+
+	return array_.value(index, xColumn_);
+}
+
+void MPlotMappedSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	if(xColumn_ < 0) {
+		for(unsigned i=indexStart; i<=indexEnd; ++i)
+			*(outputValues++) = i;
+		return;
+	}
+
+	array_.readColumn(xColumn_, indexStart, indexEnd-indexStart+1, outputValues);
+}
+
+qreal MPlotMappedSeriesData::y(unsigned index) const
+{
+	return array_.value(index, yColumn_);
+}
+
+void MPlotMappedSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	array_.readColumn(yColumn_, indexStart, indexEnd-indexStart+1, outputValues);
+}
+
+QRectF MPlotMappedSeriesData::boundingRect() const
+{
+	int size = count();
+	if(size == 0)
+		return QRectF();
+
+	if(cachedDataRectUpdateRequired_) {
+
+		QVector<MPlotInterval> ranges = array_.columnRanges(sidecarEnabled_);
+		MPlotInterval xRange = (xColumn_ < 0) ? MPlotInterval(0, size-1) : ranges.at(xColumn_);
+		MPlotInterval yRange = ranges.at(yColumn_);
+
+		// as in MPlotAbstractSeriesData::boundingRect(): make sure a single data point still has a valid rectangle.
+		cachedDataRect_ = QRectF(xRange.first,
+								 yRange.first,
+								 qMax(xRange.second-xRange.first, std::numeric_limits<qreal>::min()),
+								 qMax(yRange.second-yRange.first, std::numeric_limits<qreal>::min()));
+		cachedDataRectUpdateRequired_ = false;
+	}
+
+	return cachedDataRect_;
+}
+
+
+
+MPlotMappedImageData::MPlotMappedImageData(const QString &fileName, const QRectF &dataBounds)
+	: MPlotAbstractImageData(),
+	  bounds_(dataBounds)
+{
+	sidecarEnabled_ = false;
+
+	if(array_.openNpy(fileName) && array_.rows() > std::numeric_limits<int>::max()) {
+		qWarning() << "MPlotMappedImageData:" << fileName << "has too many rows for an image.";
+		array_.close();
+	}
+}
+
+MPlotMappedImageData::MPlotMappedImageData(const QString &fileName, MPlotMappedArray::ElementType type, int width, int height, const QRectF &dataBounds, bool fortranOrder, qint64 headerBytes)
+	: MPlotAbstractImageData(),
+	  bounds_(dataBounds)
+{
+	sidecarEnabled_ = false;
+
+	array_.openRaw(fileName, type, height, width, fortranOrder, headerBytes);
+}
+
+QPoint MPlotMappedImageData::count() const
+{
+	if(!isValid())
+		return QPoint(0,0);
+
+	return QPoint(array_.columns(), int(array_.rows()));
+}
+
+QRectF MPlotMappedImageData::boundingRect() const
+{
+	return bounds_;
+}
+
+qreal MPlotMappedImageData::x(int indexX) const
+{
+	return bounds_.left() + bounds_.width()*indexX/array_.columns();
+}
+
+qreal MPlotMappedImageData::y(int indexY) const
+{
+	return bounds_.top() + bounds_.height()*indexY/array_.rows();
+}
+
+qreal MPlotMappedImageData::z(int indexX, int indexY) const
+{
+	return array_.value(indexY, indexX);
+}
+
+void MPlotMappedImageData::zValues(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int columnLength = yEnd-yStart+1;
+
+	for(int xx=xStart; xx<=xEnd; ++xx) {
+		array_.readColumn(xx, yStart, columnLength, outputValues);
+		outputValues += columnLength;
+	}
+}
+
+void MPlotMappedImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int rowLength = xEnd-xStart+1;
+
+	for(int yy=yStart; yy<=yEnd; ++yy) {
+		array_.readRow(yy, xStart, rowLength, outputValues);
+		outputValues += rowLength;
+	}
+}
+
+void MPlotMappedImageData::minMaxSearch() const
+{
+	QVector<MPlotInterval> ranges = array_.columnRanges(sidecarEnabled_);
+	if(ranges.isEmpty())
+		return;
+
+	// columns of only NaN values have a NaN range: leave them out.
+	MPlotInterval result(std::numeric_limits<qreal>::infinity(), -std::numeric_limits<qreal>::infinity());
+	foreach(MPlotInterval range, ranges) {
+		if(!(range.first <= range.second))
+			continue;
+		if(range.first < result.first) result.first = range.first;
+		if(range.second > result.second) result.second = range.second;
+	}
+
+	if(result.first > result.second)	// (only NaN in the whole array.)
+		result = MPlotInterval(std::numeric_limits<qreal>::quiet_NaN(), std::numeric_limits<qreal>::quiet_NaN());
+
+	minMaxCache_ = result;
+	minMaxCacheUpdateRequired_ = false;
+}
+
+#endif // MPLOTMAPPEDDATA_CPP
@@ -0,0 +1,200 @@
+#ifndef MPLOTMAPPEDDATA_H
+#define MPLOTMAPPEDDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+#include "MPlot/MPlotImageData.h"
+
+#include <QFile>
+#include <QString>
+
+/// This class provides read access to a 2D array of numbers stored in a file, by memory-mapping the file instead of reading it.
+/*! Opening a file only parses the header and maps it, so it takes about the same time no matter how big the file is.  Values are converted to qreal as they are read, and the operating system's page cache decides what is actually in memory.
+
+Two formats are supported:
+- NumPy .npy files (versions 1.0, 2.0 and 3.0), with openNpy().  One-dimensional arrays are treated as a single column.
+- Raw binary files, with openRaw(), where you provide the element type, the shape, the order, and the number of header bytes to skip.
+
+The elements must be little-endian float32, float64, int16 or uint16.  Arrays can be in C order (row after row) or Fortran order (column after column).  Reading along the stored order is a sequential scan of the file; reading across it is strided.
+*/
+class MPLOTSHARED_EXPORT MPlotMappedArray {
+public:
+	/// The element types we can read.
+	enum ElementType { InvalidType, Float32, Float64, Int16, UInt16 };
+
+	/// Constructor. Creates an invalid (closed) array.
+	MPlotMappedArray();
+	/// Destructor. Unmaps and closes the file.
+	~MPlotMappedArray();
+
+	/// Opens and maps the NumPy .npy file \c fileName.  Returns false (and prints a warning) if the file can't be opened or mapped, or if the element type is not supported.
+	bool openNpy(const QString& fileName);
+	/// Opens and maps the raw binary file \c fileName, which holds \c rows x \c columns values of \c type after \c headerBytes of header.  Returns false (and prints a warning) if the file can't be opened or mapped, or is too small.
+	bool openRaw(const QString& fileName, ElementType type, qint64 rows, int columns, bool fortranOrder = false, qint64 headerBytes = 0);
+	/// Unmaps and closes the file.
+	void close();
+
+	/// Returns true if a file is open and mapped.
+	bool isValid() const { return data_ != 0; }
+	/// Returns the name of the mapped file.
+	QString fileName() const { return file_.fileName(); }
+	/// Returns the type of the elements.
+	ElementType elementType() const { return type_; }
+	/// Returns the number of rows.
+	qint64 rows() const { return rows_; }
+	/// Returns the number of columns.
+	int columns() const { return columns_; }
+	/// Returns true if the array is stored column after column (Fortran order), and false if it is stored row after row (C order).
+	bool fortranOrder() const { return fortranOrder_; }
+
+	/// Returns the value at (\c row, \c column).
+	qreal value(qint64 row, int column) const;
+	/// Copies \c count values from \c column, starting at \c rowStart, into \c outputValues.
+	void readColumn(int column, qint64 rowStart, qint64 count, qreal* outputValues) const;
+	/// Copies \c count values from \c row, starting at \c columnStart, into \c outputValues.
+	void readRow(qint64 row, int columnStart, int count, qreal* outputValues) const;
+
+	/// Returns the minimum and maximum of every column.  They are searched for the first time this is called, in a single pass over the file in storage order (1MB blocks), and remembered after that.
+	/*! If \c useSidecar is true, they are loaded from the sidecarFileName() if it exists and matches this file; otherwise, the sidecar file is written after the search. */
+	QVector<MPlotInterval> columnRanges(bool useSidecar = false) const;
+	/// Returns the name of the sidecar file used to remember the columnRanges() of this file.  It's the file name with ".mplotsummary" added.
+	QString sidecarFileName() const { return fileName() + ".mplotsummary"; }
+
+protected:
+	/// The mapped file.
+	QFile file_;
+	/// Start of the mapping. 0 when not mapped.
+	uchar* mapping_;
+	/// Start of the array data, inside the mapping. 0 when not mapped.
+	const uchar* data_;
+	/// Type of the elements.
+	ElementType type_;
+	/// Size of an element, in bytes.
+	int elementSize_;
+	/// Number of rows.
+	qint64 rows_;
+	/// Number of columns.
+	int columns_;
+	/// True for Fortran (column-major) order.
+	bool fortranOrder_;
+	/// Cache of columnRanges(). Empty until searched.
+	mutable QVector<MPlotInterval> columnRanges_;
+
+	/// Maps the file (which must already have type_, rows_, columns_ and fortranOrder_ set up) with the array data starting at \c headerBytes.
+	bool mapFile(qint64 headerBytes);
+	/// Converts \c count elements, starting at element \c firstElement and stepping by \c stride elements, into \c outputValues.
+	void convert(qint64 firstElement, qint64 count, qint64 stride, qreal* outputValues) const;
+	/// Reads the column ranges from the sidecar file into columnRanges_.  Returns false if there is no sidecar file, or if it was written for a different version of the data file (size or modification time don't match).
+	bool readSidecar() const;
+	/// Writes columnRanges_ to the sidecar file, along with the size and modification time of the data file.  Returns false if it can't be written.
+	bool writeSidecar() const;
+	/// Returns the index of the element at (\c row, \c column), in storage order.
+	qint64 elementIndex(qint64 row, int column) const { return fortranOrder_ ? qint64(column)*rows_ + row : row*columns_ + column; }
+};
+
+
+/// This class implements MPlotAbstractSeriesData by memory-mapping a file (see MPlotMappedArray), so that large recorded runs open instantly without being loaded into memory.
+/*! The x and y values come from two columns of the array.  Use -1 for the x column to use the row index as x (ex: for a one-dimensional .npy file of y values).
+
+The boundingRect() is computed the first time it's needed, in a single pass of 1MB blocks.  If setSidecarEnabled() is on, it is saved next to the data file and re-used when the same file is opened again.
+
+The data is read-only: dataChanged() is never emitted.
+*/
+class MPLOTSHARED_EXPORT MPlotMappedSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructor: maps the NumPy .npy file \c fileName, with x values from \c xColumn and y values from \c yColumn.  A one-dimensional array is one column, so use (-1, 0) for it.
+	MPlotMappedSeriesData(const QString& fileName, int xColumn = 0, int yColumn = 1);
+	/// Constructor: maps the raw binary file \c fileName, which holds \c rows x \c columns values of \c type after \c headerBytes of header.  x values come from \c xColumn and y values from \c yColumn.
+	MPlotMappedSeriesData(const QString& fileName, MPlotMappedArray::ElementType type, qint64 rows, int columns, int xColumn = 0, int yColumn = 1, bool fortranOrder = false, qint64 headerBytes = 0);
+
+	/// Returns true if the file was opened and mapped successfully, and the columns are in range.
+	bool isValid() const { return array_.isValid() && xColumn_ < array_.columns() && yColumn_ < array_.columns() && yColumn_ >= 0; }
+	/// Access to the mapped array.
+	const MPlotMappedArray* array() const { return &array_; }
+
+	/// Implements MPlotAbstractSeriesData: returns the x value at \c index.
+	virtual qreal x(unsigned index) const;
+	/// Copy all the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Implements MPlotAbstractSeriesData: returns the y value at \c index.
+	virtual qreal y(unsigned index) const;
+	/// Copy all the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Implements MPlotAbstractSeriesData: returns the number of data points. (0 if not valid.)
+	virtual int count() const;
+
+	/// Re-implemented to search both columns in a single pass of 1MB blocks (instead of four passes over copies of the whole data), and to use the sidecar file if enabled.
+	virtual QRectF boundingRect() const;
+
+	/// Returns true if the bounds are saved to (and loaded from) a sidecar file next to the data file.
+	bool sidecarEnabled() const { return sidecarEnabled_; }
+	/// Enables saving the bounds to a sidecar file next to the data file, so they don't have to be searched for the next time it's opened.  Off by default.
+	void setSidecarEnabled(bool enabled) { sidecarEnabled_ = enabled; }
+
+protected:
+	/// The mapped file.
+	MPlotMappedArray array_;
+	/// Column for the x values, or -1 to use the row index.
+	int xColumn_;
+	/// Column for the y values.
+	int yColumn_;
+	/// Whether to use the sidecar file for the bounds.
+	bool sidecarEnabled_;
+};
+
+
+/// This class implements MPlotAbstractImageData by memory-mapping a file (see MPlotMappedArray), so that large images open instantly without being loaded into memory.
+/*! Row y of the array holds the values for y index y, so a C-order array is stored scanline by scanline, and zValuesByScanline() reads it sequentially.  (For a Fortran-order array, zValues() is the sequential direction.)
+
+The range() is computed the first time it's needed, in a single pass of 1MB blocks.  If setSidecarEnabled() is on, it is saved next to the data file and re-used when the same file is opened again.
+
+The data is read-only: dataChanged() is never emitted.
+*/
+class MPLOTSHARED_EXPORT MPlotMappedImageData : public MPlotAbstractImageData {
+
+public:
+	/// Constructor: maps the two-dimensional NumPy .npy file \c fileName, to represent image data with physical coordinate boundaries \c dataBounds.
+	MPlotMappedImageData(const QString& fileName, const QRectF& dataBounds);
+	/// Constructor: maps the raw binary file \c fileName, which holds \c height rows of \c width values of \c type after \c headerBytes of header, to represent image data with physical coordinate boundaries \c dataBounds.
+	MPlotMappedImageData(const QString& fileName, MPlotMappedArray::ElementType type, int width, int height, const QRectF& dataBounds, bool fortranOrder = false, qint64 headerBytes = 0);
+
+	/// Returns true if the file was opened and mapped successfully.
+	bool isValid() const { return array_.isValid(); }
+	/// Access to the mapped array.
+	const MPlotMappedArray* array() const { return &array_; }
+
+	/// Return the x (independent data value) corresponding to \c indexX.
+	virtual qreal x(int indexX) const;
+	/// Return the y (independendent data value) corresponding to \c indexY.
+	virtual qreal y(int indexY) const;
+	/// Return the z = f(x,y) dependent data value corresponding (\c indexX, \c indexY).
+	virtual qreal z(int indexX, int indexY) const;
+	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues, with the x-axis varying the slowest.
+	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to read one array row at a time, without transposing.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+
+	/// Return the number of elements in x and y. (0 if not valid.)
+	virtual QPoint count() const;
+	/// Return the bounds of the data (the rectangle containing the max/min x- and y-values)
+	virtual QRectF boundingRect() const;
+
+	/// Returns true if the range is saved to (and loaded from) a sidecar file next to the data file.
+	bool sidecarEnabled() const { return sidecarEnabled_; }
+	/// Enables saving the range to a sidecar file next to the data file, so it doesn't have to be searched for the next time it's opened.  Off by default.
+	void setSidecarEnabled(bool enabled) { sidecarEnabled_ = enabled; }
+
+protected:
+	/// The mapped file.
+	MPlotMappedArray array_;
+	/// the (min/max) (x/y) values, in physical(data) coordinates. bounds_.upperLeft is == (minX, minY)
+	QRectF bounds_;
+	/// Whether to use the sidecar file for the range.
+	bool sidecarEnabled_;
+
+	/// Re-implemented to read the sidecar file if enabled, or else search in the stored order in 1MB blocks.
+	virtual void minMaxSearch() const;
+};
+
+#endif // MPLOTMAPPEDDATA_H
@@ -0,0 +1,122 @@
+#ifndef MPLOTMINMAX_CPP
+#define MPLOTMINMAX_CPP
+
+#include "MPlot/MPlotMinMax.h"
+#include "MPlot/MPlotParallel.h"
+
+#include <QVector>
+
+#include <limits>
+
+MPlotMinMax::MPlotMinMax()
+{
+	minimum_ = std::numeric_limits<qreal>::infinity();
+	maximum_ = -std::numeric_limits<qreal>::infinity();
+}
+
+void MPlotMinMax::add(const qreal *values, qint64 count)
+{
+	// four independent lanes. A NaN fails both comparisons, so it never replaces anything.
+	qreal min0 = minimum_, min1 = minimum_, min2 = minimum_, min3 = minimum_;
+	qreal max0 = maximum_, max1 = maximum_, max2 = maximum_, max3 = maximum_;
+
+	qint64 i = 0;
+	for(; i+4 <= count; i += 4) {
+		min0 = values[i] < min0 ? values[i] : min0;
+		min1 = values[i+1] < min1 ? values[i+1] : min1;
+		min2 = values[i+2] < min2 ? values[i+2] : min2;
+		min3 = values[i+3] < min3 ? values[i+3] : min3;
+		max0 = values[i] > max0 ? values[i] : max0;
+		max1 = values[i+1] > max1 ? values[i+1] : max1;
+		max2 = values[i+2] > max2 ? values[i+2] : max2;
+		max3 = values[i+3] > max3 ? values[i+3] : max3;
+	}
+	for(; i < count; ++i) {
+		min0 = values[i] < min0 ? values[i] : min0;
+		max0 = values[i] > max0 ? values[i] : max0;
+	}
+
+	minimum_ = qMin(qMin(min0, min1), qMin(min2, min3));
+	maximum_ = qMax(qMax(max0, max1), qMax(max2, max3));
+}
+
+void MPlotMinMax::add(const MPlotMinMax &other)
+{
+	if(other.minimum_ < minimum_)
+		minimum_ = other.minimum_;
+	if(other.maximum_ > maximum_)
+		maximum_ = other.maximum_;
+}
+
+qreal MPlotMinMax::minimum() const
+{
+	return isValid() ? minimum_ : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+qreal MPlotMinMax::maximum() const
+{
+	return isValid() ? maximum_ : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+void MPlotMinMax::searchUnits(const MPlotMinMaxSource *source, qint64 start, qint64 end, MPlotMinMax *results)
+{
+	int unitLength = qMax(1, source->unitLength());
+	int channels = source->channels();
+	qint64 unitsPerChunk = qMax(1, MPLOT_MINMAX_CHUNK / unitLength);
+
+	QVector<qreal> buffer(int(qMin(unitsPerChunk, end-start))*unitLength);
+
+	for(qint64 chunkStart = start; chunkStart < end; chunkStart += unitsPerChunk) {
+		qint64 chunkUnits = qMin(unitsPerChunk, end-chunkStart);
+		for(int c=0; c<channels; ++c) {
+			source->read(c, chunkStart, chunkUnits, buffer.data());
+			results[c].add(buffer.constData(), chunkUnits*unitLength);
+		}
+	}
+}
+
+/// Searches an MPlotMinMaxSource in parts, with MPlotParallel::run().  Each part puts its results in a separate place.
+class MPlotMinMaxJob : public MPlotParallelJob {
+public:
+	MPlotMinMaxJob(const MPlotMinMaxSource* source, int parts)
+		: source_(source), units_(source->units()), channels_(source->channels()), results_(parts*source->channels()) {
+		unitsPerPart_ = (units_ + parts - 1) / parts;
+		resultsData_ = results_.data();
+	}
+	virtual void runPart(int part) {
+		qint64 start = part*unitsPerPart_;
+		qint64 end = qMin(units_, start+unitsPerPart_);
+		if(start < end)
+			MPlotMinMax::searchUnits(source_, start, end, resultsData_ + part*channels_);
+	}
+
+	const MPlotMinMaxSource* source_;
+	qint64 units_, unitsPerPart_;
+	int channels_;
+	/// The results of each part, one per channel.
+	QVector<MPlotMinMax> results_;
+	/// (taken once, so that the threads don't call QVector::data() at the same time.)
+	MPlotMinMax* resultsData_;
+};
+
+void MPlotMinMax::search(const MPlotMinMaxSource *source, MPlotMinMax *results)
+{
+	qint64 units = source->units();
+	int channels = source->channels();
+	int threads = MPlotParallel::threadCount();
+
+	if(threads < 2 || !source->concurrentReadsSafe() || units*source->unitLength()*channels < MPLOT_MINMAX_CONCURRENT_THRESHOLD) {
+		searchUnits(source, 0, units, results);
+		return;
+	}
+
+	// split the units evenly between the threads of the shared pool and this one.
+	MPlotMinMaxJob job(source, threads);
+	MPlotParallel::run(&job, threads);
+
+	for(int part=0; part<threads; ++part)
+		for(int c=0; c<channels; ++c)
+			results[c].add(job.results_.at(part*channels+c));
+}
+
+#endif // MPLOTMINMAX_CPP
@@ -0,0 +1,88 @@
+#ifndef MPLOTMINMAX_H
+#define MPLOTMINMAX_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QtGlobal>
+
+/// The number of values read and searched at once by MPlotMinMax::search(): 16384 doubles (128kB) stays inside the L2 cache.
+#define MPLOT_MINMAX_CHUNK 16384
+/// Searches over more values than this are split between threads, if the source allows it (see MPlotMinMaxSource::concurrentReadsSafe()).
+#define MPLOT_MINMAX_CONCURRENT_THRESHOLD 1048576
+
+/// This interface provides values to MPlotMinMax::search(), a chunk at a time.
+/*! The values are organized as units() units of unitLength() values each, in one or more channels() (ex: the x and y values of a series are two channels with one value per unit; an image is one channel with a column of values per unit). */
+class MPLOTSHARED_EXPORT MPlotMinMaxSource {
+public:
+	/// Destructor.
+	virtual ~MPlotMinMaxSource() {}
+
+	/// Returns the number of units.
+	virtual qint64 units() const = 0;
+	/// Returns the number of values in each unit.
+	virtual int unitLength() const { return 1; }
+	/// Returns the number of channels.
+	virtual int channels() const { return 1; }
+	/// Copies the values of \c count units starting at \c start, for \c channel, into \c outputValues (\c count*unitLength() values).
+	virtual void read(int channel, qint64 start, qint64 count, qreal* outputValues) const = 0;
+	/// Returns true if read() can be called from several threads at once.  The base class implementation returns false.
+	virtual bool concurrentReadsSafe() const { return false; }
+};
+
+/// This class accumulates the minimum and maximum of a set of values, in a single fused pass.
+/*! NaN values are skipped, the same way the plain comparisons used in the rest of the library skip them.  If there are no values (or they are all NaN), isValid() is false and minimum() and maximum() return NaN.
+
+add() keeps four independent running minimums and maximums, so the loop has no dependency from one value to the next, and the compiler can turn it into SIMD min/max instructions. */
+class MPLOTSHARED_EXPORT MPlotMinMax {
+public:
+	/// Constructor. Starts with no values.
+	MPlotMinMax();
+
+	/// Adds \c count \c values.
+	void add(const qreal* values, qint64 count);
+	/// Adds all the values accumulated by \c other.
+	void add(const MPlotMinMax& other);
+
+	/// Returns true if at least one (non-NaN) value has been added.
+	bool isValid() const { return minimum_ <= maximum_; }
+	/// Returns the minimum value, or NaN if !isValid().
+	qreal minimum() const;
+	/// Returns the maximum value, or NaN if !isValid().
+	qreal maximum() const;
+
+	/// Searches all the values of \c source, and puts the result for each channel in \c results (which must have room for source->channels() results).
+	/*! The values are read MPLOT_MINMAX_CHUNK at a time, so no copy of the whole data is needed.  If there are more than MPLOT_MINMAX_CONCURRENT_THRESHOLD values and source->concurrentReadsSafe(), the units are split between the threads of the shared MPlotParallel pool. */
+	static void search(const MPlotMinMaxSource* source, MPlotMinMax* results);
+
+	/// Finds the minimum and maximum of \c count \c values in their native type \c T, without converting them to qreal.  NaN values are skipped, as in add().  Returns false if there are no (non-NaN) values, leaving \c minimum and \c maximum unchanged.
+	template<typename T>
+	static bool searchNative(const T* values, qint64 count, T& minimum, T& maximum) {
+		// start from the first value that isn't NaN (for integer types, that's the first one); later NaN values fail both comparisons.
+		qint64 i = 0;
+		while(i < count && !(values[i] == values[i]))
+			++i;
+		if(i == count)
+			return false;
+
+		T minValue = values[i], maxValue = values[i];
+		for(++i; i<count; ++i) {
+			if(values[i] < minValue) minValue = values[i];
+			if(values[i] > maxValue) maxValue = values[i];
+		}
+		minimum = minValue;
+		maximum = maxValue;
+		return true;
+	}
+
+protected:
+	/// Smallest value so far. +infinity when empty.
+	qreal minimum_;
+	/// Largest value so far. -infinity when empty.
+	qreal maximum_;
+
+	/// Searches units [\c start, \c end) of \c source, one chunk at a time, adding the results to \c results.
+	static void searchUnits(const MPlotMinMaxSource* source, qint64 start, qint64 end, MPlotMinMax* results);
+	friend class MPlotMinMaxJob;
+};
+
+#endif // MPLOTMINMAX_H
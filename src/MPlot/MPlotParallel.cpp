@@ -0,0 +1,85 @@
+#ifndef MPLOTPARALLEL_CPP
+#define MPLOTPARALLEL_CPP
+
+#include "MPlot/MPlotParallel.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QSharedPointer>
+
+/// The thread pool shared by MPlotParallel::run(): one thread less than the ideal count, since the caller works too, kept alive between runs.
+class MPlotParallelPool : public QThreadPool {
+public:
+	MPlotParallelPool() : QThreadPool() {
+		setMaxThreadCount(qMax(1, QThread::idealThreadCount()-1));
+		setExpiryTimeout(-1);
+	}
+};
+
+Q_GLOBAL_STATIC(MPlotParallelPool, mplotParallelPool)
+
+/// The state of one MPlotParallel::run(), shared with its pool tasks.  It's reference counted, because a pool task that starts late can still look at it after run() has returned.
+class MPlotParallelState {
+public:
+	MPlotParallelState(MPlotParallelJob* job, int parts) : job_(job), parts_(parts), next_(0) {}
+
+	/// Claims parts and runs them until there are none left.  Once all the parts are claimed, the job isn't touched again.
+	void work() {
+		for(;;) {
+			int part = next_.fetchAndAddOrdered(1);
+			if(part >= parts_)
+				return;
+			job_->runPart(part);
+			done_.release();
+		}
+	}
+
+	MPlotParallelJob* job_;
+	int parts_;
+	/// The next part to claim.
+	QAtomicInt next_;
+	/// Released once for every part that is done.
+	QSemaphore done_;
+};
+
+/// Works on an MPlotParallelState, on a pool thread.
+class MPlotParallelTask : public QRunnable {
+public:
+	MPlotParallelTask(const QSharedPointer<MPlotParallelState>& state) : QRunnable(), state_(state) {}
+	virtual void run() { state_->work(); }
+
+protected:
+	QSharedPointer<MPlotParallelState> state_;
+};
+
+int MPlotParallel::threadCount()
+{
+	return qMax(1, QThread::idealThreadCount());
+}
+
+QThreadPool* MPlotParallel::pool()
+{
+	return mplotParallelPool();
+}
+
+void MPlotParallel::run(MPlotParallelJob *job, int parts)
+{
+	if(parts < 1)
+		return;
+
+	QSharedPointer<MPlotParallelState> state(new MPlotParallelState(job, parts));
+
+	// no more helpers than the pool has threads, or than there are parts besides the one we'll do.
+	QThreadPool* pool = MPlotParallel::pool();
+	int helpers = qMin(parts-1, pool->maxThreadCount());
+	for(int i=0; i<helpers; ++i)
+		pool->start(new MPlotParallelTask(state));
+
+	state->work();
+	state->done_.acquire(parts);
+}
+
+#endif // MPLOTPARALLEL_CPP
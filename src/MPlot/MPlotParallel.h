@@ -0,0 +1,32 @@
+#ifndef MPLOTPARALLEL_H
+#define MPLOTPARALLEL_H
+
+#include "MPlot/MPlot_global.h"
+
+class QThreadPool;
+
+/// This interface is the work done by MPlotParallel::run(): a number of parts that can be done at the same time, on different threads.
+class MPLOTSHARED_EXPORT MPlotParallelJob {
+public:
+	/// Destructor.
+	virtual ~MPlotParallelJob() {}
+
+	/// Does part \c part of the work.  Called from several threads at once, each with a different part.
+	virtual void runPart(int part) = 0;
+};
+
+/// This class runs the parts of an MPlotParallelJob on a thread pool shared by the whole library, and on the calling thread.
+/*! The pool is created the first time it is needed, with QThread::idealThreadCount()-1 threads (the calling thread is the last one), and its threads never expire.  So parallel searches and decimations (MPlotMinMax::search(), MPlotDecimation) don't start and join OS threads every time they run.
+
+run() doesn't use QThreadPool::waitForDone(), which would also wait for other callers' work.  Instead, the calling thread and the pool threads claim parts from a shared counter until there are none left, and the caller waits on a semaphore for the parts that others claimed.  Pool threads that start late find nothing left to claim, so the caller never waits for a part that hasn't started: run() can't deadlock when the pool is busy, or when it is called from a pool thread. */
+class MPLOTSHARED_EXPORT MPlotParallel {
+public:
+	/// Returns the number of threads that run() can use, including the calling thread.  This is QThread::idealThreadCount(), and at least 1.
+	static int threadCount();
+	/// Runs job->runPart() for every part from 0 to \c parts-1, and returns when they are all done.
+	static void run(MPlotParallelJob* job, int parts);
+	/// Returns the shared pool.
+	static QThreadPool* pool();
+};
+
+#endif // MPLOTPARALLEL_H
@@ -0,0 +1,423 @@
+#ifndef MPLOTROLLINGSTATISTICS_CPP
+#define MPLOTROLLINGSTATISTICS_CPP
+
+#include "MPlot/MPlotRollingStatistics.h"
+
+#include <string.h>
+#include <math.h>
+#include <limits>
+
+MPlotRollingStatisticsSeriesData::MPlotRollingStatisticsSeriesData(const MPlotAbstractSeriesData *source, int window, Band band, qreal sigmas)
+	: MPlotAbstractDerivedSeriesData(source)
+{
+	window_ = qMax(1, window);
+	band_ = band;
+	sigmas_ = sigmas;
+
+	clearStatistics();
+	if(source_ && source_->count() > 0)
+		addPoints(0, source_->count()-1);
+}
+
+void MPlotRollingStatisticsSeriesData::setWindow(int window)
+{
+	window = qMax(1, window);
+	if(window == window_)
+		return;
+
+	window_ = window;
+	sourceReset();
+}
+
+void MPlotRollingStatisticsSeriesData::setBand(Band band)
+{
+	if(band == band_)
+		return;
+
+	band_ = band;
+	rebuildPyramid();
+	if(count() > 0)
+		emitValuesChanged(0, count()-1);
+}
+
+void MPlotRollingStatisticsSeriesData::setSigmas(qreal sigmas)
+{
+	if(sigmas == sigmas_)
+		return;
+
+	sigmas_ = sigmas;
+	// (only the standard deviation band depends on it.)
+	if(band_ == StandardDeviationBand) {
+		rebuildPyramid();
+		if(count() > 0)
+			emitValuesChanged(0, count()-1);
+	}
+}
+
+void MPlotRollingStatisticsSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, mean_.constData()+head_+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+qreal MPlotRollingStatisticsSeriesData::lower(int index) const
+{
+	if(band_ == MinMaxBand)
+		return minimum(index);
+	return mean(index) - sigmas_*standardDeviation(index);
+}
+
+qreal MPlotRollingStatisticsSeriesData::upper(int index) const
+{
+	if(band_ == MinMaxBand)
+		return maximum(index);
+	return mean(index) + sigmas_*standardDeviation(index);
+}
+
+QRectF MPlotRollingStatisticsSeriesData::boundingRect() const
+{
+	int count = this->count();
+	if(count == 0 || !source_)
+		return QRectF();
+
+	if(cachedDataRectUpdateRequired_) {
+		// the largest blocks of the pyramid: only a few of them to look at.
+		QVector<MPlotBandSummary> summaries;
+		bandSummaries(0, count-1, count, summaries);
+
+		qreal minY = std::numeric_limits<qreal>::infinity();
+		qreal maxY = -std::numeric_limits<qreal>::infinity();
+		for(int i=0, size=summaries.size(); i<size; ++i) {
+			const MPlotBandSummary& summary = summaries.at(i);
+			minY = qMin(minY, qMin(summary.lower, summary.centerMin));
+			maxY = qMax(maxY, qMax(summary.upper, summary.centerMax));
+		}
+		if(minY > maxY)	// no values at all: same as the search in MPlotAbstractSeriesData::boundingRect().
+			minY = maxY = std::numeric_limits<qreal>::quiet_NaN();
+
+		// the x values are the source's, and so are their bounds.
+		QRectF sourceRect = source_->boundingRect();
+		cachedDataRect_ = QRectF(sourceRect.left(),
+								 minY,
+								 sourceRect.width(),
+								 qMax(maxY-minY, std::numeric_limits<qreal>::min()));
+		cachedDataRectUpdateRequired_ = false;
+	}
+
+	return cachedDataRect_;
+}
+
+void MPlotRollingStatisticsSeriesData::bandSummaries(int first, int last, int pointsPerSummary, QVector<MPlotBandSummary> &summaries) const
+{
+	summaries.clear();
+	first = qMax(0, first);
+	last = qMin(count()-1, last);
+	if(first > last)
+		return;
+
+	// the largest blocks that fit in pointsPerSummary.
+	int level = -1;
+	while(level+1 < MPLOT_ROLLING_PYRAMID_LEVELS && blockSize(level+1) <= pointsPerSummary)
+		++level;
+	qint64 size = level < 0 ? 1 : blockSize(level);
+
+	qint64 absoluteFirst = removed_ + first, absoluteLast = removed_ + last;
+	summaries.reserve(int(absoluteLast/size - absoluteFirst/size + 1));
+
+	for(qint64 block = absoluteFirst/size; block <= absoluteLast/size; ++block) {
+		qint64 blockFirst = qMax(absoluteFirst, block*size);
+		qint64 blockLast = qMin(absoluteLast, (block+1)*size - 1);
+
+		MPlotBandSummary summary;
+		summary.first = int(blockFirst - removed_);
+		summary.count = int(blockLast - blockFirst + 1);
+
+		// whole blocks come straight from the pyramid.  The ones cut by the ends of the range are put together from smaller blocks, and points.
+		Extent extent;
+		if(level >= 0 && blockFirst == block*size && blockLast == (block+1)*size - 1) {
+			const Level& blocks = levels_[level];
+			extent = blocks.extents.at(blocks.head + int(block - blocks.firstBlock));
+		}
+		else {
+			extent.lower = extent.centerMin = std::numeric_limits<qreal>::infinity();
+			extent.upper = extent.centerMax = -std::numeric_limits<qreal>::infinity();
+
+			qint64 point = blockFirst;
+			while(point <= blockLast) {
+				int fit = -1;
+				while(fit+1 < level && point % blockSize(fit+1) == 0 && point + blockSize(fit+1) - 1 <= blockLast)
+					++fit;
+
+				if(fit < 0) {
+					merge(extent, pointExtent(int(point - removed_)));
+					++point;
+				}
+				else {
+					const Level& blocks = levels_[fit];
+					merge(extent, blocks.extents.at(blocks.head + int(point/blockSize(fit) - blocks.firstBlock)));
+					point += blockSize(fit);
+				}
+			}
+		}
+
+		summary.lower = extent.lower;
+		summary.upper = extent.upper;
+		summary.centerMin = extent.centerMin;
+		summary.centerMax = extent.centerMax;
+		summaries << summary;
+	}
+}
+
+void MPlotRollingStatisticsSeriesData::sourceRowsAppended(int first, int last)
+{
+	// out of step with the source?
+	if(first != count()) {
+		sourceReset();
+		return;
+	}
+
+	addPoints(first, last);
+
+	// (the band isn't in the y values, so the base class can't extend the bounds by itself.)
+	cachedDataRectUpdateRequired_ = true;
+	emitRowsAppended(first, last);
+}
+
+void MPlotRollingStatisticsSeriesData::sourceRowsRemovedFront(int count)
+{
+	count = qMin(count, this->count());
+	if(count < 1)
+		return;
+
+	head_ += count;
+	removed_ += count;
+
+	if(MPlotFrontCompactionDue(head_, mean_.size())) {
+		MPlotRemoveFront(mean_, head_);
+		MPlotRemoveFront(sigma_, head_);
+		MPlotRemoveFront(minimum_, head_);
+		MPlotRemoveFront(maximum_, head_);
+		head_ = 0;
+	}
+
+	trimPyramid();
+	emitRowsRemovedFront(count);
+}
+
+void MPlotRollingStatisticsSeriesData::sourceReset()
+{
+	clearStatistics();
+	if(source_ && source_->count() > 0)
+		addPoints(0, source_->count()-1);
+
+	MPlotAbstractDerivedSeriesData::sourceReset();
+}
+
+void MPlotRollingStatisticsSeriesData::addPoints(int first, int last)
+{
+	const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+
+	QVector<qreal> values;
+	for(int start = first; start <= last; start += MPLOT_MINMAX_CHUNK) {
+		int end = qMin(last, start+MPLOT_MINMAX_CHUNK-1);
+		values.resize(end-start+1);
+		source_->yValues(start, end, values.data());
+
+		for(int i=0, size=values.size(); i<size; ++i) {
+			qreal value = values.at(i);
+			int slot = int(processed_ % window_);
+
+			// Welford: remove the value leaving the window, and add the new one.
+			if(processed_ >= window_) {
+				qreal old = windowValues_.at(slot);
+				if(old == old) {
+					if(--windowValid_ == 0) {
+						windowMean_ = 0;
+						windowM2_ = 0;
+					}
+					else {
+						qreal delta = old - windowMean_;
+						windowMean_ -= delta/windowValid_;
+						windowM2_ -= delta*(old - windowMean_);
+					}
+				}
+			}
+			windowValues_[slot] = value;
+			if(value == value) {
+				++windowValid_;
+				qreal delta = value - windowMean_;
+				windowMean_ += delta/windowValid_;
+				windowM2_ += delta*(value - windowMean_);
+			}
+
+			// (NaN values are added as an empty range, so they're never an extreme.)
+			if(value == value)
+				windowExtrema_.append(value);
+			else
+				windowExtrema_.append(infinity, -infinity);
+			windowExtrema_.expireBefore(processed_ - window_ + 1);
+
+			++processed_;
+
+			// once per window, start again from the exact values, so that rounding errors don't add up.
+			if(processed_ % window_ == 0) {
+				windowValid_ = 0;
+				qreal sum = 0;
+				for(int w=0; w<window_; ++w) {
+					if(windowValues_.at(w) == windowValues_.at(w)) {
+						sum += windowValues_.at(w);
+						++windowValid_;
+					}
+				}
+				windowMean_ = windowValid_ ? sum/windowValid_ : 0;
+				windowM2_ = 0;
+				for(int w=0; w<window_; ++w) {
+					qreal delta = windowValues_.at(w) - windowMean_;
+					if(delta == delta)
+						windowM2_ += delta*delta;
+				}
+			}
+
+			bool valid = windowValid_ > 0;
+			mean_ << (valid ? windowMean_ : nan);
+			sigma_ << (valid ? sqrt(qMax(qreal(0), windowM2_)/windowValid_) : nan);
+			minimum_ << (valid ? windowExtrema_.minimum() : nan);
+			maximum_ << (valid ? windowExtrema_.maximum() : nan);
+
+			addToPyramid(count()-1);
+		}
+	}
+}
+
+void MPlotRollingStatisticsSeriesData::clearStatistics()
+{
+	windowValues_ = QVector<qreal>(window_, std::numeric_limits<qreal>::quiet_NaN());
+	processed_ = 0;
+	windowValid_ = 0;
+	windowMean_ = 0;
+	windowM2_ = 0;
+	windowExtrema_.clear();
+
+	mean_.clear();
+	sigma_.clear();
+	minimum_.clear();
+	maximum_.clear();
+	head_ = 0;
+	removed_ = 0;
+
+	for(int level=0; level<MPLOT_ROLLING_PYRAMID_LEVELS; ++level) {
+		levels_[level].extents.clear();
+		levels_[level].head = 0;
+		levels_[level].firstBlock = 0;
+	}
+	cachedDataRectUpdateRequired_ = true;
+}
+
+MPlotRollingStatisticsSeriesData::Extent MPlotRollingStatisticsSeriesData::pointExtent(int index) const
+{
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	qreal low = lower(index), high = upper(index), center = mean(index);
+
+	// NaN values make an empty extent.
+	Extent extent;
+	extent.lower = low == low ? low : infinity;
+	extent.upper = high == high ? high : -infinity;
+	extent.centerMin = center == center ? center : infinity;
+	extent.centerMax = center == center ? center : -infinity;
+	return extent;
+}
+
+void MPlotRollingStatisticsSeriesData::merge(Extent &into, const Extent &extent)
+{
+	into.lower = qMin(into.lower, extent.lower);
+	into.upper = qMax(into.upper, extent.upper);
+	into.centerMin = qMin(into.centerMin, extent.centerMin);
+	into.centerMax = qMax(into.centerMax, extent.centerMax);
+}
+
+qint64 MPlotRollingStatisticsSeriesData::blockSize(int level)
+{
+	qint64 size = MPLOT_ROLLING_PYRAMID_FACTOR;
+	for(int i=0; i<level; ++i)
+		size *= MPLOT_ROLLING_PYRAMID_FACTOR;
+	return size;
+}
+
+void MPlotRollingStatisticsSeriesData::addToPyramid(int index)
+{
+	Extent extent = pointExtent(index);
+	qint64 point = removed_ + index;
+
+	for(int level=0; level<MPLOT_ROLLING_PYRAMID_LEVELS; ++level) {
+		Level& blocks = levels_[level];
+		qint64 block = point/blockSize(level);
+		int size = blocks.extents.size() - blocks.head;
+
+		if(size > 0 && block == blocks.firstBlock + size - 1)
+			merge(blocks.extents.last(), extent);
+		else {
+			if(size == 0) {
+				blocks.extents.clear();
+				blocks.head = 0;
+				blocks.firstBlock = block;
+			}
+			blocks.extents << extent;
+		}
+	}
+}
+
+void MPlotRollingStatisticsSeriesData::rebuildPyramid()
+{
+	for(int level=0; level<MPLOT_ROLLING_PYRAMID_LEVELS; ++level) {
+		levels_[level].extents.clear();
+		levels_[level].head = 0;
+		levels_[level].firstBlock = 0;
+	}
+
+	for(int i=0, count=this->count(); i<count; ++i)
+		addToPyramid(i);
+	cachedDataRectUpdateRequired_ = true;
+}
+
+void MPlotRollingStatisticsSeriesData::trimPyramid()
+{
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	int count = this->count();
+
+	for(int level=0; level<MPLOT_ROLLING_PYRAMID_LEVELS; ++level) {
+		Level& blocks = levels_[level];
+		qint64 size = blockSize(level);
+
+		int dropped = int(qMin(qint64(blocks.extents.size() - blocks.head), removed_/size - blocks.firstBlock));
+		blocks.head += dropped;
+		blocks.firstBlock += dropped;
+		if(blocks.head == blocks.extents.size() || count == 0) {
+			blocks.extents.clear();
+			blocks.head = 0;
+			continue;
+		}
+		if(blocks.head >= 64 && 2*blocks.head >= blocks.extents.size()) {
+			blocks.extents.remove(0, blocks.head);
+			blocks.head = 0;
+		}
+
+		// the first block lost its first points: put it together again from what's left of it, in the level below.
+		Extent& extent = blocks.extents[blocks.head];
+		extent.lower = extent.centerMin = infinity;
+		extent.upper = extent.centerMax = -infinity;
+		qint64 end = (blocks.firstBlock+1)*size;	// first point after the block
+
+		if(level == 0) {
+			for(qint64 point = removed_; point < end && point - removed_ < count; ++point)
+				merge(extent, pointExtent(int(point - removed_)));
+		}
+		else {
+			const Level& below = levels_[level-1];
+			qint64 belowEnd = end/blockSize(level-1);
+			for(qint64 block = below.firstBlock; block < belowEnd && below.head + block - below.firstBlock < below.extents.size(); ++block)
+				merge(extent, below.extents.at(below.head + int(block - below.firstBlock)));
+		}
+	}
+}
+
+#endif // MPLOTROLLINGSTATISTICS_CPP
@@ -0,0 +1,148 @@
+#ifndef MPLOTROLLINGSTATISTICS_H
+#define MPLOTROLLINGSTATISTICS_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotDerivedSeriesData.h"
+#include "MPlot/MPlotSlidingExtrema.h"
+
+#include <QVector>
+
+/// The default number of points an MPlotRollingStatisticsSeriesData computes its statistics over.
+#define MPLOT_ROLLING_DEFAULT_WINDOW 100
+/// Each level of the MPlotRollingStatisticsSeriesData summary pyramid summarizes this many blocks of the level below.
+#define MPLOT_ROLLING_PYRAMID_FACTOR 16
+/// The number of levels in the summary pyramid: the top level has one summary per MPLOT_ROLLING_PYRAMID_FACTOR^MPLOT_ROLLING_PYRAMID_LEVELS points.
+#define MPLOT_ROLLING_PYRAMID_LEVELS 6
+
+/// Summary of the band and center line of MPlotRollingStatisticsSeriesData over consecutive points.  See MPlotRollingStatisticsSeriesData::bandSummaries().
+struct MPLOTSHARED_EXPORT MPlotBandSummary {
+	/// Index of the first point, and number of points.
+	int first, count;
+	/// Lowest lower edge and highest upper edge of the band.  (lower > upper if none of the points has a band.)
+	qreal lower, upper;
+	/// Extremes of the center line.  (centerMin > centerMax if none of the points has a center.)
+	qreal centerMin, centerMax;
+};
+
+
+/// This class computes rolling statistics of its source's y values, updated incrementally as points are appended: the mean, standard deviation, minimum and maximum over the last window() points.
+/*! The y values of this data are the rolling means (the center line), and its x values are the source's.  band() chooses the band drawn around them by MPlotSeriesBand: the mean ± sigmas() standard deviations, or the rolling minimum and maximum.
+
+The mean and standard deviation are kept with Welford's algorithm (adding the new value and removing the one leaving the window), and recomputed exactly once per window to stop rounding errors from adding up.  The minimum and maximum are kept with MPlotSlidingExtrema.  So each appended point costs constant time, whatever the window.  NaN values are left out.  The standard deviation is the population one (dividing by the number of values).
+
+The statistics are also summarized in a pyramid of blocks of MPLOT_ROLLING_PYRAMID_FACTOR, MPLOT_ROLLING_PYRAMID_FACTOR^2, ... points, kept up to date on append, so that bandSummaries() can describe any range with about as many summaries as there are pixel columns to draw.
+
+Points removed from the front of the source are removed here too; the statistics of the other points don't change.  Any other change to the source (values changed, or replaced) restarts the statistics from the beginning of the source. */
+class MPLOTSHARED_EXPORT MPlotRollingStatisticsSeriesData : public MPlotAbstractDerivedSeriesData {
+
+public:
+	/// The bands that can be drawn around the mean.
+	enum Band { StandardDeviationBand, MinMaxBand };
+
+	/// Constructor. Computes the statistics of \c source over \c window points, with \c band around the mean (\c sigmas standard deviations wide, for StandardDeviationBand).
+	MPlotRollingStatisticsSeriesData(const MPlotAbstractSeriesData* source = 0, int window = MPLOT_ROLLING_DEFAULT_WINDOW, Band band = StandardDeviationBand, qreal sigmas = 2);
+
+	/// Returns the number of points the statistics are computed over.
+	int window() const { return window_; }
+	/// Sets the number of points the statistics are computed over.  Restarts the statistics.
+	void setWindow(int window);
+	/// Returns the band around the mean.
+	Band band() const { return band_; }
+	/// Sets the band around the mean.
+	void setBand(Band band);
+	/// Returns the half-width of a StandardDeviationBand, in standard deviations.
+	qreal sigmas() const { return sigmas_; }
+	/// Sets the half-width of a StandardDeviationBand, in standard deviations.
+	void setSigmas(qreal sigmas);
+
+	/// Returns the x value at \c index: the source's.
+	virtual qreal x(unsigned index) const { return source_->x(index); }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues: the source's.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const { source_->xValues(indexStart, indexEnd, outputValues); }
+	/// Returns the rolling mean at \c index.
+	virtual qreal y(unsigned index) const { return mean_.at(head_+index); }
+	/// Copies the rolling means from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points.
+	virtual int count() const { return mean_.size() - head_; }
+	/// Re-implemented to include the band, from the top of the summary pyramid.
+	virtual QRectF boundingRect() const;
+
+	/// Returns the rolling mean at \c index (NaN if the window only has NaN values).
+	qreal mean(int index) const { return mean_.at(head_+index); }
+	/// Returns the rolling standard deviation at \c index.
+	qreal standardDeviation(int index) const { return sigma_.at(head_+index); }
+	/// Returns the rolling minimum at \c index.
+	qreal minimum(int index) const { return minimum_.at(head_+index); }
+	/// Returns the rolling maximum at \c index.
+	qreal maximum(int index) const { return maximum_.at(head_+index); }
+	/// Returns the lower edge of the band at \c index.
+	qreal lower(int index) const;
+	/// Returns the upper edge of the band at \c index.
+	qreal upper(int index) const;
+
+	/// Fills \c summaries with consecutive summaries of points \c first to \c last, each one covering at most \c pointsPerSummary points (and at least 1).  They are blocks of the pyramid, clipped to the range, so there are about (last-first+1)/pointsPerSummary of them.
+	void bandSummaries(int first, int last, int pointsPerSummary, QVector<MPlotBandSummary>& summaries) const;
+
+protected:
+	/// Re-implemented to extend the statistics.
+	virtual void sourceRowsAppended(int first, int last);
+	/// Re-implemented to keep the statistics of the other points.
+	virtual void sourceRowsRemovedFront(int count);
+	/// Re-implemented to restart the statistics.
+	virtual void sourceReset();
+
+	/// The extents of the band and center line over a block of points.
+	struct Extent {
+		qreal lower, upper, centerMin, centerMax;
+	};
+	/// One level of the summary pyramid: the extents of consecutive blocks, starting with block number firstBlock (counting from the first point ever appended) at index head.
+	struct Level {
+		QVector<Extent> extents;
+		int head;
+		qint64 firstBlock;
+	};
+
+	/// Runs the statistics over source points \c first to \c last, and appends the results.
+	void addPoints(int first, int last);
+	/// Throws away all the results and the state of the statistics.
+	void clearStatistics();
+	/// Returns the extent of point \c index.
+	Extent pointExtent(int index) const;
+	/// Adds \c extent to \c into.
+	static void merge(Extent& into, const Extent& extent);
+	/// Returns the number of points in each block of pyramid level \c level.
+	static qint64 blockSize(int level);
+	/// Adds point \c index (which was just appended) to the pyramid.
+	void addToPyramid(int index);
+	/// Builds the pyramid again from the results, after the band changed.
+	void rebuildPyramid();
+	/// Drops the blocks before the first point from the pyramid, and recomputes the first block of each level, which might have lost points.
+	void trimPyramid();
+
+	/// Statistics parameters.
+	int window_;
+	Band band_;
+	qreal sigmas_;
+
+	/// The last window_ values, in a ring indexed by processed_ % window_.
+	QVector<qreal> windowValues_;
+	/// Number of values processed since the statistics started.
+	qint64 processed_;
+	/// Number of non-NaN values in the window, their mean, and the sum of their squared differences from it (Welford's M2).
+	int windowValid_;
+	qreal windowMean_, windowM2_;
+	/// Minimum and maximum of the window.
+	MPlotSlidingExtrema windowExtrema_;
+
+	/// Results for each point, starting at head_.
+	QVector<qreal> mean_, sigma_, minimum_, maximum_;
+	int head_;
+	/// Number of points removed from the front since the statistics started.
+	qint64 removed_;
+
+	/// The summary pyramid. Level k has blocks of MPLOT_ROLLING_PYRAMID_FACTOR^(k+1) points.
+	Level levels_[MPLOT_ROLLING_PYRAMID_LEVELS];
+};
+
+#endif // MPLOTROLLINGSTATISTICS_H
@@ -0,0 +1,116 @@
+#ifndef MPLOTSCROLLINGIMAGEDATA_CPP
+#define MPLOTSCROLLINGIMAGEDATA_CPP
+
+#include "MPlot/MPlotScrollingImageData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <limits>
+
+MPlotScrollingImageData::MPlotScrollingImageData(const QRectF &dataBounds, int rowLength, int historyRows)
+	: MPlotAbstractImageData(),
+	  size_(qMax(1, rowLength), qMax(1, historyRows)),
+	  bounds_(dataBounds)
+{
+	clear();
+}
+
+void MPlotScrollingImageData::clear()
+{
+	d_.fill(0, size_.width()*size_.height());
+	oldestRow_ = 0;
+
+	// every row starts out as zeros.
+	extrema_.clear();
+	for(int i=0; i<size_.height(); ++i)
+		extrema_.append(0);
+
+	emitDataChanged();
+}
+
+void MPlotScrollingImageData::appendRows(const qreal *values, int rowCount)
+{
+	if(rowCount < 1)
+		return;
+
+	int width = size_.width();
+	int height = size_.height();
+
+	// if there are more new rows than we keep, only the newest ones matter.
+	if(rowCount > height) {
+		values += (rowCount-height)*width;
+		rowCount = height;
+	}
+
+	for(int r=0; r<rowCount; ++r) {
+		const qreal* newRow = values + r*width;
+
+		// the oldest row's slot becomes the newest row.
+		memcpy(d_.data() + oldestRow_*width, newRow, width*sizeof(qreal));
+		oldestRow_ = (oldestRow_+1) % height;
+
+		// NaN values are skipped; a row with nothing else contributes an empty range, which never becomes the extreme.
+		MPlotMinMax rowRange;
+		rowRange.add(newRow, width);
+		if(rowRange.isValid())
+			extrema_.append(rowRange.minimum(), rowRange.maximum());
+		else
+			extrema_.append(std::numeric_limits<qreal>::infinity(), -std::numeric_limits<qreal>::infinity());
+	}
+
+	extrema_.expireBefore(extrema_.appendedCount() - height);
+
+	emitRowsScrolled(rowCount);
+}
+
+qreal MPlotScrollingImageData::x(int indexX) const
+{
+	return bounds_.left() + bounds_.width()*indexX/size_.width();
+}
+
+qreal MPlotScrollingImageData::y(int indexY) const
+{
+	return bounds_.top() + bounds_.height()*indexY/size_.height();
+}
+
+qreal MPlotScrollingImageData::z(int indexX, int indexY) const
+{
+	return row(indexY)[indexX];
+}
+
+void MPlotScrollingImageData::zValues(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	for(int xx=xStart; xx<=xEnd; ++xx)
+		for(int yy=yStart; yy<=yEnd; ++yy)
+			*(outputValues++) = row(yy)[xx];
+}
+
+void MPlotScrollingImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int rowLength = xEnd-xStart+1;
+
+	for(int yy=yStart; yy<=yEnd; ++yy) {
+		memcpy(outputValues, row(yy)+xStart, rowLength*sizeof(qreal));
+		outputValues += rowLength;
+	}
+}
+
+QPoint MPlotScrollingImageData::count() const
+{
+	return QPoint(size_.width(), size_.height());
+}
+
+QRectF MPlotScrollingImageData::boundingRect() const
+{
+	return bounds_;
+}
+
+MPlotInterval MPlotScrollingImageData::range() const
+{
+	// (only NaN in the whole history: NaN, like the MPlotMinMax search of the other image data.)
+	if(extrema_.minimum() > extrema_.maximum())
+		return MPlotInterval(std::numeric_limits<qreal>::quiet_NaN(), std::numeric_limits<qreal>::quiet_NaN());
+
+	return MPlotInterval(extrema_.minimum(), extrema_.maximum());
+}
+
+#endif // MPLOTSCROLLINGIMAGEDATA_CPP
@@ -0,0 +1,70 @@
+#ifndef MPLOTSCROLLINGIMAGEDATA_H
+#define MPLOTSCROLLINGIMAGEDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotImageData.h"
+#include "MPlot/MPlotSlidingExtrema.h"
+
+/// This class implements MPlotAbstractImageData as a fixed-size history of rows, for live spectrograms and waterfall plots.
+/*! The data is rowLength() values wide (x) and historyRows() rows high (y).  Row 0 is the oldest, and row historyRows()-1 is the newest.  Appending a row drops the oldest one.
+
+The rows are stored in a ring buffer, so appending costs the same no matter how deep the history is: only the new row is copied.  Appending emits rowsScrolled() (followed by dataChanged()), which lets MPlotScrollingImageBasic colorize just the new rows.
+
+The range() is tracked incrementally: the minimum and maximum of each row are kept in an MPlotSlidingExtrema, and expire with their row.  NaN values are skipped, as in MPlotMinMax.
+
+Initially, all values are 0.
+*/
+class MPLOTSHARED_EXPORT MPlotScrollingImageData : public MPlotAbstractImageData {
+
+public:
+	/// Constructor: represent \c historyRows rows of \c rowLength values each, with physical coordinate boundaries \c dataBounds.
+	MPlotScrollingImageData(const QRectF& dataBounds, int rowLength, int historyRows);
+
+	/// Return the x (independent data value) corresponding to \c indexX.
+	virtual qreal x(int indexX) const;
+	/// Return the y (independendent data value) corresponding to \c indexY.
+	virtual qreal y(int indexY) const;
+	/// Return the z = f(x,y) dependent data value corresponding (\c indexX, \c indexY). Can assume (\c indexX, \c indexY) are valid.
+	virtual qreal z(int indexX, int indexY) const;
+
+	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues, with the x-axis varying the slowest.
+	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to copy straight out of the ring buffer, one row at a time.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+
+	/// Return the number of elements in x and y
+	virtual QPoint count() const;
+	/// Return the bounds of the data (the rectangle containing the max/min x- and y-values)
+	virtual QRectF boundingRect() const;
+	/// Return the minimum and maximum z values over the whole history. This is always up to date, without searching.
+	virtual MPlotInterval range() const;
+
+	/// Returns the number of values in each row.
+	int rowLength() const { return size_.width(); }
+	/// Returns the number of rows kept.
+	int historyRows() const { return size_.height(); }
+
+	/// Append a row of rowLength() \c values as the newest row, dropping the oldest row.
+	void appendRow(const qreal* values) { appendRows(values, 1); }
+	/// Append \c rowCount rows of rowLength() \c values each (oldest first), dropping the same number of the oldest rows.  Emits rowsScrolled() and dataChanged() once.
+	void appendRows(const qreal* values, int rowCount);
+	/// Reset all the values to 0.
+	void clear();
+
+protected:
+	/// Number of values in x (row length) and y (history rows).
+	QSize size_;
+	/// the (min/max) (x/y) values, in physical(data) coordinates. bounds_.upperLeft is == (minX, minY)
+	QRectF bounds_;
+	/// The ring buffer of rows. Row y is stored at ring position (oldestRow_+y) % historyRows().
+	QVector<qreal> d_;
+	/// Ring position of row 0 (the oldest row).
+	int oldestRow_;
+	/// Minimum and maximum of each row in the history.
+	MPlotSlidingExtrema extrema_;
+
+	/// Returns a pointer to the start of row \c indexY.
+	const qreal* row(int indexY) const { return d_.constData() + ((oldestRow_+indexY) % size_.height())*size_.width(); }
+};
+
+#endif // MPLOTSCROLLINGIMAGEDATA_H
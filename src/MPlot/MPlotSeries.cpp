@@ -2,6 +2,7 @@
 #define __MPlotSeries_CPP__
 
 #include "MPlot/MPlotSeries.h"
+#include "MPlot/MPlotSharedXSeriesTable.h"
 #include <QPainter>
 #include <QDebug>
 
@@ -14,6 +15,22 @@ void MPlotSeriesSignalHandler::onDataChanged() {
 	series_->onDataChangedPrivate();
 }
 
+void MPlotSeriesSignalHandler::onRowsAppended(int first, int last) {
+	series_->onRowsAppendedPrivate(first, last);
+}
+
+void MPlotSeriesSignalHandler::onRowsRemovedFront(int count) {
+	series_->onRowsRemovedFrontPrivate(count);
+}
+
+void MPlotSeriesSignalHandler::onValuesChanged(int first, int last) {
+	series_->onValuesChangedPrivate(first, last);
+}
+
+void MPlotSeriesSignalHandler::onDataReset() {
+	// nothing to keep: the dataChanged() that follows throws away the coordinate cache.
+}
+
 MPlotAbstractSeries::MPlotAbstractSeries() :
 	MPlotItem()
 {
@@ -35,6 +52,10 @@ MPlotAbstractSeries::MPlotAbstractSeries() :
 
 	signalHandler_ = new MPlotSeriesSignalHandler(this);
 
+	changeDescribed_ = false;
+	invalidateCoordinateCache();
+	for(int i=0; i<8; ++i)
+		cachedMapping_[i] = std::numeric_limits<qreal>::quiet_NaN();
 }
 
 MPlotAbstractSeries::~MPlotAbstractSeries() {
@@ -94,11 +115,17 @@ void MPlotAbstractSeries::setModel(const MPlotAbstractSeriesData* data, bool own
 	ownsModel_ = ownsModel;
 
 	dataChangedUpdateNeeded_ = true;
+	changeDescribed_ = false;
+	invalidateCoordinateCache();
 	prepareGeometryChange();
 
 	// If there's a new valid model:
 	if(data_) {
 		QObject::connect(data_->signalSource(), SIGNAL(dataChanged()), signalHandler_, SLOT(onDataChanged()));
+		QObject::connect(data_->signalSource(), SIGNAL(rowsAppended(int,int)), signalHandler_, SLOT(onRowsAppended(int,int)));
+		QObject::connect(data_->signalSource(), SIGNAL(rowsRemovedFront(int)), signalHandler_, SLOT(onRowsRemovedFront(int)));
+		QObject::connect(data_->signalSource(), SIGNAL(valuesChanged(int,int)), signalHandler_, SLOT(onValuesChanged(int,int)));
+		QObject::connect(data_->signalSource(), SIGNAL(dataReset()), signalHandler_, SLOT(onDataReset()));
 	}
 
 	emitBoundsChanged();
@@ -130,6 +157,51 @@ void MPlotAbstractSeries::yyValues(unsigned start, unsigned end, qreal *outputVa
 		outputValues[i] = y.at(i)*sy_ + dy_ + offset;
 }
 
+bool MPlotAbstractSeries::uniformDrawingX(qreal &mappedX0, qreal &mappedDX) const
+{
+	qreal x0, dx;
+	if(!data_ || !data_->uniformXSpacing(x0, dx) || xAxisTarget()->logScaleInEffect())
+		return false;
+
+	// the transform and the (linear) axis mapping keep the spacing uniform.
+	qreal transformedX0 = x0*sx_ + dx_ + offset_.x();
+	mappedX0 = mapX(transformedX0);
+	mappedDX = mapX(transformedX0 + dx*sx_) - mappedX0;
+
+	return mappedDX != 0;
+}
+
+bool MPlotAbstractSeries::visibleIndexRange(qreal mappedX0, qreal mappedDX, int &first, int &last) const
+{
+	int dataCount = data_->count();
+	qreal width = xAxisTarget()->drawingSize().width();
+
+	// with a negative spacing, the right edge is reached first.
+	qreal lowIndex = ((mappedDX > 0 ? 0 : width) - mappedX0)/mappedDX;
+	qreal highIndex = ((mappedDX > 0 ? width : 0) - mappedX0)/mappedDX;
+
+	if(dataCount == 0 || highIndex < 0 || lowIndex > dataCount-1)
+		return false;
+
+	first = int(qMax(qreal(0), floor(lowIndex)-1));
+	last = int(qMin(qreal(dataCount-1), ceil(highIndex)+1));
+	return true;
+}
+
+const qreal* MPlotAbstractSeries::visibleMappedY(int first, int last, QVector<qreal> &buffer) const
+{
+	if(yAxisTarget()->logScaleInEffect()) {
+		updateCoordinateCache(false);
+		return mappedY_.constData()+first;
+	}
+
+	int visibleCount = last-first+1;
+	buffer.resize(visibleCount);
+	yyValues(first, last, buffer.data());
+	mapYValues(visibleCount, buffer.constData(), buffer.data());
+	return buffer.constData();
+}
+
 // Required functions:
 //////////////////////////
 
@@ -174,18 +246,9 @@ QPainterPath MPlotAbstractSeries::shape() const {
 
 	else if (data_ && data_->count() > 0){
 
-		int dataCount = data_->count();
-		QVector<qreal> x = QVector<qreal>(dataCount);
-		QVector<qreal> y = QVector<qreal>(dataCount);
-
-		xxValues(0, dataCount-1, x.data());
-		yyValues(0, dataCount-1, y.data());
-
-		QVector<qreal> mappedX = QVector<qreal>(dataCount);
-		QVector<qreal> mappedY = QVector<qreal>(dataCount);
-
-		mapXValues(mappedX.size(), x.constData(), mappedX.data());
-		mapYValues(mappedY.size(), y.constData(), mappedY.data());
+		updateCoordinateCache();
+		const QVector<qreal>& mappedX = mappedX_;
+		const QVector<qreal>& mappedY = mappedY_;
 
 		shape.moveTo(mappedX.at(0), mappedY.at(0));
 
@@ -202,6 +265,11 @@ QPainterPath MPlotAbstractSeries::shape() const {
 }
 
 void	MPlotAbstractSeries::onDataChangedPrivate() {
+	// unless the model told us exactly what changed, none of the cached coordinates can be trusted.
+	if(!changeDescribed_)
+		invalidateCoordinateCache();
+	changeDescribed_ = false;
+
 	// flag cached bounding rect as dirty:
 	dataChangedUpdateNeeded_ = true;
 	// warn that bounding rect is going to change:
@@ -213,6 +281,190 @@ void	MPlotAbstractSeries::onDataChangedPrivate() {
 	onDataChanged();
 }
 
+void MPlotAbstractSeries::onRowsAppendedPrivate(int first, int last) {
+	// points past the end of the cache are added by the next updateCoordinateCache(). Only an append that overlaps the cache needs to be redone.
+	if(first < transformedY_.size())
+		onValuesChangedPrivate(first, qMin(last, transformedY_.size()-1));
+	changeDescribed_ = true;
+}
+
+void MPlotAbstractSeries::onRowsRemovedFrontPrivate(int count) {
+	int removed = qMin(count, transformedY_.size());
+	// shared x values are taken from the model's cache again by updateCoordinateCache(): removing them here would only copy them.
+	// (the x values can also be out of the cache altogether: see updateCoordinateCache().)
+	if(data_->sharedXCache() || transformedX_.size() != transformedY_.size()) {
+		transformedX_.clear();
+		logX_.clear();
+		mappedX_.clear();
+	}
+	else {
+		transformedX_.remove(0, removed);
+		mappedX_.remove(0, removed);
+		if(logX_.size() == transformedY_.size())
+			logX_.remove(0, removed);
+		else
+			logX_.clear();
+	}
+	if(logY_.size() == transformedY_.size())
+		logY_.remove(0, removed);
+	else
+		logY_.clear();
+	transformedY_.remove(0, removed);
+	mappedY_.remove(0, removed);
+
+	if(dirtyFirst_ <= dirtyLast_) {
+		dirtyFirst_ = qMax(0, dirtyFirst_-count);
+		dirtyLast_ -= count;
+	}
+	changeDescribed_ = true;
+}
+
+void MPlotAbstractSeries::onValuesChangedPrivate(int first, int last) {
+	if(dirtyFirst_ > dirtyLast_) {
+		dirtyFirst_ = first;
+		dirtyLast_ = last;
+	}
+	else {
+		dirtyFirst_ = qMin(dirtyFirst_, first);
+		dirtyLast_ = qMax(dirtyLast_, last);
+	}
+	changeDescribed_ = true;
+}
+
+void MPlotAbstractSeries::invalidateCoordinateCache() const {
+	transformedX_.clear();
+	transformedY_.clear();
+	logX_.clear();
+	logY_.clear();
+	mappedX_.clear();
+	mappedY_.clear();
+	dirtyFirst_ = 0;
+	dirtyLast_ = -1;
+}
+
+void MPlotAbstractSeries::updateCoordinateCache(bool withX) const {
+
+	int count = data_->count();
+	// x values shared with other series are done separately, at the end.
+	MPlotSharedXCache* sharedX = data_->sharedXCache();
+
+	// a new transform (ex: from re-normalization) changes every point. So does losing points we weren't told about.
+	QTransform transform = completeTransform();
+	if(transform != cachedTransform_ || transformedY_.size() > count) {
+		invalidateCoordinateCache();
+		cachedTransform_ = transform;
+	}
+
+	// a change in an axis scale changes every drawing coordinate on that axis.
+	qreal mapping[8] = {	xAxisTarget()->min(), xAxisTarget()->max(), xAxisTarget()->drawingLength(), qreal(xAxisTarget()->logScaleInEffect()),
+							yAxisTarget()->min(), yAxisTarget()->max(), yAxisTarget()->drawingLength(), qreal(yAxisTarget()->logScaleInEffect()) };
+	bool mappingChanged[2] = { false, false };
+	for(int i=0; i<8; ++i) {
+		if(mapping[i] != cachedMapping_[i])
+			mappingChanged[i/4] = true;
+		cachedMapping_[i] = mapping[i];
+	}
+
+	if(withX && !sharedX)
+		updateAxisCache(Qt::Horizontal, dirtyFirst_, dirtyLast_, mappingChanged[0], transformedX_, logX_, mappedX_);
+	else {
+		// not kept: without the changes since, they can't be brought up to date later.
+		transformedX_.clear();
+		logX_.clear();
+		mappedX_.clear();
+	}
+	updateAxisCache(Qt::Vertical, dirtyFirst_, dirtyLast_, mappingChanged[1], transformedY_, logY_, mappedY_);
+
+	// the first series to draw these x values with this x transform and axis scale maps them; the others share its vectors.  (The model keeps the cache in step with its x values.)
+	if(withX && sharedX) {
+		qreal key[MPLOT_SHARED_X_KEY_SIZE] = { sx_, dx_, offset_.x(), mapping[0], mapping[1], mapping[2], mapping[3] };
+		MPlotSharedXCache::Entry& entry = sharedX->entry(key);
+
+		int shared = entry.mappedX.size();
+		if(shared > count) {
+			entry.transformedX.clear();
+			entry.mappedX.clear();
+			shared = 0;
+		}
+		if(count > shared) {
+			entry.transformedX.resize(count);
+			entry.mappedX.resize(count);
+			xxValues(shared, count-1, entry.transformedX.data()+shared);
+			mapXValues(count-shared, entry.transformedX.constData()+shared, entry.mappedX.data()+shared);
+		}
+
+		transformedX_ = entry.transformedX;
+		mappedX_ = entry.mappedX;
+	}
+
+	dirtyFirst_ = 0;
+	dirtyLast_ = -1;
+}
+
+void MPlotAbstractSeries::updateAxisCache(Qt::Orientation axis, int first, int last, bool remap, QVector<qreal> &transformed, QVector<qreal> &logs, QVector<qreal> &mapped) const
+{
+	int count = data_->count();
+	const MPlotAxisMapping& mapping = (axis == Qt::Horizontal ? xAxisTarget() : yAxisTarget())->mapping();
+
+	// (an axis that wasn't kept starts again from nothing.)
+	int cached = transformed.size();
+	if(cached > count) {
+		transformed.clear();
+		cached = 0;
+	}
+	last = qMin(last, cached-1);
+
+	// transform the points that changed, and the new points at the end.
+	if(first <= last) {
+		if(axis == Qt::Horizontal)
+			xxValues(first, last, transformed.data()+first);
+		else
+			yyValues(first, last, transformed.data()+first);
+	}
+	if(count > cached) {
+		transformed.resize(count);
+		if(axis == Qt::Horizontal)
+			xxValues(cached, count-1, transformed.data()+cached);
+		else
+			yyValues(cached, count-1, transformed.data()+cached);
+	}
+
+	// on a log axis, the logarithms of the same points: they don't depend on the range, so they are only redone when the values change, or when the axis becomes logarithmic.
+	const qreal* mappingInput = transformed.constData();
+	if(mapping.logScale()) {
+		if(logs.size() != cached) {
+			logs.resize(count);
+			mapping.transformValues(count, transformed.constData(), logs.data());
+			remap = true;
+		}
+		else {
+			if(first <= last)
+				mapping.transformValues(last-first+1, transformed.constData()+first, logs.data()+first);
+			if(count > cached) {
+				logs.resize(count);
+				mapping.transformValues(count-cached, transformed.constData()+cached, logs.data()+cached);
+			}
+		}
+		mappingInput = logs.constData();
+	}
+	else
+		logs.clear();
+
+	// map everything if the axis scale changed; otherwise, only what was transformed.
+	if(remap || mapped.size() != cached) {
+		mapped.resize(count);
+		mapping.mapTransformedValues(count, mappingInput, mapped.data());
+	}
+	else {
+		if(first <= last)
+			mapping.mapTransformedValues(last-first+1, mappingInput+first, mapped.data()+first);
+		if(count > cached) {
+			mapped.resize(count);
+			mapping.mapTransformedValues(count-cached, mappingInput+cached, mapped.data()+cached);
+		}
+	}
+}
+
 void MPlotAbstractSeries::setDefaults() {
 
 	setLinePen(QPen(QColor(Qt::red)));	// Red solid lines on plot
@@ -355,18 +607,21 @@ void MPlotSeriesBasic::paintLines(QPainter* painter) {
 		QTransform wt = painter->deviceTransform();	// equivalent to worldTransform and combinedTransform
 		qreal xinc = 1.0 / wt.m11() / MPLOT_MAX_LINES_PER_PIXEL;	// will just be 1/MPLOT_MAX_LINES_PER_PIXEL = 0.5 as long as not using a scaled/transformed painter.
 
-		int dataCount = data_->count();
-		QVector<qreal> x = QVector<qreal>(dataCount);
-		QVector<qreal> y = QVector<qreal>(dataCount);
-
-		xxValues(0, dataCount-1, x.data());
-		yyValues(0, dataCount-1, y.data());
+		// uniformly-spaced x values: no need to fetch or map them at all.
+		qreal mappedX0, mappedDX;
+		if(uniformDrawingX(mappedX0, mappedDX)) {
+			paintUniformLines(painter, mappedX0, mappedDX, xinc);
+			return;
+		}
 
-		QVector<qreal> mappedX = QVector<qreal>(dataCount);
-		QVector<qreal> mappedY = QVector<qreal>(dataCount);
+		// models that summarize their points in blocks: dense blocks are drawn without reading their points.
+		if(data_->count() >= xAxisTarget()->drawingSize().width()/xinc && paintSummaryLines(painter, xinc))
+			return;
 
-		mapXValues(mappedX.size(), x.constData(), mappedX.data());
-		mapYValues(mappedY.size(), y.constData(), mappedY.data());
+		// only the points that changed since the last paint need to be transformed and mapped.
+		updateCoordinateCache();
+		const QVector<qreal>& mappedX = mappedX_;
+		const QVector<qreal>& mappedY = mappedY_;
 
 		// should we just draw normally and quickly? Do that if the number of data points is less than the number of x-pixels in the drawing space (or half-pixels, in the conservative case where MPLOT_MAX_LINES_PER_PIXEL = 2).
 		if(data_->count() < xAxisTarget()->drawingSize().width()/xinc) {
@@ -375,63 +630,189 @@ void MPlotSeriesBasic::paintLines(QPainter* painter) {
 				painter->drawLine(QPointF(mappedX.at(i-1), mappedY.at(i-1)), QPointF(mappedX.at(i), mappedY.at(i)));
 		}
 
-		else {	// do sub-pixel simplification.
-			// Instead of drawing lines between all these data points, we'll just plot the max and min value within every xinc range.  This ensures that if there is noise/jumps within a subsample (xinc) range, we'll still see it on the plot.
-
-			qreal xstart;
-			qreal ystart, ymin, ymax;
-
-			xstart = mappedX.at(0);
-			ymin = ymax = ystart = mappedY.at(0);
-
-			// move through the datapoints along x. (Note that x could be jumping forward or backward here... it's not necessarily sorted)
-			for(int i=1, count = data_->count(); i < count; i++) {
-
-				// if within the range around xstart: update max/min to be representative of this range
-				if(fabs(mappedX.at(i) - xstart) < xinc) {
-					qreal mappedYYI = mappedY.at(i);
-
-					if(mappedYYI > ymax)
-						ymax = mappedYYI;
-					if(mappedYYI < ymin)
-						ymin = mappedYYI;
-				}
-				// otherwise draw the lines and move on to next range...
-				// The first line represents everything within the range [xstart, xstart+xinc).  Note that these will all be plotted at same x-pixel.
-				// The second line connects this range to the next.  Note that (if the x-axis point spacing is not uniform) x(i) may be many pixels from xstart, to the left or right. All we know is that it's outside of our 1px range. If it _is_ far outside the range, to get the slope of the connecting line correct, we need to connect it to the last point preceding it. The point (x_(i-1), y_(i-1)) is within the 1px range [xstart, x_(i-1)] represented by the vertical line.
-				// (Brain hurt? imagine a simple example: (0,2) (0,1) (0,0), (5,0).  It should be a vertical line from (0,2) to (0,0), and then a horizontal line from (0,0) to (5,0).  The xinc range is from i=0 (xstart = x(0)) to i=2. The point outside is i=3.
-				// For normal/small datasets where the x-point spacing is >> pixel spacing , what will happen is ymax = ymin = ystart (all the same point), and (x(i), y(i)) is the next point.
-				else {
-					if(ymin != ymax)
-						painter->drawLine(QPointF(xstart, ymin), QPointF(xstart, ymax));
-
-					painter->drawLine(QPointF(mappedX.at(i-1), mappedY.at(i-1)), QPointF(mappedX.at(i), mappedY.at(i)));
-					//NOT: painter->drawLine(QPointF(xstart, ystart), QPointF(mapX(xx(i)), mapY(yy(i))));
-
-					xstart = mappedX.at(i);
-					ymin = ymax = ystart = mappedY.at(i);
-				}
+		else	// do sub-pixel simplification.
+			paintSimplifiedLines(painter, mappedX.constData(), mappedY.constData(), data_->count(), xinc);
+	}
+}
+
+void MPlotSeriesBasic::paintSimplifiedLines(QPainter *painter, const qreal *mappedX, const qreal *mappedY, int count, qreal xinc)
+{
+	if(count < 1)
+		return;
+
+	// Instead of drawing lines between all these data points, we'll just plot the max and min value within every xinc range.  This ensures that if there is noise/jumps within a subsample (xinc) range, we'll still see it on the plot.
+
+	qreal xstart;
+	qreal ystart, ymin, ymax;
+
+	xstart = mappedX[0];
+	ymin = ymax = ystart = mappedY[0];
+
+	// move through the datapoints along x. (Note that x could be jumping forward or backward here... it's not necessarily sorted)
+	for(int i=1; i < count; i++) {
+
+		// if within the range around xstart: update max/min to be representative of this range
+		if(fabs(mappedX[i] - xstart) < xinc) {
+			qreal mappedYYI = mappedY[i];
+
+			if(mappedYYI > ymax)
+				ymax = mappedYYI;
+			if(mappedYYI < ymin)
+				ymin = mappedYYI;
+		}
+		// otherwise draw the lines and move on to next range...
+		// The first line represents everything within the range [xstart, xstart+xinc).  Note that these will all be plotted at same x-pixel.
+		// The second line connects this range to the next.  Note that (if the x-axis point spacing is not uniform) x(i) may be many pixels from xstart, to the left or right. All we know is that it's outside of our 1px range. If it _is_ far outside the range, to get the slope of the connecting line correct, we need to connect it to the last point preceding it. The point (x_(i-1), y_(i-1)) is within the 1px range [xstart, x_(i-1)] represented by the vertical line.
+		// (Brain hurt? imagine a simple example: (0,2) (0,1) (0,0), (5,0).  It should be a vertical line from (0,2) to (0,0), and then a horizontal line from (0,0) to (5,0).  The xinc range is from i=0 (xstart = x(0)) to i=2. The point outside is i=3.
+		// For normal/small datasets where the x-point spacing is >> pixel spacing , what will happen is ymax = ymin = ystart (all the same point), and (x(i), y(i)) is the next point.
+		else {
+			if(ymin != ymax)
+				painter->drawLine(QPointF(xstart, ymin), QPointF(xstart, ymax));
+
+			painter->drawLine(QPointF(mappedX[i-1], mappedY[i-1]), QPointF(mappedX[i], mappedY[i]));
+			//NOT: painter->drawLine(QPointF(xstart, ystart), QPointF(mapX(xx(i)), mapY(yy(i))));
+
+			xstart = mappedX[i];
+			ymin = ymax = ystart = mappedY[i];
+		}
+	}
+
+	// the last range
+	if(ymin != ymax)
+		painter->drawLine(QPointF(xstart, ymin), QPointF(xstart, ymax));
+}
+
+bool MPlotSeriesBasic::paintSummaryLines(QPainter *painter, qreal xinc)
+{
+	QVector<MPlotSeriesBlockSummary> summaries;
+	if(!data_->blockSummaries(0, data_->count()-1, summaries))
+		return false;
+
+	qreal width = xAxisTarget()->drawingSize().width();
+	qreal offsetX = dx_+offset_.x(), offsetY = dy_+offset_.y();
+
+	QVector<qreal> values, mappedX, mappedY;
+	bool havePrevious = false;
+	QPointF previous;
+
+	for(int b=0, size=summaries.size(); b<size; ++b) {
+		const MPlotSeriesBlockSummary& summary = summaries.at(b);
+		if(summary.count < 1)
+			continue;
+
+		qreal left = mapX(summary.minX*sx_+offsetX), right = mapX(summary.maxX*sx_+offsetX);
+		if(left > right)
+			qSwap(left, right);
+		QPointF first(mapX(summary.firstX*sx_+offsetX), mapY(summary.firstY*sy_+offsetY));
+		QPointF last(mapX(summary.lastX*sx_+offsetX), mapY(summary.lastY*sy_+offsetY));
+
+		if(havePrevious)
+			painter->drawLine(previous, first);
+
+		// narrower than xinc, or not visible: the summary is all we need. (NaN extents fail these tests, and get drawn point by point.)  So do blocks whose points are still being loaded (see MPlotAbstractSeriesData::prefetch()).
+		if(right-left < xinc || right < 0 || left > width || !data_->prefetch(summary.first, summary.first+summary.count-1)) {
+			qreal top = mapY(summary.minY*sy_+offsetY), bottom = mapY(summary.maxY*sy_+offsetY);
+			if(top != bottom)
+				painter->drawLine(QPointF(left, top), QPointF(left, bottom));
+			if(right-left >= xinc)
+				painter->drawLine(first, last);
+		}
+
+		else {
+			int count = summary.count;
+			values.resize(count);
+			mappedX.resize(count);
+			mappedY.resize(count);
+
+			xxValues(summary.first, summary.first+count-1, values.data());
+			mapXValues(count, values.constData(), mappedX.data());
+			yyValues(summary.first, summary.first+count-1, values.data());
+			mapYValues(count, values.constData(), mappedY.data());
+
+			paintSimplifiedLines(painter, mappedX.constData(), mappedY.constData(), count, xinc);
+		}
+
+		previous = last;
+		havePrevious = true;
+	}
+
+	return true;
+}
+
+void MPlotSeriesBasic::paintUniformLines(QPainter *painter, qreal mappedX0, qreal mappedDX, qreal xinc)
+{
+	int first, last;
+	if(!visibleIndexRange(mappedX0, mappedDX, first, last))
+		return;
+
+	int visibleCount = last-first+1;
+	QVector<qreal> buffer;
+	const qreal* mappedY = visibleMappedY(first, last, buffer);
+
+	// drawing x position of visible point i
+	qreal startX = mappedX0 + first*mappedDX;
+
+	// points are more than xinc apart: draw normally.
+	if(fabs(mappedDX) >= xinc) {
+		for (int i = 1; i < visibleCount; i++)
+			painter->drawLine(QPointF(startX + (i-1)*mappedDX, mappedY[i-1]), QPointF(startX + i*mappedDX, mappedY[i]));
+	}
+
+	// sub-pixel simplification, as in paintLines(): since the spacing is uniform, every xinc range holds the same number of points.  Each range is drawn as a vertical line covering its y extent, and connected to the next range.
+	else {
+		int pointsPerRange = int(xinc/fabs(mappedDX));
+
+		for(int start = 0; start < visibleCount; start += pointsPerRange) {
+			int end = qMin(start+pointsPerRange, visibleCount) - 1;
+
+			qreal ymin = mappedY[start], ymax = ymin;
+			for(int i = start+1; i <= end; i++) {
+				qreal mappedYYI = mappedY[i];
+
+				if(mappedYYI > ymax)
+					ymax = mappedYYI;
+				if(mappedYYI < ymin)
+					ymin = mappedYYI;
 			}
+
+			qreal xstart = startX + start*mappedDX;
+			if(ymin != ymax)
+				painter->drawLine(QPointF(xstart, ymin), QPointF(xstart, ymax));
+
+			if(end+1 < visibleCount)
+				painter->drawLine(QPointF(startX + end*mappedDX, mappedY[end]), QPointF(startX + (end+1)*mappedDX, mappedY[end+1]));
 		}
 	}
 }
 
 void MPlotSeriesBasic::paintMarkers(QPainter* painter) {
 
-	if(data_ && marker_) {
+	qreal mappedX0, mappedDX;
+	if(data_ && marker_ && uniformDrawingX(mappedX0, mappedDX)) {
+
+		// uniformly-spaced x values: only the visible points need markers, and their x values don't need to be fetched.
+		int first, last;
+		if(!visibleIndexRange(mappedX0, mappedDX, first, last))
+			return;
+
+		int visibleCount = last-first+1;
+		QVector<qreal> buffer;
+		const qreal* mappedY = visibleMappedY(first, last, buffer);
 
-		int dataCount = data_->count();
-		QVector<qreal> x = QVector<qreal>(dataCount);
-		QVector<qreal> y = QVector<qreal>(dataCount);
+		for (int i = visibleCount-1; i >= 0; i--){
 
-		xxValues(0, dataCount-1, x.data());
-		yyValues(0, dataCount-1, y.data());
+			qreal mappedXI = mappedX0 + (first+i)*mappedDX;
+			painter->translate(mappedXI, mappedY[i]);
+			marker_->paint(painter);
+			painter->translate(-mappedXI, -mappedY[i]);
+		}
+	}
 
-		QVector<qreal> mappedX = QVector<qreal>(dataCount);
-		QVector<qreal> mappedY = QVector<qreal>(dataCount);
+	else if(data_ && marker_) {
 
-		mapXValues(mappedX.size(), x.constData(), mappedX.data());
-		mapYValues(mappedY.size(), y.constData(), mappedY.data());
+		updateCoordinateCache();
+		const QVector<qreal>& mappedX = mappedX_;
+		const QVector<qreal>& mappedY = mappedY_;
 
 		for (int i = data_->count()-1; i >= 0; i--){
 
@@ -31,6 +31,14 @@ protected:
 protected slots:
 	/// Handles changes to the data in the series.
 	void onDataChanged();
+	/// Handles points added at the end of the series. (Always followed by onDataChanged().)
+	void onRowsAppended(int first, int last);
+	/// Handles points removed from the front of the series. (Always followed by onDataChanged().)
+	void onRowsRemovedFront(int count);
+	/// Handles changes to the values of some points in the series. (Always followed by onDataChanged().)
+	void onValuesChanged(int first, int last);
+	/// Handles the data being replaced. (Always followed by onDataChanged().)
+	void onDataReset();
 
 protected:
 	/// Pointer to the series the signal handler is managing.
@@ -139,6 +147,12 @@ public:
 private: // "slots"
 	/// This implementation is called first when the source data changes. It flags the bounding rectangle for an update, warns the scene of geometry changes, and emits a boundsChanged signal to attached plots. Then it calls onDataChanged(), which can be re-implemented by subclasses.
 	void onDataChangedPrivate();
+	/// Called before onDataChangedPrivate() when points were appended: the coordinate cache only needs to grow.
+	void onRowsAppendedPrivate(int first, int last);
+	/// Called before onDataChangedPrivate() when points were removed from the front: drops them from the front of the coordinate cache.
+	void onRowsRemovedFrontPrivate(int count);
+	/// Called before onDataChangedPrivate() when values changed: marks their span of the coordinate cache out of date.
+	void onValuesChangedPrivate(int first, int last);
 
 protected: // "slots"
 	/// This virtual function is called by the base class to let subclasses know when the internal data has changed, and let's them handle this however they need to.
@@ -153,10 +167,23 @@ protected:
 	void xxValues(unsigned start, unsigned end, qreal *outputValues) const;
 	/// Helper function that sets output values to a transformed, normalized, offsetted value.
 	void yyValues(unsigned start, unsigned end, qreal *outputValues) const;
+	/// Helper function for models with uniformly-spaced x values (see MPlotAbstractSeriesData::uniformXSpacing()). Returns true if the drawing x position of point i is \c mappedX0 + i*\c mappedDX, and sets them.  Returns false if the spacing isn't uniform, or the x axis is logarithmic.
+	bool uniformDrawingX(qreal& mappedX0, qreal& mappedDX) const;
+	/// Helper function that uses the drawing x positions from uniformDrawingX() to find the points inside the drawing area, plus one on each side so that lines leaving the drawing area are still drawn.  Returns false if there are none.
+	bool visibleIndexRange(qreal mappedX0, qreal mappedDX, int& first, int& last) const;
+	/// Helper function for the visible points found with visibleIndexRange(): returns the drawing y positions of points \c first to \c last.  On a linear y axis, they are mapped into \c buffer.  On a log y axis, they come from the coordinate cache, where the logarithms of the y values are kept: this way zooming and panning costs the same as on a linear axis.
+	const qreal* visibleMappedY(int first, int last, QVector<qreal>& buffer) const;
 
 	/// Helper function that sets a default look and feel to the plot.
 	virtual void setDefaults();
 
+	/// Brings the coordinate cache (transformedX_, transformedY_, logX_, logY_, mappedX_ and mappedY_) up to date for all points, redoing only what changed since the last time: new points, points whose values changed, or everything if the transform changed.  A change in an axis scale only re-maps that axis, from the transformed values (or their logarithms, on a log axis).  With \c withX false, only the y values are brought up to date (and the x values are dropped).  Only call when model() is valid and the axis targets are set.
+	void updateCoordinateCache(bool withX = true) const;
+	/// Brings one axis of the coordinate cache up to date, for updateCoordinateCache(): the values of points \c first to \c last changed, and the axis scale changed if \c remap.
+	void updateAxisCache(Qt::Orientation axis, int first, int last, bool remap, QVector<qreal>& transformed, QVector<qreal>& logs, QVector<qreal>& mapped) const;
+	/// Throws away the coordinate cache.
+	void invalidateCoordinateCache() const;
+
 	/// Member holding the pen for drawing the series and a pen for drawing the series if it is selected.
 	QPen linePen_, selectedPen_;
 	/// Pointer to the marker used on each point of the series.
@@ -193,6 +220,25 @@ protected:
 	/// Receives signals for us, from MPlotAbstractSeriesData implementations
 	MPlotSeriesSignalHandler* signalHandler_;
 	friend class MPlotSeriesSignalHandler;
+
+
+	// coordinate cache
+	/////////////////////////
+
+	/// Transformed, normalized, offsetted values (see xxValues() and yyValues()) of every point, as of the last updateCoordinateCache().
+	mutable QVector<qreal> transformedX_, transformedY_;
+	/// While the x (or y) axis is logarithmic: the log10 of transformedX_ (or transformedY_), through MPlotAxisMapping::transform().  They don't depend on the axis range, so zooming and panning a log axis only re-maps them, without calling log10.  Empty while the axis is linear.
+	mutable QVector<qreal> logX_, logY_;
+	/// Drawing coordinates of every point, as of the last updateCoordinateCache().
+	mutable QVector<qreal> mappedX_, mappedY_;
+	/// Span of cached points whose values changed since the last updateCoordinateCache(). Empty when dirtyFirst_ > dirtyLast_.
+	mutable int dirtyFirst_, dirtyLast_;
+	/// The completeTransform() used for transformedX_ and transformedY_.
+	mutable QTransform cachedTransform_;
+	/// The axis scales used for mappedX_ and mappedY_: min, max, drawing length and log scaling, for x and then y.
+	mutable qreal cachedMapping_[8];
+	/// True when the model described its last change with a specific notification (appended, removed front, values changed), so the dataChanged() that follows doesn't need to throw away the coordinate cache.
+	bool changeDescribed_;
 };
 
 
@@ -211,6 +257,7 @@ protected:
  */
 
 /// MPlotSeriesBasic provides one drawing implementation for a 2D plot curve.  It is optimized to efficiently draw curves with 1,000,000+ data points along the x-axis, by only drawing as many lines as would be visible.
+/*! The drawing coordinates of the points are kept in the coordinate cache (see MPlotAbstractSeries::updateCoordinateCache()), so when the model only appends points or changes a few values, repainting only transforms and maps those points.  (Models with uniformly-spaced x values don't use the cache: only their visible points are mapped, on every paint.  On a log y axis they do use it for their y values, whose logarithms it keeps.) */
 
 class MPLOTSHARED_EXPORT MPlotSeriesBasic : public MPlotAbstractSeries {
 
@@ -234,6 +281,12 @@ public:
 	virtual void paintLines(QPainter* painter);
 	/// Helper function that paints the markers on the points that make up the series.
 	virtual void paintMarkers(QPainter* painter);
+	/// Helper function used by paintLines() when the x values are uniformly spaced.  Only the y values of the visible points are fetched and mapped; the drawing x position of point i is \c mappedX0 + i*\c mappedDX.
+	void paintUniformLines(QPainter* painter, qreal mappedX0, qreal mappedDX, qreal xinc);
+	/// Helper function used by paintLines() for dense data, when the model provides block summaries (see MPlotAbstractSeriesData::blockSummaries()).  Blocks narrower than \c xinc, or outside the drawing area, are drawn from their summary without reading their points.  Returns false if the model has no summaries.
+	bool paintSummaryLines(QPainter* painter, qreal xinc);
+	/// Helper function that draws the lines through \c count points at drawing coordinates \c mappedX, \c mappedY, with the sub-pixel simplification: all the points within \c xinc of each other are drawn as one vertical line covering their y extent.
+	void paintSimplifiedLines(QPainter* painter, const qreal* mappedX, const qreal* mappedY, int count, qreal xinc);
 
 	/// re-implemented from MPlotItem base to draw an update if we're now selected (with our selection highlight)
 	virtual void setSelected(bool selected = true);
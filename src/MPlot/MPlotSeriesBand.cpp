@@ -0,0 +1,227 @@
+#ifndef MPLOTSERIESBAND_CPP
+#define MPLOTSERIESBAND_CPP
+
+#include "MPlot/MPlotSeriesBand.h"
+
+#include <QPainter>
+#include <QPolygonF>
+#include <QDebug>
+
+#include <math.h>
+#include <limits>
+
+MPlotSeriesBand::MPlotSeriesBand(const MPlotRollingStatisticsSeriesData *data)
+	: MPlotAbstractSeries()
+{
+	// Set style defaults: the band is a see-through version of the line color, and there are no markers.
+	setDefaults();
+	setMarker(MPlotMarkerShape::None);
+
+	QColor bandColor = linePen_.color();
+	bandColor.setAlphaF(0.25);
+	bandBrush_ = QBrush(bandColor);
+
+	setModel(data);
+}
+
+MPlotSeriesBand::~MPlotSeriesBand()
+{
+}
+
+void MPlotSeriesBand::setBandBrush(const QBrush &brush)
+{
+	bandBrush_ = brush;
+	update();
+}
+
+QRectF MPlotSeriesBand::boundingRect() const
+{
+	QRectF br = MPlotAbstractSeries::boundingRect();
+
+	// room for the selection highlight.
+	if(br.isValid())
+		br.adjust(-MPLOT_SELECTION_LINEWIDTH, -MPLOT_SELECTION_LINEWIDTH, MPLOT_SELECTION_LINEWIDTH, MPLOT_SELECTION_LINEWIDTH);
+
+	return br;
+}
+
+void MPlotSeriesBand::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+
+	if(!yAxisTarget() || !xAxisTarget()) {
+		qWarning() << "MPlotSeriesBand: No axis scale set. Abandoning painting because we don't know what scale to use.";
+		return;
+	}
+
+	const MPlotRollingStatisticsSeriesData* statistics = this->statistics();
+	if(!statistics || statistics->count() == 0)
+		return;
+
+	// same column width as the sub-pixel simplification of MPlotSeriesBasic.
+	QTransform wt = painter->deviceTransform();
+	qreal xinc = 1.0 / wt.m11() / MPLOT_MAX_LINES_PER_PIXEL;
+
+	QVector<Column> columns;
+	buildColumns(statistics, xinc, columns);
+
+	paintBand(painter, columns);
+
+	if(selected()) {
+		painter->setPen(selectedPen_);
+		paintCenterLine(painter, columns);
+	}
+	painter->setPen(linePen_);
+	paintCenterLine(painter, columns);
+}
+
+bool MPlotSeriesBand::visiblePointRange(int &first, int &last) const
+{
+	int count = data_->count();
+	qreal width = xAxisTarget()->drawingSize().width();
+
+	// the x values are sorted, but the axis (or the transform) can flip them.
+	bool increasing = mapX(xx(count-1)) >= mapX(xx(0));
+	qreal edges[2] = { increasing ? 0 : width, increasing ? width : 0 };
+	int found[2];
+
+	// the first point at or past each edge, going through the data.
+	for(int e=0; e<2; ++e) {
+		int low = 0, high = count;
+		while(low < high) {
+			int middle = low + (high-low)/2;
+			qreal x = mapX(xx(middle));
+			if(increasing ? x < edges[e] : x > edges[e])
+				low = middle+1;
+			else
+				high = middle;
+		}
+		found[e] = low;
+	}
+
+	first = qMax(0, found[0]-1);
+	last = qMin(count-1, found[1]);
+	return first <= last;
+}
+
+void MPlotSeriesBand::buildColumns(const MPlotRollingStatisticsSeriesData *statistics, qreal xinc, QVector<Column> &columns) const
+{
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	columns.clear();
+
+	int first, last;
+	if(!visiblePointRange(first, last))
+		return;
+
+	// about as many summaries as columns: the pyramid blocks are powers of MPLOT_ROLLING_PYRAMID_FACTOR, so there are at most that many times more.
+	qreal columnCount = qMax(qreal(1), xAxisTarget()->drawingSize().width()/xinc);
+	int pointsPerSummary = qMax(1, int((last-first+1)/columnCount));
+	QVector<MPlotBandSummary> summaries;
+	statistics->bandSummaries(first, last, pointsPerSummary, summaries);
+
+	qreal offsetY = dy_+offset_.y();
+	for(int i=0, size=summaries.size(); i<size; ++i) {
+		const MPlotBandSummary& summary = summaries.at(i);
+
+		Column column;
+		column.x = mapX(xx(summary.first));
+		column.first = summary.first;
+		column.last = summary.first + summary.count - 1;
+
+		// (the y axis can be flipped: sort the drawing coordinates.)
+		column.bandTop = column.centerTop = infinity;
+		column.bandBottom = column.centerBottom = -infinity;
+		if(summary.lower <= summary.upper) {
+			qreal a = mapY(summary.lower*sy_+offsetY), b = mapY(summary.upper*sy_+offsetY);
+			column.bandTop = qMin(a, b);
+			column.bandBottom = qMax(a, b);
+		}
+		if(summary.centerMin <= summary.centerMax) {
+			qreal a = mapY(summary.centerMin*sy_+offsetY), b = mapY(summary.centerMax*sy_+offsetY);
+			column.centerTop = qMin(a, b);
+			column.centerBottom = qMax(a, b);
+		}
+
+		// within xinc of the previous column: part of it.
+		if(!columns.isEmpty() && fabs(column.x - columns.last().x) < xinc) {
+			Column& previous = columns.last();
+			previous.bandTop = qMin(previous.bandTop, column.bandTop);
+			previous.bandBottom = qMax(previous.bandBottom, column.bandBottom);
+			previous.centerTop = qMin(previous.centerTop, column.centerTop);
+			previous.centerBottom = qMax(previous.centerBottom, column.centerBottom);
+			previous.last = column.last;
+		}
+		else
+			columns << column;
+	}
+}
+
+void MPlotSeriesBand::paintBand(QPainter *painter, const QVector<Column> &columns)
+{
+	painter->setPen(Qt::NoPen);
+	painter->setBrush(bandBrush_);
+
+	// each run of columns with a band is one polygon: along the tops, and back along the bottoms.
+	QPolygonF polygon;
+	int runStart = 0;
+	for(int i=0, size=columns.size(); i<=size; ++i) {
+		if(i < size && columns.at(i).bandTop <= columns.at(i).bandBottom)
+			continue;
+
+		if(i - runStart > 1) {
+			polygon.clear();
+			for(int c=runStart; c<i; ++c)
+				polygon << QPointF(columns.at(c).x, columns.at(c).bandTop);
+			for(int c=i-1; c>=runStart; --c)
+				polygon << QPointF(columns.at(c).x, columns.at(c).bandBottom);
+			painter->drawPolygon(polygon);
+		}
+		runStart = i+1;
+	}
+
+	painter->setBrush(QBrush());
+}
+
+void MPlotSeriesBand::paintCenterLine(QPainter *painter, const QVector<Column> &columns)
+{
+	const MPlotRollingStatisticsSeriesData* statistics = this->statistics();
+	qreal offsetY = dy_+offset_.y();
+
+	// like MPlotSeriesBasic::paintSimplifiedLines(): a vertical line over each column's extent, and a line from the last point of each column to the first point of the next.
+	bool havePrevious = false;
+	QPointF previous;
+	for(int i=0, size=columns.size(); i<size; ++i) {
+		const Column& column = columns.at(i);
+		if(column.centerTop > column.centerBottom) {
+			havePrevious = false;
+			continue;
+		}
+
+		if(column.centerTop != column.centerBottom)
+			painter->drawLine(QPointF(column.x, column.centerTop), QPointF(column.x, column.centerBottom));
+
+		qreal firstY = statistics->y(column.first);
+		if(havePrevious && firstY == firstY)
+			painter->drawLine(previous, QPointF(column.x, mapY(firstY*sy_+offsetY)));
+
+		qreal lastY = statistics->y(column.last);
+		havePrevious = lastY == lastY;
+		previous = QPointF(column.x, mapY(lastY*sy_+offsetY));
+	}
+}
+
+void MPlotSeriesBand::setSelected(bool selected)
+{
+	bool wasSelected = isSelected();
+	MPlotItem::setSelected(selected);
+	if(isSelected() != wasSelected)
+		update();
+}
+
+void MPlotSeriesBand::onDataChanged()
+{
+	update();
+}
+
+#endif // MPLOTSERIESBAND_CPP
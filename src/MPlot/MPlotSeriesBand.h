@@ -0,0 +1,68 @@
+#ifndef MPLOTSERIESBAND_H
+#define MPLOTSERIESBAND_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeries.h"
+#include "MPlot/MPlotRollingStatistics.h"
+
+#include <QBrush>
+
+/// MPlotSeriesBand draws the rolling statistics of a signal (see MPlotRollingStatisticsSeriesData) as a filled band around a center line: the mean ± k standard deviations, or the rolling minimum and maximum.
+/*! For noisy, high-rate signals, the band shows the spread of the data without drawing millions of raw points.  The band and the center line are drawn from the summary pyramid of the statistics (MPlotRollingStatisticsSeriesData::bandSummaries()), with about one summary per 1/MPLOT_MAX_LINES_PER_PIXEL pixel column, so the cost of a paint depends on the width of the plot, not on the number of points.  Only the visible points are summarized; they are found by binary search, so the x values must be sorted.
+
+The center line is drawn with linePen(), and the band is filled with bandBrush().  Markers are not drawn.  The model must be an MPlotRollingStatisticsSeriesData; with any other model, nothing is drawn. */
+class MPLOTSHARED_EXPORT MPlotSeriesBand : public MPlotAbstractSeries {
+
+public:
+	/// Constructor. Draws the statistics in \c data.
+	MPlotSeriesBand(const MPlotRollingStatisticsSeriesData* data = 0);
+	/// Destructor.
+	virtual ~MPlotSeriesBand();
+
+	/// Returns the model as rolling statistics, or 0 if it isn't.
+	const MPlotRollingStatisticsSeriesData* statistics() const { return dynamic_cast<const MPlotRollingStatisticsSeriesData*>(data_); }
+
+	/// Returns the brush used to fill the band.
+	QBrush bandBrush() const { return bandBrush_; }
+	/// Sets the brush used to fill the band.
+	void setBandBrush(const QBrush& brush);
+
+	/// boundingRect: using parent implementation, but adding extra room on edges for our selection highlight.
+	virtual QRectF boundingRect() const;
+	/// Paints the band, and then the center line.
+	virtual void paint(QPainter* painter,
+					   const QStyleOptionGraphicsItem* option,
+					   QWidget* widget);
+
+	/// re-implemented from MPlotItem base to draw an update if we're now selected (with our selection highlight)
+	virtual void setSelected(bool selected = true);
+
+protected:
+	/// One column of the drawing: the summaries that fall within xinc of each other, in drawing coordinates.
+	struct Column {
+		qreal x;
+		/// The band, top to bottom.  (top > bottom if none of the points has a band.)
+		qreal bandTop, bandBottom;
+		/// The extent of the center line.  (top > bottom if none of the points has a center.)
+		qreal centerTop, centerBottom;
+		/// The first and last points in the column.
+		int first, last;
+	};
+
+	/// Finds the points whose drawing x positions are inside the drawing area, plus one on each side.  Returns false if there are none.
+	bool visiblePointRange(int& first, int& last) const;
+	/// Summarizes the visible points of \c statistics into columns \c xinc wide.
+	void buildColumns(const MPlotRollingStatisticsSeriesData* statistics, qreal xinc, QVector<Column>& columns) const;
+	/// Fills the band over \c columns.
+	void paintBand(QPainter* painter, const QVector<Column>& columns);
+	/// Draws the center line over \c columns.
+	void paintCenterLine(QPainter* painter, const QVector<Column>& columns);
+
+	/// Handle implementation-specific drawing updates
+	virtual void onDataChanged();
+
+	/// Brush used to fill the band.
+	QBrush bandBrush_;
+};
+
+#endif // MPLOTSERIESBAND_H
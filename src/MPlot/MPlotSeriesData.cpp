@@ -3,6 +3,36 @@
 
 #include "MPlot/MPlotSeriesData.h"
 
+MPlotSeriesSnapshot::MPlotSeriesSnapshot(const QVector<qreal> &xValues, const QVector<qreal> &yValues, quint64 version)
+{
+	Data* d = new Data();
+	d->x = xValues;
+	d->y = yValues;
+	d->version = version;
+
+	// only whole points: the extra values of a longer vector are dropped (this copies it).
+	int size = qMin(xValues.size(), yValues.size());
+	if(d->x.size() > size)
+		d->x.resize(size);
+	if(d->y.size() > size)
+		d->y.resize(size);
+
+	if(size > 0) {
+		MPlotMinMax xRange, yRange;
+		xRange.add(xValues.constData(), size);
+		yRange.add(yValues.constData(), size);
+
+		qreal minX = xRange.minimum(), maxX = xRange.maximum();
+		qreal minY = yRange.minimum(), maxY = yRange.maximum();
+		d->boundingRect = QRectF(minX,
+								 minY,
+								 qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+								 qMax(maxY-minY, std::numeric_limits<qreal>::min()));	// same as MPlotAbstractSeriesData::boundingRect(): keep a single point valid.
+	}
+
+	d_ = QSharedPointer<const Data>(d);
+}
+
 MPlotSeriesDataSignalSource::MPlotSeriesDataSignalSource(MPlotAbstractSeriesData* parent)
 	: QObject(0) {
 	data_ = parent;
@@ -12,6 +42,7 @@ MPlotAbstractSeriesData::MPlotAbstractSeriesData()
 {
 	signalSource_ = new MPlotSeriesDataSignalSource(this);
 	cachedDataRectUpdateRequired_ = true;
+	dataVersion_ = 0;
 }
 
 MPlotAbstractSeriesData::~MPlotAbstractSeriesData()
@@ -22,16 +53,42 @@ MPlotAbstractSeriesData::~MPlotAbstractSeriesData()
 
 #include <QDebug>
 #include <QTime>
+#include <cmath>
+
+/// Provides the x values (channel 0) and y values (channel 1) of a series to MPlotMinMax::search(). With \c firstChannel = 1 and \c channels = 1, it provides only the y values.
+class MPlotSeriesDataMinMaxSource : public MPlotMinMaxSource {
+public:
+	MPlotSeriesDataMinMaxSource(const MPlotAbstractSeriesData* data, int firstChannel = 0, int channels = 2)
+		: data_(data), firstChannel_(firstChannel), channels_(channels) {}
+
+	virtual qint64 units() const { return data_->count(); }
+	virtual int channels() const { return channels_; }
+	virtual void read(int channel, qint64 start, qint64 count, qreal* outputValues) const {
+		if(firstChannel_ + channel == 0)
+			data_->xValues(unsigned(start), unsigned(start+count-1), outputValues);
+		else
+			data_->yValues(unsigned(start), unsigned(start+count-1), outputValues);
+	}
+	virtual bool concurrentReadsSafe() const { return data_->concurrentReadsSafe(); }
+
+protected:
+	const MPlotAbstractSeriesData* data_;
+	int firstChannel_, channels_;
+};
+
 QRectF MPlotAbstractSeriesData::boundingRect() const {
 	if(count() == 0)
 		return QRectF();
 
 	if(cachedDataRectUpdateRequired_) {
 
-		qreal minY = searchMinY();
-		qreal maxY = searchMaxY();
-		qreal minX = searchMinX();
-		qreal maxX = searchMaxX();
+		MPlotMinMax xRange, yRange;
+		searchMinMax(xRange, yRange);
+
+		qreal minY = yRange.minimum();
+		qreal maxY = yRange.maximum();
+		qreal minX = xRange.minimum();
+		qreal maxX = xRange.maximum();
 
 		cachedDataRect_ = QRectF(minX,
 								 minY,
@@ -43,64 +100,92 @@ QRectF MPlotAbstractSeriesData::boundingRect() const {
 	return cachedDataRect_;
 }
 
-qreal MPlotAbstractSeriesData::searchMinY() const {
-
-	int size = count();
-	QVector<qreal> y = QVector<qreal>(size);
-	yValues(0, unsigned(size)-1, y.data());
+MPlotSeriesSnapshot MPlotAbstractSeriesData::snapshot() const
+{
+	if(cachedSnapshot_.isNull() || cachedSnapshot_.version() != dataVersion_) {
+		int size = count();
+		QVector<qreal> xs(size), ys(size);
+		if(size) {
+			xValues(0, size-1, xs.data());
+			yValues(0, size-1, ys.data());
+		}
+		cachedSnapshot_ = MPlotSeriesSnapshot(xs, ys, dataVersion_);
+	}
 
-	qreal extreme = y.at(0);
+	return cachedSnapshot_;
+}
 
-	for (int i = 1; i < size; i++)
-		if (y.at(i) < extreme)
-			extreme = y.at(i);
+void MPlotAbstractSeriesData::searchMinMax(MPlotMinMax &xRange, MPlotMinMax &yRange) const
+{
+	MPlotMinMax results[2];
+	MPlotSeriesDataMinMaxSource source(this);
+	MPlotMinMax::search(&source, results);
 
-	return extreme;
+	xRange = results[0];
+	yRange = results[1];
 }
 
-qreal MPlotAbstractSeriesData::searchMaxY() const {
+void MPlotAbstractSeriesData::emitRowsAppended(int first, int last)
+{
+	++dataVersion_;
+
+	// if the bounds are known, they only need to grow to include the new points.
+	if(!cachedDataRectUpdateRequired_ && first > 0 && last >= first) {
+		int size = last-first+1;
+		QVector<qreal> values(size);
+		MPlotMinMax xRange, yRange;
+		xValues(first, last, values.data());
+		xRange.add(values.constData(), size);
+		yValues(first, last, values.data());
+		yRange.add(values.constData(), size);
+
+		qreal minX = qMin(cachedDataRect_.left(), xRange.isValid() ? xRange.minimum() : cachedDataRect_.left());
+		qreal maxX = qMax(cachedDataRect_.right(), xRange.isValid() ? xRange.maximum() : cachedDataRect_.right());
+		qreal minY = qMin(cachedDataRect_.top(), yRange.isValid() ? yRange.minimum() : cachedDataRect_.top());
+		qreal maxY = qMax(cachedDataRect_.bottom(), yRange.isValid() ? yRange.maximum() : cachedDataRect_.bottom());
 
-	int size = count();
-	QVector<qreal> y = QVector<qreal>(size);
-	yValues(0, unsigned(size)-1, y.data());
+		cachedDataRect_ = QRectF(minX,
+								 minY,
+								 qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+								 qMax(maxY-minY, std::numeric_limits<qreal>::min()));
+	}
+	else
+		cachedDataRectUpdateRequired_ = true;
 
-	qreal extreme = y.at(0);
+	signalSource_->emitRowsAppended(first, last);
+	signalSource_->emitDataChanged();
+}
 
-	for (int i = 1; i < size; i++)
-		if (y.at(i) > extreme)
-			extreme = y.at(i);
+qreal MPlotAbstractSeriesData::searchMinY() const {
 
-	return extreme;
+	MPlotMinMax result;
+	MPlotSeriesDataMinMaxSource source(this, 1, 1);
+	MPlotMinMax::search(&source, &result);
+	return result.minimum();
 }
 
-qreal MPlotAbstractSeriesData::searchMinX() const {
-
-	int size = count();
-	QVector<qreal> x = QVector<qreal>(size);
-	xValues(0, unsigned(size)-1, x.data());
+qreal MPlotAbstractSeriesData::searchMaxY() const {
 
-	qreal extreme = x.at(0);
+	MPlotMinMax result;
+	MPlotSeriesDataMinMaxSource source(this, 1, 1);
+	MPlotMinMax::search(&source, &result);
+	return result.maximum();
+}
 
-	for (int i = 1; i < size; i++)
-		if (x.at(i) < extreme)
-			extreme = x.at(i);
+qreal MPlotAbstractSeriesData::searchMinX() const {
 
-	return extreme;
+	MPlotMinMax result;
+	MPlotSeriesDataMinMaxSource source(this, 0, 1);
+	MPlotMinMax::search(&source, &result);
+	return result.minimum();
 }
 
 qreal MPlotAbstractSeriesData::searchMaxX() const {
 
-	int size = count();
-	QVector<qreal> x = QVector<qreal>(size);
-	xValues(0, unsigned(size)-1, x.data());
-
-	qreal extreme = x.at(0);
-
-	for (int i = 1; i < size; i++)
-		if (x.at(i) > extreme)
-			extreme = x.at(i);
-
-	return extreme;
+	MPlotMinMax result;
+	MPlotSeriesDataMinMaxSource source(this, 0, 1);
+	MPlotMinMax::search(&source, &result);
+	return result.maximum();
 }
 
 MPlotRealtimeModel::MPlotRealtimeModel(QObject *parent) :
@@ -109,6 +194,9 @@ MPlotRealtimeModel::MPlotRealtimeModel(QObject *parent) :
 	// min/max tracking indices are invalid at start (empty model)
 	minYIndex_ = maxYIndex_ = minXIndex_ = maxXIndex_ = -1;
 
+	extentsIndexEnabled_ = false;
+	extentsIndexStale_ = true;
+
 	// Axis names: initialized on first line to "x", "y" (Real original... I know.)
 }
 
@@ -195,15 +283,17 @@ bool MPlotRealtimeModel::setData(const QModelIndex &index, const QVariant &value
 		// Setting an x value?
 		if(index.column() == 0) {
 			minMaxChangeCheckX(dval, index.row());
+			retention_.valuesChanged();
 			emit QAbstractItemModel::dataChanged(index, index);
-			emitDataChanged();
+			emitValuesChanged(index.row(), index.row());
 			return true;
 		}
 		// Setting a y value?
 		if(index.column() == 1) {
 			minMaxChangeCheckY(dval, index.row());
+			retention_.valuesChanged();
 			emit QAbstractItemModel::dataChanged(index, index);
-			emitDataChanged();
+			emitValuesChanged(index.row(), index.row());
 			return true;
 		}
 	}
@@ -234,11 +324,14 @@ void MPlotRealtimeModel::insertPointFront(qreal x, qreal y) {
 
 	// Check if this guy is a new min or max:
 	minMaxAddCheck(x, y, 0);
+	extentsIndexStale_ = true;
+	retention_.insertedFront();
 
 	endInsertRows();
 
 	// Signal a full-plot update
-	emitDataChanged();
+	emitDataReset();
+	applyRetention();
 }
 
 // This allows you to add data points at the end:
@@ -249,44 +342,81 @@ void MPlotRealtimeModel::insertPointBack(qreal x, qreal y) {
 	yval_.append(y);
 
 	minMaxAddCheck(x, y, xval_.count()-1);
+	extentsIndexStale_ = true;
+	retention_.appended(this, 1);
 
 	endInsertRows();
 	// Signal a full-plot update
-	emitDataChanged();
+	emitRowsAppended(xval_.count()-1, xval_.count()-1);
+	applyRetention();
 }
 
-// Remove a point at the front (Returns true if successful).
-bool MPlotRealtimeModel::removePointFront() {
-	if(xval_.isEmpty())
-		return false;
+// This adds many data points at the end, with one notification:
+void MPlotRealtimeModel::insertPointsBack(const qreal *x, const qreal *y, int count) {
+	if(count < 1)
+		return;
+
+	int first = xval_.count();
+	beginInsertRows(QModelIndex(), first, first+count-1);
+
+	// (no reserve(): it would grow the lists to exactly this size on every batch, and append() already grows them geometrically.)
+	for(int i=0; i<count; ++i) {
+		xval_.append(x[i]);
+		yval_.append(y[i]);
+		minMaxAddCheck(x[i], y[i], first+i);
+	}
+	extentsIndexStale_ = true;
+	retention_.appended(this, count);
 
-	beginRemoveRows(QModelIndex(), 0, 0);
+	endInsertRows();
+	emitRowsAppended(first, first+count-1);
+	applyRetention();
+}
 
-	xval_.takeFirst();
-	yval_.takeFirst();
+// Remove points at the front (Returns the number removed).
+int MPlotRealtimeModel::removePointsFront(int count) {
+	count = qMin(count, xval_.count());
+	if(count < 1)
+		return 0;
+
+	beginRemoveRows(QModelIndex(), 0, count-1);
+
+	for(int i=0; i<count; ++i) {
+		xval_.removeFirst();
+		yval_.removeFirst();
+	}
 
 	// Update the max/min index trackers:
-	minXIndex_--;
-	minYIndex_--;
-	maxXIndex_--;
-	maxYIndex_--;
+	minXIndex_ -= count;
+	minYIndex_ -= count;
+	maxXIndex_ -= count;
+	maxYIndex_ -= count;
+	retention_.removedFront(count);
 
 	// Did we remove the current max/min?
-	if(minYIndex_ == -1)
-		minYIndex_ = searchMinIndex(yval_);
-	if(maxYIndex_ == -1)
-		maxYIndex_ = searchMaxIndex(yval_);
-	if(minXIndex_ == -1)
-		minXIndex_ = searchMinIndex(xval_);
-	if(maxXIndex_ == -1)
-		maxXIndex_ = searchMaxIndex(xval_);
+	if(minXIndex_ < 0 || minYIndex_ < 0 || maxXIndex_ < 0 || maxYIndex_ < 0) {
+		// with a retention policy, the sliding extremes know the new record holders.
+		if(retention_.isEnabled())
+			retention_.extremeIndexes(this, minXIndex_, maxXIndex_, minYIndex_, maxYIndex_);
+		else {
+			if(minYIndex_ < 0)
+				minYIndex_ = searchMinIndex(yval_);
+			if(maxYIndex_ < 0)
+				maxYIndex_ = searchMaxIndex(yval_);
+			if(minXIndex_ < 0)
+				minXIndex_ = searchMinIndex(xval_);
+			if(maxXIndex_ < 0)
+				maxXIndex_ = searchMaxIndex(xval_);
+		}
+	}
+	extentsIndexStale_ = true;
 
 
 	endRemoveRows();
 
 	// Signal a full-plot update
-	emitDataChanged();
-	return true;
+	emitRowsRemovedFront(count);
+	return count;
 }
 
 // Remove a point at the back (returns true if successful)
@@ -309,11 +439,13 @@ bool MPlotRealtimeModel::removePointBack() {
 		minXIndex_ = searchMinIndex(xval_);
 	if(maxXIndex_ == oldIndexToCheck)
 		maxXIndex_ = searchMaxIndex(xval_);
+	extentsIndexStale_ = true;
+	retention_.removedBack();
 
 	endRemoveRows();
 
 	// Signal a full-plot update
-	emitDataChanged();
+	emitDataReset();
 	return true;
 }
 
@@ -359,6 +491,15 @@ void MPlotRealtimeModel::minMaxAddCheck(qreal x, qreal y, int index) {
 // Inserts the point (modifies the data array).
 void MPlotRealtimeModel::minMaxChangeCheckX(qreal newVal, int index) {
 
+	if(extentsIndexEnabled_) {
+		updateExtentsIndex();
+		xval_[index] = newVal;
+		xExtents_.setValue(index, newVal);
+		minXIndex_ = xExtents_.minimumIndex();
+		maxXIndex_ = xExtents_.maximumIndex();
+		return;
+	}
+
 	qreal oldVal = xval_.at(index);
 	xval_[index] = newVal;
 
@@ -380,6 +521,15 @@ void MPlotRealtimeModel::minMaxChangeCheckX(qreal newVal, int index) {
 }
 void MPlotRealtimeModel::minMaxChangeCheckY(qreal newVal, int index) {
 
+	if(extentsIndexEnabled_) {
+		updateExtentsIndex();
+		yval_[index] = newVal;
+		yExtents_.setValue(index, newVal);
+		minYIndex_ = yExtents_.minimumIndex();
+		maxYIndex_ = yExtents_.maximumIndex();
+		return;
+	}
+
 	qreal oldVal = yval_.at(index);
 	yval_[index] = newVal;
 
@@ -400,6 +550,44 @@ void MPlotRealtimeModel::minMaxChangeCheckY(qreal newVal, int index) {
 
 }
 
+void MPlotRealtimeModel::setRetentionPolicy(const MPlotRetentionPolicy &policy) {
+	retention_.setPolicy(policy, this);
+	applyRetention();
+}
+
+int MPlotRealtimeModel::applyRetention() {
+	int count = retention_.evictionCount(this);
+	return count > 0 ? removePointsFront(count) : 0;
+}
+
+void MPlotRealtimeModel::setExtentsIndexEnabled(bool enabled) {
+	extentsIndexEnabled_ = enabled;
+	extentsIndexStale_ = true;
+	if(!enabled) {
+		xExtents_.clear();
+		yExtents_.clear();
+	}
+}
+
+void MPlotRealtimeModel::updateExtentsIndex() {
+	if(!extentsIndexStale_)
+		return;
+
+	int size = xval_.count();
+	QVector<qreal> values(size);
+	if(size) {
+		xValues(0, size-1, values.data());
+		xExtents_.build(values.constData(), size);
+		yValues(0, size-1, values.data());
+		yExtents_.build(values.constData(), size);
+	}
+	else {
+		xExtents_.clear();
+		yExtents_.clear();
+	}
+	extentsIndexStale_ = false;
+}
+
 int MPlotRealtimeModel::searchMaxIndex(const QList<qreal>& list) {
 	if(list.isEmpty())
 		return -1;
@@ -448,7 +636,11 @@ bool MPlotVectorSeriesData::setValues(const QVector<qreal> &xValues, const QVect
 
 	xValues_ = xValues;
 	yValues_ = yValues;
-	emitDataChanged();
+	if(extentsIndexEnabled_) {
+		xExtents_.build(xValues_.constData(), xValues_.count());
+		yExtents_.build(yValues_.constData(), yValues_.count());
+	}
+	emitDataReset();
 	return true;
 }
 
@@ -458,7 +650,9 @@ bool MPlotVectorSeriesData::setXValue(int index, qreal xValue)
 		return false;
 
 	xValues_[index] = xValue;
-	emitDataChanged();
+	if(extentsIndexEnabled_)
+		xExtents_.setValue(index, xValue);
+	emitValuesChanged(index, index);
 	return true;
 }
 
@@ -468,13 +662,170 @@ bool MPlotVectorSeriesData::setYValue(int index, qreal yValue)
 		return false;
 
 	yValues_[index] = yValue;
-	emitDataChanged();
+	if(extentsIndexEnabled_)
+		yExtents_.setValue(index, yValue);
+	emitValuesChanged(index, index);
+	return true;
+}
+
+bool MPlotVectorSeriesData::setXValues(int startIndex, const QVector<qreal> &xValues)
+{
+	if(startIndex < 0 || startIndex + xValues.count() > xValues_.count())
+		return false;
+	if(xValues.isEmpty())
+		return true;
+
+	memcpy(xValues_.data()+startIndex, xValues.constData(), xValues.count()*sizeof(qreal));
+	if(extentsIndexEnabled_)
+		xExtents_.setValues(startIndex, xValues.constData(), xValues.count());
+	emitValuesChanged(startIndex, startIndex+xValues.count()-1);
+	return true;
+}
+
+bool MPlotVectorSeriesData::setYValues(int startIndex, const QVector<qreal> &yValues)
+{
+	if(startIndex < 0 || startIndex + yValues.count() > yValues_.count())
+		return false;
+	if(yValues.isEmpty())
+		return true;
+
+	memcpy(yValues_.data()+startIndex, yValues.constData(), yValues.count()*sizeof(qreal));
+	if(extentsIndexEnabled_)
+		yExtents_.setValues(startIndex, yValues.constData(), yValues.count());
+	emitValuesChanged(startIndex, startIndex+yValues.count()-1);
 	return true;
 }
 
+QRectF MPlotVectorSeriesData::boundingRect() const
+{
+	if(!extentsIndexEnabled_)
+		return MPlotAbstractSeriesData::boundingRect();
+
+	if(xValues_.isEmpty())
+		return QRectF();
+
+	qreal minX = xExtents_.minimum();
+	qreal minY = yExtents_.minimum();
+
+	// as in MPlotAbstractSeriesData::boundingRect(): make sure a single data point still has a valid rectangle.
+	return QRectF(minX,
+				  minY,
+				  qMax(xExtents_.maximum()-minX, std::numeric_limits<qreal>::min()),
+				  qMax(yExtents_.maximum()-minY, std::numeric_limits<qreal>::min()));
+}
+
+void MPlotVectorSeriesData::setExtentsIndexEnabled(bool enabled)
+{
+	if(enabled == extentsIndexEnabled_)
+		return;
+
+	extentsIndexEnabled_ = enabled;
+	if(enabled) {
+		xExtents_.build(xValues_.constData(), xValues_.count());
+		yExtents_.build(yValues_.constData(), yValues_.count());
+	}
+	else {
+		xExtents_.clear();
+		yExtents_.clear();
+	}
+}
+
 MPlotVectorSeriesData::MPlotVectorSeriesData()
 	: MPlotAbstractSeriesData()
 {
+	extentsIndexEnabled_ = false;
+}
+
+MPlotUniformSeriesData::MPlotUniformSeriesData(qreal x0, qreal dx)
+	: MPlotAbstractSeriesData()
+{
+	x0_ = x0;
+	dx_ = dx;
+}
+
+void MPlotUniformSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	for(unsigned i=indexStart; i<=indexEnd; ++i)
+		*(outputValues++) = x0_ + dx_*i;
+}
+
+QRectF MPlotUniformSeriesData::boundingRect() const
+{
+	int size = yValues_.count();
+	if(size == 0)
+		return QRectF();
+
+	if(cachedDataRectUpdateRequired_) {
+
+		qreal minX = x0_;
+		qreal maxX = x0_ + dx_*(size-1);
+		if(minX > maxX)
+			qSwap(minX, maxX);
+
+		MPlotMinMax yRange;
+		yRange.add(yValues_.constData(), size);
+		qreal minY = yRange.minimum();
+		qreal maxY = yRange.maximum();
+
+		// as in MPlotAbstractSeriesData::boundingRect(): make sure a single data point still has a valid rectangle.
+		cachedDataRect_ = QRectF(minX,
+								 minY,
+								 qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+								 qMax(maxY-minY, std::numeric_limits<qreal>::min()));
+		cachedDataRectUpdateRequired_ = false;
+	}
+
+	return cachedDataRect_;
+}
+
+void MPlotUniformSeriesData::setXSpacing(qreal x0, qreal dx)
+{
+	x0_ = x0;
+	dx_ = dx;
+	emitDataReset();
+}
+
+void MPlotUniformSeriesData::setYValues(const QVector<qreal> &yValues)
+{
+	yValues_ = yValues;
+	emitDataReset();
+}
+
+bool MPlotUniformSeriesData::setYValue(int index, qreal yValue)
+{
+	if((unsigned)index >= (unsigned)yValues_.count())
+		return false;
+
+	yValues_[index] = yValue;
+	emitValuesChanged(index, index);
+	return true;
+}
+
+bool MPlotUniformSeriesData::indexRangeForX(qreal xMin, qreal xMax, int &first, int &last) const
+{
+	int size = yValues_.count();
+	if(size == 0 || xMin > xMax)
+		return false;
+
+	if(dx_ == 0) {
+		// all the points are at x0.
+		if(x0_ < xMin || x0_ > xMax)
+			return false;
+		first = 0;
+		last = size-1;
+		return true;
+	}
+
+	// with a negative spacing, xMax is reached first.
+	qreal lowIndex = ((dx_ > 0 ? xMin : xMax) - x0_)/dx_;
+	qreal highIndex = ((dx_ > 0 ? xMax : xMin) - x0_)/dx_;
+
+	if(highIndex < 0 || lowIndex > size-1)
+		return false;
+
+	first = lowIndex <= 0 ? 0 : int(ceil(lowIndex));
+	last = highIndex >= size-1 ? size-1 : int(floor(highIndex));
+	return first <= last;
 }
 
 void MPlotRealtimeModel::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
@@ -489,6 +840,171 @@ void MPlotRealtimeModel::yValues(unsigned indexStart, unsigned indexEnd, qreal *
 		*(outputValues++) = yval_.at(i);
 }
 
+MPlotRealtimeSeriesData::MPlotRealtimeSeriesData()
+	: MPlotAbstractSeriesData()
+{
+	head_ = 0;
+}
+
+void MPlotRealtimeSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, xval_.constData()+head_+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotRealtimeSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, yval_.constData()+head_+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotRealtimeSeriesData::insertPointFront(qreal x, qreal y)
+{
+	// reuse a slot freed by removing from the front, if there is one.
+	if(head_ > 0) {
+		--head_;
+		xval_[head_] = x;
+		yval_[head_] = y;
+	}
+	else {
+		xval_.prepend(x);
+		yval_.prepend(y);
+	}
+	retention_.insertedFront();
+
+	emitDataReset();
+	applyRetention();
+}
+
+void MPlotRealtimeSeriesData::insertPointBack(qreal x, qreal y)
+{
+	xval_.append(x);
+	yval_.append(y);
+	retention_.appended(this, 1);
+
+	emitRowsAppended(count()-1, count()-1);
+	applyRetention();
+}
+
+void MPlotRealtimeSeriesData::insertPointsBack(const qreal *x, const qreal *y, int count)
+{
+	if(count < 1)
+		return;
+
+	int first = this->count();
+	int size = xval_.size();
+	xval_.resize(size+count);
+	yval_.resize(size+count);
+	memcpy(xval_.data()+size, x, count*sizeof(qreal));
+	memcpy(yval_.data()+size, y, count*sizeof(qreal));
+	retention_.appended(this, count);
+
+	emitRowsAppended(first, first+count-1);
+	applyRetention();
+}
+
+int MPlotRealtimeSeriesData::removePointsFront(int count)
+{
+	count = qMin(count, this->count());
+	if(count < 1)
+		return 0;
+
+	// the bounds only need a new search if one of the removed points was on them. (With a retention policy, the sliding extremes keep them instead.)
+	bool boundsUnchanged = true;
+	for(int i=head_, end=head_+count; i<end && boundsUnchanged && !retention_.isEnabled(); ++i)
+		if(reachesBounds(xval_.at(i), true) || reachesBounds(yval_.at(i), false))
+			boundsUnchanged = false;
+
+	head_ += count;
+	compact();
+	retention_.removedFront(count);
+
+	emitRowsRemovedFront(count, boundsUnchanged);
+	return count;
+}
+
+bool MPlotRealtimeSeriesData::removePointBack()
+{
+	if(count() == 0)
+		return false;
+
+	xval_.resize(xval_.size()-1);
+	yval_.resize(yval_.size()-1);
+	compact();
+	retention_.removedBack();
+
+	emitDataReset();
+	return true;
+}
+
+void MPlotRealtimeSeriesData::clear()
+{
+	xval_.clear();
+	yval_.clear();
+	head_ = 0;
+	retention_.cleared();
+
+	emitDataReset();
+}
+
+void MPlotRealtimeSeriesData::setX(int index, qreal x)
+{
+	qreal& value = xval_[head_+index];
+	bool boundsUnchanged = !reachesBounds(value, true) && !reachesBounds(x, true);
+	value = x;
+	retention_.valuesChanged();
+	emitValuesChanged(index, index, boundsUnchanged);
+}
+
+void MPlotRealtimeSeriesData::setY(int index, qreal y)
+{
+	qreal& value = yval_[head_+index];
+	bool boundsUnchanged = !reachesBounds(value, false) && !reachesBounds(y, false);
+	value = y;
+	retention_.valuesChanged();
+	emitValuesChanged(index, index, boundsUnchanged);
+}
+
+QRectF MPlotRealtimeSeriesData::boundingRect() const
+{
+	if(retention_.isEnabled())
+		return retention_.boundingRect(this);
+	return MPlotAbstractSeriesData::boundingRect();
+}
+
+void MPlotRealtimeSeriesData::setRetentionPolicy(const MPlotRetentionPolicy &policy)
+{
+	retention_.setPolicy(policy, this);
+	cachedDataRectUpdateRequired_ = true;	// the base-class bounds weren't maintained while a policy was set.
+	applyRetention();
+}
+
+int MPlotRealtimeSeriesData::applyRetention()
+{
+	int count = retention_.evictionCount(this);
+	return count > 0 ? removePointsFront(count) : 0;
+}
+
+bool MPlotRealtimeSeriesData::reachesBounds(qreal value, bool isX) const
+{
+	if(cachedDataRectUpdateRequired_)
+		return true;
+
+	// (NaN values fail both comparisons: they're skipped by the bounds search, so they can't be an extreme.)
+	if(isX)
+		return value <= cachedDataRect_.left() || value >= cachedDataRect_.right();
+	else
+		return value <= cachedDataRect_.top() || value >= cachedDataRect_.bottom();
+}
+
+void MPlotRealtimeSeriesData::compact()
+{
+	if(!MPlotFrontCompactionDue(head_, xval_.size()))
+		return;
+
+	MPlotRemoveFront(xval_, head_);
+	MPlotRemoveFront(yval_, head_);
+	head_ = 0;
+}
+
 
 #endif
 
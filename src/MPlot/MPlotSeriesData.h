@@ -2,16 +2,80 @@
 #define __MPlotSeriesData_H__
 
 #include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotMinMax.h"
+#include "MPlot/MPlotExtentsIndex.h"
+#include "MPlot/MPlotSeriesRetention.h"
 
 #include <QAbstractTableModel>
 #include <QQueue>
 #include <QList>
 #include <QRectF>
 #include <QVector>
+#include <QSharedPointer>
 
 #include <limits>
 
 class MPlotAbstractSeriesData;
+class MPlotSharedXCache;
+
+
+/// This class is an immutable, versioned copy of series data. Copying it is O(1), and it can be read from any thread, however the data it came from changes afterwards.
+/*! Snapshots are how a reader (ex: an analysis or export thread, or one paint pass) gets a consistent view of data that a writer keeps changing: it calls MPlotAbstractSeriesData::snapshot() once, and then reads only the snapshot.  The values are shared between copies of the same snapshot (with an atomic reference count), and released when the last copy goes away.
+
+The bounding rect is computed once, when the snapshot is created, so readers get it for free. */
+class MPLOTSHARED_EXPORT MPlotSeriesSnapshot {
+public:
+	/// Creates a null snapshot, with no points and version 0.
+	MPlotSeriesSnapshot() {}
+	/// Creates a snapshot of \c xValues and \c yValues (which should be the same size: if not, the extra values of the longer one are dropped), identified by \c version.  The vectors are shared, not copied; the snapshot holds them from now on, so don't modify them afterwards through another copy that's being read from another thread.
+	MPlotSeriesSnapshot(const QVector<qreal>& xValues, const QVector<qreal>& yValues, quint64 version);
+
+	/// Returns true if this snapshot was default-constructed.
+	bool isNull() const { return !d_; }
+	/// Returns the version of the data this snapshot was taken from.  Versions increase with each change of the data.
+	quint64 version() const { return d_ ? d_->version : 0; }
+
+	/// Returns the number of points.
+	int count() const { return d_ ? d_->x.size() : 0; }
+	/// Returns the x value at \c index.
+	qreal x(int index) const { return d_->x.at(index); }
+	/// Returns the y value at \c index.
+	qreal y(int index) const { return d_->y.at(index); }
+	/// Returns all the x values. (Shared, not copied.)
+	QVector<qreal> xValues() const { return d_ ? d_->x : QVector<qreal>(); }
+	/// Returns all the y values. (Shared, not copied.)
+	QVector<qreal> yValues() const { return d_ ? d_->y : QVector<qreal>(); }
+	/// Returns a pointer to the count() x values, or 0 if there are none.
+	const qreal* xData() const { return count() ? d_->x.constData() : 0; }
+	/// Returns a pointer to the count() y values, or 0 if there are none.
+	const qreal* yData() const { return count() ? d_->y.constData() : 0; }
+
+	/// Returns the bounds of the points, the same way as MPlotAbstractSeriesData::boundingRect().
+	QRectF boundingRect() const { return d_ ? d_->boundingRect : QRectF(); }
+
+protected:
+	/// The shared, never modified contents of a snapshot.
+	struct Data {
+		QVector<qreal> x, y;
+		QRectF boundingRect;
+		quint64 version;
+	};
+	/// Shared contents; null for a null snapshot.
+	QSharedPointer<const Data> d_;
+};
+
+
+/// Summary of a block of consecutive points, for models that store their data in blocks.  See MPlotAbstractSeriesData::blockSummaries().
+struct MPLOTSHARED_EXPORT MPlotSeriesBlockSummary {
+	/// Index of the first point in the block.
+	int first;
+	/// Number of points in the block.
+	int count;
+	/// Extremes of the x and y values in the block (NaN values skipped).
+	qreal minX, maxX, minY, maxY;
+	/// The first and last points of the block, to connect neighbouring blocks when drawing.
+	qreal firstX, firstY, lastX, lastY;
+};
 
 
 /// This class acts as a proxy to emit signals for MPlotAbstractSeriesData. You can receive the dataChanged() signal by hooking up to MPlotAbstractSeries::signalSource().
@@ -20,6 +84,8 @@ class MPlotAbstractSeriesData;
   Implementations must do two things:
   1) Implement the virtual functions x(), y(), and count()
   2) Call emitDataChanged() whenever the count() or x/y values have changed.
+
+  If they can, implementations should describe the change more precisely by calling emitRowsAppended(), emitRowsRemovedFront(), emitValuesChanged() or emitDataReset() instead. These emit a specific signal, always followed by dataChanged(), so that receivers can update incrementally, while receivers that only connect to dataChanged() keep working.
   */
 class MPLOTSHARED_EXPORT MPlotSeriesDataSignalSource : public QObject {
 	Q_OBJECT
@@ -28,12 +94,25 @@ public:
 protected:
 	MPlotSeriesDataSignalSource(MPlotAbstractSeriesData* parent);
 	void emitDataChanged() { emit dataChanged(); }
+	void emitRowsAppended(int first, int last) { emit rowsAppended(first, last); }
+	void emitRowsRemovedFront(int count) { emit rowsRemovedFront(count); }
+	void emitValuesChanged(int first, int last) { emit valuesChanged(first, last); }
+	void emitDataReset() { emit dataReset(); }
 
 	MPlotAbstractSeriesData* data_;
 	friend class MPlotAbstractSeriesData;
 
 signals:
+	/// Notifier that the data has changed in any way. It's also emitted after each of the more specific signals below, so connecting only to this one is always enough.
 	void dataChanged();
+	/// Notifier that points \c first to \c last (inclusive) were added at the end. Nothing else changed.
+	void rowsAppended(int first, int last);
+	/// Notifier that the first \c count points were removed, so every other point moved down by \c count. Nothing else changed.
+	void rowsRemovedFront(int count);
+	/// Notifier that the x and/or y values of points \c first to \c last (inclusive) changed. The number of points did not change.
+	void valuesChanged(int first, int last);
+	/// Notifier that all the data was replaced.
+	void dataReset();
 };
 
 /// This defines the interface for classes which may be used for Series (XY scatter) plot data.
@@ -62,22 +141,59 @@ public:
 	/// Return the bounds of the data (the rectangle containing the max/min x- and y-values). It should be expressed as: QRectF(left, top, width, height) = QRectF(minX, minY, maxX-minX, maxY-minY);
 	/*! \todo Should we change this so that the QRectF's "top()" is actually maxY instead of minY?
 
-The base class implementation does a linear search through the data for the maximum and minimum values. It caches the result, and invalidates this result whenever the data changes (ie: emitDataChanged() is called). If you have a faster way of determining the bounds of the data, be sure to re-implement this. */
+The base class implementation does a single search through the data for the maximum and minimum x and y values (see MPlotMinMax::search(); NaN values are skipped). It caches the result, and invalidates this result whenever the data changes (ie: emitDataChanged() is called). If you have a faster way of determining the bounds of the data, be sure to re-implement this. */
 	virtual QRectF boundingRect() const;
 
+	/// Returns true if the x values are uniformly spaced, ie: x(i) = \c x0 + i*\c dx for every point, and sets \c x0 and \c dx.  The base class implementation returns false.
+	/*! Re-implement this if your x values are computed from the index.  Series like MPlotSeriesBasic use it to skip fetching and mapping the x values, and to find the points inside the visible x range directly. */
+	virtual bool uniformXSpacing(qreal& x0, qreal& dx) const { Q_UNUSED(x0) Q_UNUSED(dx) return false; }
+
+	/// Returns true if xValues() and yValues() can be called from several threads at once, which lets the boundingRect() search of large data use more than one thread.  The base class implementation returns false; re-implement if your model's reads don't modify anything.
+	virtual bool concurrentReadsSafe() const { return false; }
+
+	/// If the model keeps summaries of blocks of consecutive points, fills \c summaries with those of the blocks holding points \c first to \c last (in order; the first and last blocks can also hold points outside that range), and returns true.  The base class implementation returns false.
+	/*! Series like MPlotSeriesBasic use them to draw zoomed-out data without reading all the points: a block whose x values fall within one line width is drawn as one vertical line from its summary. */
+	virtual bool blockSummaries(int first, int last, QVector<MPlotSeriesBlockSummary>& summaries) const { Q_UNUSED(first) Q_UNUSED(last) Q_UNUSED(summaries) return false; }
+	/// Asks for points \c first to \c last to be made quick to read, and returns true if they already are.  The base class implementation returns true.
+	/*! Models that keep some of their points in slow storage (like MPlotTieredSeriesData) re-implement this to load them in the background, and announce them with valuesChanged() when they are ready.  Meanwhile, series can draw them from their blockSummaries(). */
+	virtual bool prefetch(int first, int last) const { Q_UNUSED(first) Q_UNUSED(last) return true; }
+	/// Returns a cache of x drawing coordinates shared with other data that has exactly the same x values, or 0 if there is none.  The base class implementation returns 0.
+	/*! Models holding several series on one set of x values (like MPlotSharedXSeriesTable) re-implement this, so that series drawing them on the same x axis map the x values once per paint pass instead of once each. */
+	virtual MPlotSharedXCache* sharedXCache() const { return 0; }
+
+	/// Returns an immutable copy of the data: see MPlotSeriesSnapshot.
+	/*! The base class implementation copies all the points, and keeps that copy until the data changes, so asking again without changes is O(1).  It must be called from the thread that modifies the data.  Models that are written from other threads (like MPlotSnapshotSeriesData) re-implement this to return their latest published version in O(1), from any thread. */
+	virtual MPlotSeriesSnapshot snapshot() const;
+	/// Returns a number that increases each time the data changes (ie: each time emitDataChanged() or one of the more specific emit functions is called).
+	quint64 dataVersion() const { return dataVersion_; }
+
 private:
 	MPlotSeriesDataSignalSource* signalSource_;
 	friend class MPlotSeriesDataSignalSource;
 
 protected:
 	/// Implementing classes should call this when their x- y- data changes in any way (ie: points added, points removed, or even values changed such that the bounds of the plot might be different.)
-	void emitDataChanged() { cachedDataRectUpdateRequired_ = true; signalSource_->emitDataChanged(); }
+	void emitDataChanged() { ++dataVersion_; cachedDataRectUpdateRequired_ = true; signalSource_->emitDataChanged(); }
+	/// Implementing classes should call this instead of emitDataChanged() after adding points \c first to \c last (inclusive) at the end.  Emits rowsAppended(), followed by dataChanged().  The cached boundingRect() is extended by searching only the new points.
+	void emitRowsAppended(int first, int last);
+	/// Implementing classes should call this instead of emitDataChanged() after removing the first \c count points.  Emits rowsRemovedFront(), followed by dataChanged().  If the caller knows that none of the removed points held an extreme, it can pass \c boundsUnchanged = true to keep the cached boundingRect().
+	void emitRowsRemovedFront(int count, bool boundsUnchanged = false) { ++dataVersion_; if(!boundsUnchanged) cachedDataRectUpdateRequired_ = true; signalSource_->emitRowsRemovedFront(count); signalSource_->emitDataChanged(); }
+	/// Implementing classes should call this instead of emitDataChanged() after changing the values of points \c first to \c last (inclusive).  Emits valuesChanged(), followed by dataChanged().  If the caller knows that neither the old nor the new values reach the cached bounds, it can pass \c boundsUnchanged = true to keep the cached boundingRect().
+	void emitValuesChanged(int first, int last, bool boundsUnchanged = false) { ++dataVersion_; if(!boundsUnchanged) cachedDataRectUpdateRequired_ = true; signalSource_->emitValuesChanged(first, last); signalSource_->emitDataChanged(); }
+	/// Implementing classes should call this instead of emitDataChanged() after replacing all the data.  Emits dataReset(), followed by dataChanged().
+	void emitDataReset() { ++dataVersion_; cachedDataRectUpdateRequired_ = true; signalSource_->emitDataReset(); signalSource_->emitDataChanged(); }
 
 protected:
 	/// Implements caching for the search-based version of boundingRect().
 	mutable QRectF cachedDataRect_;
 	/// Implements caching for the search-based version of boundingRect().
 	mutable bool cachedDataRectUpdateRequired_;
+	/// Incremented on every change. See dataVersion().
+	quint64 dataVersion_;
+	/// The copy returned by the base-class implementation of snapshot(), kept until dataVersion_ changes.
+	mutable MPlotSeriesSnapshot cachedSnapshot_;
+	/// Searches the x and y values in one pass, putting the results in \c xRange and \c yRange. Doesn't need a copy of the whole data (see MPlotMinMax::search()).
+	void searchMinMax(MPlotMinMax& xRange, MPlotMinMax& yRange) const;
 	/// Search for minimum Y value. Call only when count() > 0.
 	qreal searchMinY() const;
 	/// Search for extreme value. Call only when count() > 0.
@@ -89,9 +205,7 @@ protected:
 
 
 
-	// todo: to support multi-threading, consider a
-	// void pauseUpdates();	// to tell nothing to redraw using the plot because the data is currently invalid; a dataChanged will be emitted when it is valid again.
-							// This would need to be deterministic, so maybe we need to use function calls instead of signals.
+	// For multi-threading, readers use snapshot(), and data written from other threads goes through MPlotSnapshotSeriesData, which publishes whole versions instead of pausing updates.
 };
 
 
@@ -113,6 +227,8 @@ public:
 
 	/// Implements MPlotAbstractSeriesData: returns the number of data points.
 	virtual int count() const { return xValues_.count(); }
+	/// Re-implemented to return true: reading the vectors doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
 
 
 	/// Set the X and Y values. \c xValues and \c yValues must have the same size(); if not, this does nothing and returns false.
@@ -121,12 +237,82 @@ public:
 	bool setXValue(int index, qreal xValue);
 	/// Set a specific Y value. \c index must be in range for the current data, otherwise does nothing and returns false.
 	bool setYValue(int index, qreal yValue);
+	/// Set a run of X values, starting at \c startIndex. The run must be in range for the current data, otherwise does nothing and returns false.
+	bool setXValues(int startIndex, const QVector<qreal>& xValues);
+	/// Set a run of Y values, starting at \c startIndex. The run must be in range for the current data, otherwise does nothing and returns false.
+	bool setYValues(int startIndex, const QVector<qreal>& yValues);
+
+	/// Re-implemented to return the bounds from the extents index in constant time, when it's enabled.  Otherwise uses the base class search.
+	virtual QRectF boundingRect() const;
+
+	/// Returns true if the x and y values are tracked in an MPlotExtentsIndex.
+	bool extentsIndexEnabled() const { return extentsIndexEnabled_; }
+	/// Enables tracking the x and y values in an MPlotExtentsIndex (about 48 bytes more per point).  Then editing values with setXValue(), setYValue(), setXValues() or setYValues() updates the bounds in O(log n), instead of requiring a search of all the data on the next boundingRect().  Use it for interactive editing of large data (ex: dragging points).  Off by default.
+	void setExtentsIndexEnabled(bool enabled);
 
 
 
 protected:
 	QVector<qreal> xValues_;
 	QVector<qreal> yValues_;
+
+	/// Whether the extents indexes are used.
+	bool extentsIndexEnabled_;
+	/// Tracks the extremes of xValues_, when extentsIndexEnabled_.
+	MPlotExtentsIndex xExtents_;
+	/// Tracks the extremes of yValues_, when extentsIndexEnabled_.
+	MPlotExtentsIndex yExtents_;
+};
+
+
+/// This is an implementation of MPlotAbstractSeriesData for uniformly-sampled data. Only the y values are stored; the x values are computed as x(i) = x0() + i*dx().
+/*! This halves the memory needed compared to MPlotVectorSeriesData, and the x part of the boundingRect() is computed without searching.  It re-implements uniformXSpacing(), so MPlotSeriesBasic never fetches or maps the x values: it only reads the y values for the points inside the visible x range, which it finds with indexRangeForX(). */
+class MPLOTSHARED_EXPORT MPlotUniformSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructs an empty data model, with x values starting at \c x0 and spaced by \c dx.
+	MPlotUniformSeriesData(qreal x0 = 0, qreal dx = 1);
+
+	/// Implements MPlotAbstractSeriesData: returns the x value at \c index.
+	virtual qreal x(unsigned index) const { return x0_ + dx_*index; }
+	/// Computes the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const;
+	/// Implements MPlotAbstractSeriesData: returns the y value at \c index.
+	virtual qreal y(unsigned index) const { return yValues_.at(index); }
+	/// Copy all the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.  You can assume that the indexes are valid.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const { memcpy(outputValues, yValues_.constData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal)); }
+
+	/// Implements MPlotAbstractSeriesData: returns the number of data points.
+	virtual int count() const { return yValues_.count(); }
+
+	/// Re-implemented to compute the x bounds from x0() and dx(), and search only the y values.
+	virtual QRectF boundingRect() const;
+	/// Re-implemented to return true, with x0() and dx().
+	virtual bool uniformXSpacing(qreal& x0, qreal& dx) const { x0 = x0_; dx = dx_; return true; }
+	/// Re-implemented to return true: reading the vector doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+	/// Returns the x value of the first point.
+	qreal x0() const { return x0_; }
+	/// Returns the spacing between the x values.
+	qreal dx() const { return dx_; }
+	/// Sets the x value of the first point, and the spacing between the x values.
+	void setXSpacing(qreal x0, qreal dx);
+
+	/// Set the Y values.
+	void setYValues(const QVector<qreal>& yValues);
+	/// Set a specific Y value. \c index must be in range for the current data, otherwise does nothing and returns false.
+	bool setYValue(int index, qreal yValue);
+
+	/// Finds the points with x values inside [\c xMin, \c xMax], without searching.  Sets \c first and \c last to their indexes (inclusive) and returns true, or returns false if there are none.
+	bool indexRangeForX(qreal xMin, qreal xMax, int& first, int& last) const;
+
+protected:
+	QVector<qreal> yValues_;
+	/// The x value of the first point.
+	qreal x0_;
+	/// The spacing between the x values.
+	qreal dx_;
 };
 
 
@@ -168,14 +354,32 @@ public:
 	// This allows you to add data points at the end:
 	void insertPointBack(qreal x, qreal y);
 
+	// This adds \c count data points at the end, with a single rowsAppended() notification. Much faster than calling insertPointBack() for each point.
+	void insertPointsBack(const qreal* x, const qreal* y, int count);
+
 	// Remove a point at the front (Returns true if successful).
-	bool removePointFront();
+	bool removePointFront() { return removePointsFront(1) == 1; }
+
+	// Remove the first \c count points (or all of them, if there are fewer), with a single rowsRemovedFront() notification. Returns the number of points removed.
+	int removePointsFront(int count);
 
 	// Remove a point at the back (returns true if successful)
 	bool removePointBack();
 
 	virtual QRectF boundingRect() const;
 
+	/// Returns the retention policy. By default, all points are kept.
+	MPlotRetentionPolicy retentionPolicy() const { return retention_.policy(); }
+	/// Sets a retention policy: after every insert, the oldest points that don't fit the policy are removed from the front, all at once (one rowsRemovedFront() notification).  While a policy is set, the min/max record holders lost to eviction are found again in amortized constant time, instead of by searching the data.  The policy is applied to the current points right away.
+	void setRetentionPolicy(const MPlotRetentionPolicy& policy);
+	/// Removes the points that don't fit the retention policy now. (Inserting applies it automatically; call this from a timer if a maximum age must be enforced while no points arrive.)  Returns the number of points removed.
+	int applyRetention();
+
+	/// Returns true if editing values (setData()) uses an MPlotExtentsIndex to find the new extremes.
+	bool extentsIndexEnabled() const { return extentsIndexEnabled_; }
+	/// Enables an MPlotExtentsIndex over the x and y values, so that editing a point that was the minimum or maximum (ex: in a QTableView) costs O(log n) instead of a search of all the data.  The index is built on the first edit after points are inserted or removed, so appending stays fast.  Off by default.
+	void setExtentsIndexEnabled(bool enabled);
+
 	// TODO: add properties: set and read axis names
 
 protected:
@@ -190,6 +394,13 @@ protected:
 	//
 	QString xName_, yName_;
 
+	// Optional extents indexes, used for edits. They go stale when points are inserted or removed, and are rebuilt on the next edit.
+	bool extentsIndexEnabled_, extentsIndexStale_;
+	MPlotExtentsIndex xExtents_, yExtents_;
+
+	// Retention policy bookkeeping.
+	MPlotSeriesRetention retention_;
+
 
 	// Helper functions:
 	// Check if an added point @ index is the new min. or max record holder:
@@ -200,6 +411,8 @@ protected:
 	// Inserts the point (modifies the data array).
 	void minMaxChangeCheckX(qreal newVal, int index);
 	void minMaxChangeCheckY(qreal newVal, int index);
+	// Rebuilds the extents indexes if points were inserted or removed since they were built.
+	void updateExtentsIndex();
 
 	int searchMaxIndex(const QList<qreal>& list);
 
@@ -214,6 +427,89 @@ protected:
 };
 
 
+/// For models that keep their points in QVectors with a movable front (the first \c head slots hold points already removed): returns true when the \c head removed slots, out of \c size, should be moved out.  That's when they are all removed, or at least 64 and the larger half; waiting until then makes the move amortized O(1) per point.
+inline bool MPlotFrontCompactionDue(int head, int size) { return head >= size || (head >= 64 && 2*head >= size); }
+
+/// Removes the first \c count slots of \c values, releasing the memory if that is all of them.  Call it on each vector sharing the movable front when MPlotFrontCompactionDue(), and then reset the front to 0.
+template<typename T>
+inline void MPlotRemoveFront(QVector<T>& values, int count) {
+	if(count >= values.size())
+		values.clear();
+	else
+		values.remove(0, count);
+}
+
+
+/// This class is a real-time series model with the same insert / remove interface as MPlotRealtimeModel, but without the QAbstractItemModel machinery (row insert/remove notifications, persistent indexes, header data) on every point.
+/*! Use it when the data only goes to plots.  To also show it in a QTableView, wrap it in an MPlotSeriesTableModel, which batches the row notifications.
+
+The points are kept in two contiguous QVectors with a movable front, so appending and removing points from the front are amortized constant-time, and xValues() and yValues() are straight copies.  The cached boundingRect() is extended incrementally when points are appended, and kept when points are removed or changed without touching the extremes; only removing or changing a point that held an extreme costs a new search. */
+class MPLOTSHARED_EXPORT MPlotRealtimeSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructor. Creates an empty model.
+	MPlotRealtimeSeriesData();
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const { return xval_.at(head_+index); }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the y value at \c index.
+	virtual qreal y(unsigned index) const { return yval_.at(head_+index); }
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points.
+	virtual int count() const { return xval_.size()-head_; }
+	/// Re-implemented to return true: reading doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+	/// Adds a point at the beginning.
+	void insertPointFront(qreal x, qreal y);
+	/// Adds a point at the end.
+	void insertPointBack(qreal x, qreal y);
+	/// Adds \c count points at the end, with a single rowsAppended() notification.
+	void insertPointsBack(const qreal* x, const qreal* y, int count);
+	/// Removes the first point. Returns false if there are no points.
+	bool removePointFront() { return removePointsFront(1) == 1; }
+	/// Removes the first \c count points (or all of them, if there are fewer), with a single rowsRemovedFront() notification.  Returns the number of points removed.
+	int removePointsFront(int count);
+	/// Removes the last point. Returns false if there are no points.
+	bool removePointBack();
+	/// Removes all the points.
+	void clear();
+
+	/// Sets the x value at \c index.
+	void setX(int index, qreal x);
+	/// Sets the y value at \c index.
+	void setY(int index, qreal y);
+
+	/// Re-implemented to track the bounds with sliding extremes while a retention policy is set.
+	virtual QRectF boundingRect() const;
+
+	/// Returns the retention policy. By default, all points are kept.
+	MPlotRetentionPolicy retentionPolicy() const { return retention_.policy(); }
+	/// Sets a retention policy: after every insert, the oldest points that don't fit the policy are removed from the front, all at once (one rowsRemovedFront() notification).  While a policy is set, boundingRect() is kept up to date in amortized constant time.  The policy is applied to the current points right away.
+	void setRetentionPolicy(const MPlotRetentionPolicy& policy);
+	/// Removes the points that don't fit the retention policy now. (Inserting applies it automatically; call this from a timer if a maximum age must be enforced while no points arrive.)  Returns the number of points removed.
+	int applyRetention();
+
+protected:
+	/// The x values. Points start at head_.
+	QVector<qreal> xval_;
+	/// The y values. Points start at head_.
+	QVector<qreal> yval_;
+	/// Storage index of the first point. Slots before it were removed from the front, and are reclaimed by compact().
+	int head_;
+	/// Retention policy bookkeeping.
+	MPlotSeriesRetention retention_;
+
+	/// Returns true if \c value, in the x (\c isX) or y direction, is on or outside the cached bounds, ie: it could be (or have been) an extreme.  Always true when the cached bounds are out of date.
+	bool reachesBounds(qreal value, bool isX) const;
+	/// Moves the points back to the start of the storage, once the removed slots make up more than half of it.
+	void compact();
+};
+
+
 
 
 
@@ -0,0 +1,119 @@
+#ifndef MPLOTSERIESHISTOGRAM_CPP
+#define MPLOTSERIESHISTOGRAM_CPP
+
+#include "MPlot/MPlotSeriesHistogram.h"
+
+#include <QPainter>
+#include <QDebug>
+
+#include <math.h>
+
+MPlotSeriesHistogram::MPlotSeriesHistogram(const MPlotHistogramSeriesData *data)
+	: MPlotAbstractSeries()
+{
+	// Set style defaults: the bars are a see-through version of the line color, and there are no markers.
+	setDefaults();
+	setMarker(MPlotMarkerShape::None);
+
+	QColor barColor = linePen_.color();
+	barColor.setAlphaF(0.5);
+	barBrush_ = QBrush(barColor);
+
+	setModel(data);
+}
+
+MPlotSeriesHistogram::~MPlotSeriesHistogram()
+{
+}
+
+void MPlotSeriesHistogram::setBarBrush(const QBrush &brush)
+{
+	barBrush_ = brush;
+	update();
+}
+
+QRectF MPlotSeriesHistogram::boundingRect() const
+{
+	QRectF br = MPlotAbstractSeries::boundingRect();
+
+	// room for the selection highlight.
+	if(br.isValid())
+		br.adjust(-MPLOT_SELECTION_LINEWIDTH, -MPLOT_SELECTION_LINEWIDTH, MPLOT_SELECTION_LINEWIDTH, MPLOT_SELECTION_LINEWIDTH);
+
+	return br;
+}
+
+void MPlotSeriesHistogram::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+
+	if(!yAxisTarget() || !xAxisTarget()) {
+		qWarning() << "MPlotSeriesHistogram: No axis scale set. Abandoning painting because we don't know what scale to use.";
+		return;
+	}
+
+	const MPlotHistogramSeriesData* histogram = this->histogram();
+	if(!histogram || histogram->count() == 0)
+		return;
+
+	// same column width as the sub-pixel simplification of MPlotSeriesBasic.
+	QTransform wt = painter->deviceTransform();
+	qreal xinc = 1.0 / wt.m11() / MPLOT_MAX_LINES_PER_PIXEL;
+
+	QVector<QRectF> bars;
+	buildBars(histogram, xinc, bars);
+	if(bars.isEmpty())
+		return;
+
+	if(selected()) {
+		painter->setPen(selectedPen_);
+		painter->setBrush(QBrush());
+		painter->drawRects(bars.constData(), bars.size());
+	}
+	painter->setPen(linePen_);
+	painter->setBrush(barBrush_);
+	painter->drawRects(bars.constData(), bars.size());
+	painter->setBrush(QBrush());
+}
+
+void MPlotSeriesHistogram::buildBars(const MPlotHistogramSeriesData *histogram, qreal xinc, QVector<QRectF> &bars) const
+{
+	int count = histogram->count();
+	bars.clear();
+	bars.reserve(count);
+
+	qreal offsetX = dx_+offset_.x(), offsetY = dy_+offset_.y();
+	qreal base = mapY(offsetY);
+
+	for(int i=0; i<count; ++i) {
+		qreal binCount = histogram->y(i);
+		if(binCount <= 0)
+			continue;
+
+		// (the axes can be flipped: normalized() sorts the corners.)
+		QRectF bar = QRectF(QPointF(mapX(histogram->binLeft(i)*sx_+offsetX), mapY(binCount*sy_+offsetY)),
+							QPointF(mapX(histogram->binRight(i)*sx_+offsetX), base)).normalized();
+
+		// within xinc of the previous bar: part of it.
+		if(!bars.isEmpty() && fabs(bar.left() - bars.last().left()) < xinc)
+			bars.last() = bars.last().united(bar);
+		else
+			bars << bar;
+	}
+}
+
+void MPlotSeriesHistogram::setSelected(bool selected)
+{
+	bool wasSelected = isSelected();
+	MPlotItem::setSelected(selected);
+	if(isSelected() != wasSelected)
+		update();
+}
+
+void MPlotSeriesHistogram::onDataChanged()
+{
+	update();
+}
+
+#endif // MPLOTSERIESHISTOGRAM_CPP
@@ -0,0 +1,53 @@
+#ifndef MPLOTSERIESHISTOGRAM_H
+#define MPLOTSERIESHISTOGRAM_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeries.h"
+#include "MPlot/MPlotHistogramSeriesData.h"
+
+#include <QBrush>
+#include <QVector>
+#include <QRectF>
+
+/// MPlotSeriesHistogram draws a histogram (see MPlotHistogramSeriesData) as bars, from 0 up to the count of each bin, between the bin edges.
+/*! All the bars are drawn with one QPainter::drawRects() call.  Empty bins are left out, and bins narrower than 1/MPLOT_MAX_LINES_PER_PIXEL pixels are drawn together as one bar as high as the highest of them, so the cost of a paint is bounded by the width of the plot when there are many bins.
+
+The bars are filled with barBrush(), and outlined with linePen().  Markers are not drawn.  The model must be an MPlotHistogramSeriesData; with any other model, nothing is drawn. */
+class MPLOTSHARED_EXPORT MPlotSeriesHistogram : public MPlotAbstractSeries {
+
+public:
+	/// Constructor. Draws the histogram in \c data.
+	MPlotSeriesHistogram(const MPlotHistogramSeriesData* data = 0);
+	/// Destructor.
+	virtual ~MPlotSeriesHistogram();
+
+	/// Returns the model as a histogram, or 0 if it isn't.
+	const MPlotHistogramSeriesData* histogram() const { return dynamic_cast<const MPlotHistogramSeriesData*>(data_); }
+
+	/// Returns the brush used to fill the bars.
+	QBrush barBrush() const { return barBrush_; }
+	/// Sets the brush used to fill the bars.
+	void setBarBrush(const QBrush& brush);
+
+	/// boundingRect: using parent implementation, but adding extra room on edges for our selection highlight.
+	virtual QRectF boundingRect() const;
+	/// Paints the bars.
+	virtual void paint(QPainter* painter,
+					   const QStyleOptionGraphicsItem* option,
+					   QWidget* widget);
+
+	/// re-implemented from MPlotItem base to draw an update if we're now selected (with our selection highlight)
+	virtual void setSelected(bool selected = true);
+
+protected:
+	/// Fills \c bars with the bars of \c histogram in drawing coordinates, merging the ones within \c xinc of each other.
+	void buildBars(const MPlotHistogramSeriesData* histogram, qreal xinc, QVector<QRectF>& bars) const;
+
+	/// Handle implementation-specific drawing updates
+	virtual void onDataChanged();
+
+	/// Brush used to fill the bars.
+	QBrush barBrush_;
+};
+
+#endif // MPLOTSERIESHISTOGRAM_H
@@ -0,0 +1,189 @@
+#ifndef MPLOTSERIESRETENTION_CPP
+#define MPLOTSERIESRETENTION_CPP
+
+#include "MPlot/MPlotSeriesRetention.h"
+#include "MPlot/MPlotSeriesData.h"
+
+#include <qnumeric.h>
+#include <limits>
+
+MPlotSeriesRetention::MPlotSeriesRetention()
+{
+	firstNumber_ = 0;
+	extremaValid_ = false;
+	timesHead_ = 0;
+	clock_.start();
+}
+
+void MPlotSeriesRetention::setPolicy(const MPlotRetentionPolicy &policy, const MPlotAbstractSeriesData *data)
+{
+	bool hadAge = policy_.maximumAge() > 0;
+	policy_ = policy;
+
+	if(policy_.maximumAge() > 0 && !hadAge) {
+		times_.fill(now(), data->count());
+		timesHead_ = 0;
+	}
+	else if(policy_.maximumAge() <= 0) {
+		times_.clear();
+		timesHead_ = 0;
+	}
+
+	extremaValid_ = false;
+}
+
+int MPlotSeriesRetention::evictionCount(const MPlotAbstractSeriesData *data) const
+{
+	int size = data->count();
+	if(!policy_.isEnabled() || size == 0)
+		return 0;
+
+	int evict = 0;
+
+	if(policy_.maximumCount() > 0)
+		evict = qMax(evict, size - policy_.maximumCount());
+
+	// the next two scan from the front, past the points already to be evicted: each point is looked at about once before it goes.
+	if(policy_.maximumXSpan() > 0) {
+		qreal oldestX = data->x(size-1) - policy_.maximumXSpan();
+		while(evict < size-1 && data->x(evict) < oldestX)
+			++evict;
+	}
+
+	if(policy_.maximumAge() > 0) {
+		qint64 oldestTime = now() - policy_.maximumAge();
+		while(evict < size && times_.at(timesHead_+evict) < oldestTime)
+			++evict;
+	}
+
+	return evict;
+}
+
+QRectF MPlotSeriesRetention::boundingRect(const MPlotAbstractSeriesData *data) const
+{
+	if(data->count() == 0)
+		return QRectF();
+
+	if(!extremaValid_)
+		rebuildExtrema(data);
+
+	qreal minX = xExtrema_.minimum(), maxX = xExtrema_.maximum();
+	qreal minY = yExtrema_.minimum(), maxY = yExtrema_.maximum();
+	// only NaN values? (they're tracked as +inf minimums and -inf maximums, which never win.) Report NaN like MPlotMinMax does.
+	if(minX > maxX)
+		minX = maxX = std::numeric_limits<qreal>::quiet_NaN();
+	if(minY > maxY)
+		minY = maxY = std::numeric_limits<qreal>::quiet_NaN();
+
+	return QRectF(minX,
+				  minY,
+				  qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+				  qMax(maxY-minY, std::numeric_limits<qreal>::min()));	// same as MPlotAbstractSeriesData::boundingRect(): keep a single point valid.
+}
+
+void MPlotSeriesRetention::extremeIndexes(const MPlotAbstractSeriesData *data, int &minXIndex, int &maxXIndex, int &minYIndex, int &maxYIndex) const
+{
+	if(data->count() == 0) {
+		minXIndex = maxXIndex = minYIndex = maxYIndex = -1;
+		return;
+	}
+
+	if(!extremaValid_)
+		rebuildExtrema(data);
+
+	minXIndex = int(xExtrema_.minimumIndex() - firstNumber_);
+	maxXIndex = int(xExtrema_.maximumIndex() - firstNumber_);
+	minYIndex = int(yExtrema_.minimumIndex() - firstNumber_);
+	maxYIndex = int(yExtrema_.maximumIndex() - firstNumber_);
+}
+
+void MPlotSeriesRetention::appended(const MPlotAbstractSeriesData *data, int count)
+{
+	if(count < 1)
+		return;
+
+	if(policy_.maximumAge() > 0) {
+		qint64 time = now();
+		for(int i=0; i<count; ++i)
+			times_.append(time);
+	}
+
+	if(extremaValid_) {
+		int size = data->count();
+		for(int i=size-count; i<size; ++i)
+			appendExtrema(data->x(i), data->y(i));
+	}
+}
+
+void MPlotSeriesRetention::removedFront(int count)
+{
+	if(policy_.maximumAge() > 0) {
+		timesHead_ += count;
+		// reclaim the dead times once they are the majority, like MPlotSlidingExtrema does.
+		if(timesHead_ > 32 && 2*timesHead_ > times_.size()) {
+			times_.remove(0, timesHead_);
+			timesHead_ = 0;
+		}
+	}
+
+	if(extremaValid_) {
+		firstNumber_ += count;
+		xExtrema_.expireBefore(firstNumber_);
+		yExtrema_.expireBefore(firstNumber_);
+	}
+}
+
+void MPlotSeriesRetention::insertedFront()
+{
+	if(policy_.maximumAge() > 0) {
+		if(timesHead_ > 0)
+			times_[--timesHead_] = now();
+		else
+			times_.prepend(now());
+	}
+	extremaValid_ = false;
+}
+
+void MPlotSeriesRetention::removedBack()
+{
+	if(policy_.maximumAge() > 0 && times_.size() > timesHead_)
+		times_.resize(times_.size()-1);
+	extremaValid_ = false;
+}
+
+void MPlotSeriesRetention::cleared()
+{
+	times_.clear();
+	timesHead_ = 0;
+	extremaValid_ = false;
+}
+
+void MPlotSeriesRetention::appendExtrema(qreal x, qreal y) const
+{
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+
+	if(qIsNaN(x))
+		xExtrema_.append(infinity, -infinity);
+	else
+		xExtrema_.append(x);
+
+	if(qIsNaN(y))
+		yExtrema_.append(infinity, -infinity);
+	else
+		yExtrema_.append(y);
+}
+
+void MPlotSeriesRetention::rebuildExtrema(const MPlotAbstractSeriesData *data) const
+{
+	xExtrema_.clear();
+	yExtrema_.clear();
+	firstNumber_ = 0;
+
+	int size = data->count();
+	for(int i=0; i<size; ++i)
+		appendExtrema(data->x(i), data->y(i));
+
+	extremaValid_ = true;
+}
+
+#endif // MPLOTSERIESRETENTION_CPP
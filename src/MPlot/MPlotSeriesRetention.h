@@ -0,0 +1,106 @@
+#ifndef MPLOTSERIESRETENTION_H
+#define MPLOTSERIESRETENTION_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSlidingExtrema.h"
+
+#include <QVector>
+#include <QRectF>
+#include <QElapsedTimer>
+
+class MPlotAbstractSeriesData;
+
+/// This class describes how much history a real-time series model keeps: at most a number of points, at most a span of x values, and/or points no older than an age.
+/*! Each limit is off when it is 0 (the default), and the model keeps the points that satisfy all the limits that are on.  The x span is measured back from the x value of the last point, so it assumes that x increases along the series (ex: x is time).  The age is measured from when each point was inserted into the model. */
+class MPLOTSHARED_EXPORT MPlotRetentionPolicy {
+public:
+	/// Constructor. A policy with all limits off keeps everything.
+	MPlotRetentionPolicy(int maximumCount = 0, qreal maximumXSpan = 0, qint64 maximumAge = 0)
+		: maximumCount_(maximumCount), maximumXSpan_(maximumXSpan), maximumAge_(maximumAge) {}
+
+	/// Returns the maximum number of points to keep, or 0 for no limit.
+	int maximumCount() const { return maximumCount_; }
+	/// Sets the maximum number of points to keep (0 for no limit).
+	void setMaximumCount(int maximumCount) { maximumCount_ = maximumCount; }
+	/// Returns the span of x values to keep, or 0 for no limit.
+	qreal maximumXSpan() const { return maximumXSpan_; }
+	/// Keeps only the points with x >= (x of the last point) - \c maximumXSpan (0 for no limit).
+	void setMaximumXSpan(qreal maximumXSpan) { maximumXSpan_ = maximumXSpan; }
+	/// Returns the maximum age of the points to keep, in milliseconds, or 0 for no limit.
+	qint64 maximumAge() const { return maximumAge_; }
+	/// Keeps only the points inserted in the last \c maximumAge milliseconds (0 for no limit).
+	void setMaximumAge(qint64 maximumAge) { maximumAge_ = maximumAge; }
+
+	/// Returns true if any limit is on.
+	bool isEnabled() const { return maximumCount_ > 0 || maximumXSpan_ > 0 || maximumAge_ > 0; }
+
+protected:
+	int maximumCount_;
+	qreal maximumXSpan_;
+	qint64 maximumAge_;
+};
+
+
+/// This class does the bookkeeping for real-time series models that apply an MPlotRetentionPolicy.
+/*! The model tells it about every change to its points, in order: appended() for points added at the end, removedFront() for points removed from the front, and insertedFront(), removedBack(), valuesChanged() or cleared() for the rest.  In return, it works out how many points to evict after an insert (evictionCount()), and tracks the bounds of the points in amortized constant time (boundingRect()), using an MPlotSlidingExtrema for each axis.
+
+The sliding extremes only handle points appended at the end and removed from the front, which is what a retention window does.  Any other change marks them out of date, and they are rebuilt from the data on the next boundingRect() (O(n), once).  The insertion times are only recorded while the policy has a maximum age.  NaN values are skipped. */
+class MPLOTSHARED_EXPORT MPlotSeriesRetention {
+public:
+	/// Constructor. The policy is off.
+	MPlotSeriesRetention();
+
+	/// Returns the policy.
+	MPlotRetentionPolicy policy() const { return policy_; }
+	/// Sets the policy. Call evictionCount() afterward to apply it to the points already there.  The points already there count as inserted now, if they didn't have an insertion time.
+	void setPolicy(const MPlotRetentionPolicy& policy, const MPlotAbstractSeriesData* data);
+	/// Returns true if the policy is on.
+	bool isEnabled() const { return policy_.isEnabled(); }
+
+	/// Returns how many points to remove from the front of \c data to satisfy the policy.  The model should remove them and call removedFront().
+	int evictionCount(const MPlotAbstractSeriesData* data) const;
+	/// Returns the bounds of the points in \c data, the same way as MPlotAbstractSeriesData::boundingRect(), in amortized constant time.
+	QRectF boundingRect(const MPlotAbstractSeriesData* data) const;
+	/// Finds the indexes of the points in \c data holding the minimum and maximum x and y values, in amortized constant time.  They are -1 if there are no points.
+	void extremeIndexes(const MPlotAbstractSeriesData* data, int& minXIndex, int& maxXIndex, int& minYIndex, int& maxYIndex) const;
+
+	/// Call after appending \c count points at the end of \c data.
+	void appended(const MPlotAbstractSeriesData* data, int count);
+	/// Call after removing \c count points from the front.
+	void removedFront(int count);
+	/// Call after inserting a point at the front.
+	void insertedFront();
+	/// Call after removing the last point.
+	void removedBack();
+	/// Call after changing values (without adding or removing points).
+	void valuesChanged() { extremaValid_ = false; }
+	/// Call after removing all the points.
+	void cleared();
+
+protected:
+	/// Appends the point \c x, \c y to the sliding extremes, with NaNs never winning.
+	void appendExtrema(qreal x, qreal y) const;
+	/// Rebuilds the sliding extremes from all the points of \c data.
+	void rebuildExtrema(const MPlotAbstractSeriesData* data) const;
+	/// Returns the current time of the clock, in milliseconds.
+	qint64 now() const { return clock_.elapsed(); }
+
+	/// The policy.
+	MPlotRetentionPolicy policy_;
+
+	/// Sliding extremes of the x and y values.
+	mutable MPlotSlidingExtrema xExtrema_, yExtrema_;
+	/// MPlotSlidingExtrema number of the first point.
+	mutable qint64 firstNumber_;
+	/// False when the sliding extremes must be rebuilt.
+	mutable bool extremaValid_;
+
+	/// Insertion time of each point (only while the policy has a maximum age), starting at timesHead_.
+	QVector<qint64> times_;
+	/// Index in times_ of the first point's time.
+	int timesHead_;
+	/// Clock for the insertion times.
+	QElapsedTimer clock_;
+};
+
+#endif // MPLOTSERIESRETENTION_H
@@ -0,0 +1,210 @@
+#ifndef MPLOTSERIESTABLEMODEL_CPP
+#define MPLOTSERIESTABLEMODEL_CPP
+
+#include "MPlot/MPlotSeriesTableModel.h"
+#include "MPlot/MPlotSeriesData.h"
+
+#include <QTimer>
+
+MPlotSeriesTableModel::MPlotSeriesTableModel(MPlotAbstractSeriesData *data, QObject *parent)
+	: QAbstractTableModel(parent), xName_("x"), yName_("y")
+{
+	data_ = 0;
+	rowCount_ = 0;
+	pendingAppended_ = 0;
+	pendingChangedFirst_ = pendingChangedLast_ = -1;
+	changeDescribed_ = false;
+	notificationInterval_ = MPLOT_SERIES_TABLE_NOTIFY_INTERVAL;
+
+	notificationTimer_ = new QTimer(this);
+	notificationTimer_->setSingleShot(true);
+	connect(notificationTimer_, SIGNAL(timeout()), this, SLOT(flushNotifications()));
+
+	setSeriesData(data);
+}
+
+MPlotSeriesTableModel::~MPlotSeriesTableModel()
+{
+}
+
+void MPlotSeriesTableModel::setSeriesData(MPlotAbstractSeriesData *data)
+{
+	beginResetModel();
+
+	if(data_)
+		disconnect(data_->signalSource(), 0, this, 0);
+
+	data_ = data;
+	rowCount_ = data_ ? data_->count() : 0;
+	pendingAppended_ = 0;
+	pendingChangedFirst_ = pendingChangedLast_ = -1;
+	changeDescribed_ = false;
+	notificationTimer_->stop();
+
+	if(data_) {
+		MPlotSeriesDataSignalSource* source = data_->signalSource();
+		connect(source, SIGNAL(rowsAppended(int,int)), this, SLOT(onRowsAppended(int,int)));
+		connect(source, SIGNAL(rowsRemovedFront(int)), this, SLOT(onRowsRemovedFront(int)));
+		connect(source, SIGNAL(valuesChanged(int,int)), this, SLOT(onValuesChanged(int,int)));
+		connect(source, SIGNAL(dataReset()), this, SLOT(onDataReset()));
+		connect(source, SIGNAL(dataChanged()), this, SLOT(onDataChanged()));
+		connect(source, SIGNAL(destroyed()), this, SLOT(onSignalSourceDestroyed()));
+	}
+
+	endResetModel();
+}
+
+void MPlotSeriesTableModel::setColumnNames(const QString &xName, const QString &yName)
+{
+	xName_ = xName;
+	yName_ = yName;
+	emit headerDataChanged(Qt::Horizontal, 0, 1);
+}
+
+int MPlotSeriesTableModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : rowCount_;
+}
+
+int MPlotSeriesTableModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : 2;
+}
+
+QVariant MPlotSeriesTableModel::data(const QModelIndex &index, int role) const
+{
+	if(!data_ || !index.isValid() || role != Qt::DisplayRole || index.row() >= rowCount_)
+		return QVariant();
+
+	if(index.column() == 0)
+		return data_->x(index.row());
+	if(index.column() == 1)
+		return data_->y(index.row());
+
+	return QVariant();
+}
+
+QVariant MPlotSeriesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if(role != Qt::DisplayRole)
+		return QVariant();
+
+	if(orientation == Qt::Vertical)
+		return section;
+
+	if(section == 0)
+		return xName_;
+	if(section == 1)
+		return yName_;
+	return QVariant();
+}
+
+void MPlotSeriesTableModel::flushNotifications()
+{
+	notificationTimer_->stop();
+
+	if(pendingAppended_ > 0) {
+		beginInsertRows(QModelIndex(), rowCount_, rowCount_+pendingAppended_-1);
+		rowCount_ += pendingAppended_;
+		pendingAppended_ = 0;
+		endInsertRows();
+	}
+
+	if(pendingChangedFirst_ >= 0) {
+		QModelIndex topLeft = index(pendingChangedFirst_, 0);
+		QModelIndex bottomRight = index(pendingChangedLast_, 1);
+		pendingChangedFirst_ = pendingChangedLast_ = -1;
+		emit QAbstractItemModel::dataChanged(topLeft, bottomRight);
+	}
+}
+
+void MPlotSeriesTableModel::onRowsAppended(int first, int last)
+{
+	changeDescribed_ = true;
+	pendingAppended_ += last-first+1;
+	scheduleNotifications();
+}
+
+void MPlotSeriesTableModel::onRowsRemovedFront(int count)
+{
+	changeDescribed_ = true;
+
+	// the removed points are the first rows the views know about, and then (if there were more) some of the pending appended ones.
+	int shownRemoved = qMin(count, rowCount_);
+	if(shownRemoved > 0) {
+		beginRemoveRows(QModelIndex(), 0, shownRemoved-1);
+		rowCount_ -= shownRemoved;
+		endRemoveRows();
+	}
+	pendingAppended_ = qMax(0, pendingAppended_ - (count-shownRemoved));
+
+	if(pendingChangedFirst_ >= 0) {
+		pendingChangedFirst_ = qMax(0, pendingChangedFirst_-count);
+		pendingChangedLast_ -= count;
+		if(pendingChangedLast_ < 0)
+			pendingChangedFirst_ = pendingChangedLast_ = -1;
+	}
+}
+
+void MPlotSeriesTableModel::onValuesChanged(int first, int last)
+{
+	changeDescribed_ = true;
+
+	// changes to rows that are still pending will be seen when they are inserted.
+	last = qMin(last, rowCount_-1);
+	if(first > last)
+		return;
+
+	if(pendingChangedFirst_ < 0) {
+		pendingChangedFirst_ = first;
+		pendingChangedLast_ = last;
+	}
+	else {
+		pendingChangedFirst_ = qMin(pendingChangedFirst_, first);
+		pendingChangedLast_ = qMax(pendingChangedLast_, last);
+	}
+	scheduleNotifications();
+}
+
+void MPlotSeriesTableModel::onDataReset()
+{
+	changeDescribed_ = true;
+
+	beginResetModel();
+	rowCount_ = data_ ? data_->count() : 0;
+	pendingAppended_ = 0;
+	pendingChangedFirst_ = pendingChangedLast_ = -1;
+	notificationTimer_->stop();
+	endResetModel();
+}
+
+void MPlotSeriesTableModel::onDataChanged()
+{
+	// the specific signals are always followed by dataChanged(); only an undescribed change needs handling here.
+	if(changeDescribed_) {
+		changeDescribed_ = false;
+		return;
+	}
+
+	onDataReset();
+	changeDescribed_ = false;
+}
+
+void MPlotSeriesTableModel::onSignalSourceDestroyed()
+{
+	beginResetModel();
+	data_ = 0;
+	rowCount_ = 0;
+	pendingAppended_ = 0;
+	pendingChangedFirst_ = pendingChangedLast_ = -1;
+	notificationTimer_->stop();
+	endResetModel();
+}
+
+void MPlotSeriesTableModel::scheduleNotifications()
+{
+	if(!notificationTimer_->isActive())
+		notificationTimer_->start(notificationInterval_);
+}
+
+#endif // MPLOTSERIESTABLEMODEL_CPP
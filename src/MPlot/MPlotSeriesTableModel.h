@@ -0,0 +1,92 @@
+#ifndef MPLOTSERIESTABLEMODEL_H
+#define MPLOTSERIESTABLEMODEL_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QAbstractTableModel>
+#include <QString>
+
+class QTimer;
+class MPlotAbstractSeriesData;
+
+/// The default delay, in milliseconds, that an MPlotSeriesTableModel collects changes before notifying its views.
+#define MPLOT_SERIES_TABLE_NOTIFY_INTERVAL 100
+
+/// This class shows any MPlotAbstractSeriesData as a read-only, two-column (x, y) QAbstractTableModel, for use in a QTableView.
+/*! Series models like MPlotRealtimeSeriesData don't carry the QAbstractItemModel machinery themselves; create this adapter only when a view needs it.
+
+Changes to the data are collected, and announced to the views at most once every notificationInterval() ms: all the points appended meanwhile become one rowsInserted(), changed values one dataChanged() over the rows they span, and so on.  Until then, rowCount() keeps reporting the rows the views already know about.  Removing points from the front, or replacing all the data, is announced right away, because the rows the views know about are no longer valid.
+
+The adapter follows the data's signalSource(), and becomes empty if the data is deleted. */
+class MPLOTSHARED_EXPORT MPlotSeriesTableModel : public QAbstractTableModel {
+	Q_OBJECT
+
+public:
+	/// Constructor. Shows \c data, which can be 0.
+	MPlotSeriesTableModel(MPlotAbstractSeriesData* data = 0, QObject* parent = 0);
+	/// Destructor.
+	virtual ~MPlotSeriesTableModel();
+
+	/// Returns the data shown.
+	MPlotAbstractSeriesData* seriesData() const { return data_; }
+	/// Shows \c data instead (or nothing, if 0).
+	void setSeriesData(MPlotAbstractSeriesData* data);
+
+	/// Sets the column headers. They are "x" and "y" by default.
+	void setColumnNames(const QString& xName, const QString& yName);
+
+	/// Returns the delay, in milliseconds, during which changes are collected before notifying the views.
+	int notificationInterval() const { return notificationInterval_; }
+	/// Sets the delay during which changes are collected before notifying the views. 0 notifies once control returns to the event loop.
+	void setNotificationInterval(int milliseconds) { notificationInterval_ = milliseconds; }
+
+	/// Returns the number of rows the views know about.
+	virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
+	/// Returns 2: x and y.
+	virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
+	/// Returns the x (column 0) or y (column 1) value of a point, for Qt::DisplayRole.
+	virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+	/// Returns the column names, and the point numbers as row headers.
+	virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+public slots:
+	/// Notifies the views of all the collected changes now.
+	void flushNotifications();
+
+protected slots:
+	/// Collects points appended to the data.
+	void onRowsAppended(int first, int last);
+	/// Announces points removed from the front of the data.
+	void onRowsRemovedFront(int count);
+	/// Collects changed values.
+	void onValuesChanged(int first, int last);
+	/// Announces that all the data was replaced.
+	void onDataReset();
+	/// Handles changes that weren't described more precisely, like onDataReset().
+	void onDataChanged();
+	/// Forgets the data when it is deleted.
+	void onSignalSourceDestroyed();
+
+protected:
+	/// Starts the notification timer, if it isn't running.
+	void scheduleNotifications();
+
+	/// The data shown.
+	MPlotAbstractSeriesData* data_;
+	/// Column headers.
+	QString xName_, yName_;
+	/// Number of rows the views know about.
+	int rowCount_;
+	/// Number of points appended since the last notification.
+	int pendingAppended_;
+	/// Range of rows (in the views' numbering) with changed values since the last notification, or -1 if none.
+	int pendingChangedFirst_, pendingChangedLast_;
+	/// True while the data signal being handled was already described by a more specific one, so the following dataChanged() can be ignored.
+	bool changeDescribed_;
+	/// Delay for collecting changes.
+	int notificationInterval_;
+	/// Single-shot timer for collecting changes.
+	QTimer* notificationTimer_;
+};
+
+#endif // MPLOTSERIESTABLEMODEL_H
@@ -0,0 +1,267 @@
+#ifndef MPLOTSHAREDXSERIESTABLE_CPP
+#define MPLOTSHAREDXSERIESTABLE_CPP
+
+#include "MPlot/MPlotSharedXSeriesTable.h"
+
+#include <string.h>
+
+MPlotSharedXCache::Entry & MPlotSharedXCache::entry(const qreal *key)
+{
+	for(int i=0, size=entries_.size(); i<size; ++i) {
+		if(memcmp(entries_.at(i).key, key, sizeof(entries_.at(i).key)) == 0) {
+			if(i > 0)
+				entries_.move(i, 0);
+			return entries_.first();
+		}
+	}
+
+	Entry entry;
+	memcpy(entry.key, key, sizeof(entry.key));
+	entries_.prepend(entry);
+	while(entries_.size() > MPLOT_SHARED_X_CACHE_ENTRIES)
+		entries_.removeLast();
+
+	return entries_.first();
+}
+
+void MPlotSharedXCache::removeFront(int count)
+{
+	for(int i=0, size=entries_.size(); i<size; ++i) {
+		Entry& entry = entries_[i];
+		entry.transformedX.remove(0, qMin(count, entry.transformedX.size()));
+		entry.mappedX.remove(0, qMin(count, entry.mappedX.size()));
+	}
+}
+
+
+/// Provides a contiguous array of values to MPlotMinMax::search().
+class MPlotSharedXMinMaxSource : public MPlotMinMaxSource {
+public:
+	MPlotSharedXMinMaxSource(const qreal* values, int count) : values_(values), count_(count) {}
+
+	virtual qint64 units() const { return count_; }
+	virtual void read(int channel, qint64 start, qint64 count, qreal* outputValues) const {
+		Q_UNUSED(channel)
+		memcpy(outputValues, values_+start, count*sizeof(qreal));
+	}
+	virtual bool concurrentReadsSafe() const { return true; }
+
+protected:
+	const qreal* values_;
+	int count_;
+};
+
+
+MPlotSharedXSeriesColumn::MPlotSharedXSeriesColumn(MPlotSharedXSeriesTable *table, int column)
+	: MPlotAbstractSeriesData()
+{
+	table_ = table;
+	column_ = column;
+	yRangeValid_ = false;
+}
+
+qreal MPlotSharedXSeriesColumn::x(unsigned index) const
+{
+	return table_->x(index);
+}
+
+void MPlotSharedXSeriesColumn::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, table_->xData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+qreal MPlotSharedXSeriesColumn::y(unsigned index) const
+{
+	return table_->y(column_, index);
+}
+
+void MPlotSharedXSeriesColumn::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, table_->yData(column_)+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+int MPlotSharedXSeriesColumn::count() const
+{
+	return table_->count();
+}
+
+QRectF MPlotSharedXSeriesColumn::boundingRect() const
+{
+	int count = table_->count();
+	if(count == 0)
+		return QRectF();
+
+	if(!yRangeValid_) {
+		yRange_ = MPlotMinMax();
+		MPlotSharedXMinMaxSource source(table_->yData(column_), count);
+		MPlotMinMax::search(&source, &yRange_);
+		yRangeValid_ = true;
+	}
+
+	const MPlotMinMax& xRange = table_->xRange();
+	qreal minX = xRange.minimum(), maxX = xRange.maximum();
+	qreal minY = yRange_.minimum(), maxY = yRange_.maximum();
+
+	// same as MPlotAbstractSeriesData::boundingRect(): keep a single point valid.
+	return QRectF(minX,
+				  minY,
+				  qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+				  qMax(maxY-minY, std::numeric_limits<qreal>::min()));
+}
+
+MPlotSharedXCache * MPlotSharedXSeriesColumn::sharedXCache() const
+{
+	return table_->sharedXCache();
+}
+
+bool MPlotSharedXSeriesColumn::reachesYRange(qreal value) const
+{
+	// (NaN values fail both comparisons: they're skipped by the search, so they can't be an extreme.)
+	return !yRangeValid_ || !yRange_.isValid() || value <= yRange_.minimum() || value >= yRange_.maximum();
+}
+
+
+MPlotSharedXSeriesTable::MPlotSharedXSeriesTable(int columnCount)
+{
+	head_ = 0;
+	xRangeValid_ = false;
+
+	columnCount = qMax(0, columnCount);
+	y_.resize(columnCount);
+	for(int c=0; c<columnCount; ++c)
+		columns_ << new MPlotSharedXSeriesColumn(this, c);
+}
+
+MPlotSharedXSeriesTable::~MPlotSharedXSeriesTable()
+{
+	qDeleteAll(columns_);
+	columns_.clear();
+}
+
+void MPlotSharedXSeriesTable::appendRows(const qreal *x, const qreal *y, int count)
+{
+	if(count < 1)
+		return;
+
+	int first = this->count();
+	int size = x_.size();
+	int columnCount = columns_.size();
+
+	x_.resize(size+count);
+	memcpy(x_.data()+size, x, count*sizeof(qreal));
+	if(xRangeValid_)
+		xRange_.add(x, count);
+
+	// the y values come row by row: spread them into the columns.
+	for(int c=0; c<columnCount; ++c) {
+		QVector<qreal>& column = y_[c];
+		column.resize(size+count);
+		qreal* values = column.data()+size;
+		for(int r=0; r<count; ++r)
+			values[r] = y[r*columnCount+c];
+
+		MPlotSharedXSeriesColumn* data = columns_.at(c);
+		if(data->yRangeValid_)
+			data->yRange_.add(values, count);
+	}
+
+	// (The columns keep their own bounds, so the base class doesn't need to search the new points.)
+	for(int c=0; c<columnCount; ++c) {
+		columns_.at(c)->cachedDataRectUpdateRequired_ = true;
+		columns_.at(c)->emitRowsAppended(first, first+count-1);
+	}
+}
+
+int MPlotSharedXSeriesTable::removeRowsFront(int count)
+{
+	count = qMin(count, this->count());
+	if(count < 1)
+		return 0;
+
+	// the ranges only need a new search if one of the removed values was on them.
+	for(int i=head_, end=head_+count; i<end && xRangeValid_; ++i)
+		if(reachesXRange(x_.at(i)))
+			xRangeValid_ = false;
+	for(int c=0, columnCount=columns_.size(); c<columnCount; ++c) {
+		MPlotSharedXSeriesColumn* data = columns_.at(c);
+		const QVector<qreal>& column = y_.at(c);
+		for(int i=head_, end=head_+count; i<end && data->yRangeValid_; ++i)
+			if(data->reachesYRange(column.at(i)))
+				data->yRangeValid_ = false;
+	}
+
+	head_ += count;
+	compact();
+	sharedXCache_.removeFront(count);
+
+	for(int c=0, columnCount=columns_.size(); c<columnCount; ++c)
+		columns_.at(c)->emitRowsRemovedFront(count);
+	return count;
+}
+
+void MPlotSharedXSeriesTable::clear()
+{
+	x_.clear();
+	for(int c=0, columnCount=y_.size(); c<columnCount; ++c)
+		y_[c].clear();
+	head_ = 0;
+	xRangeValid_ = false;
+	sharedXCache_.clear();
+
+	for(int c=0, columnCount=columns_.size(); c<columnCount; ++c) {
+		columns_.at(c)->yRangeValid_ = false;
+		columns_.at(c)->emitDataReset();
+	}
+}
+
+void MPlotSharedXSeriesTable::setX(int index, qreal x)
+{
+	qreal& value = x_[head_+index];
+	if(reachesXRange(value) || reachesXRange(x))
+		xRangeValid_ = false;
+	value = x;
+	sharedXCache_.clear();
+
+	for(int c=0, columnCount=columns_.size(); c<columnCount; ++c)
+		columns_.at(c)->emitValuesChanged(index, index);
+}
+
+void MPlotSharedXSeriesTable::setY(int column, int index, qreal y)
+{
+	MPlotSharedXSeriesColumn* data = columns_.at(column);
+	qreal& value = y_[column][head_+index];
+	if(data->reachesYRange(value) || data->reachesYRange(y))
+		data->yRangeValid_ = false;
+	value = y;
+
+	data->emitValuesChanged(index, index);
+}
+
+const MPlotMinMax & MPlotSharedXSeriesTable::xRange() const
+{
+	if(!xRangeValid_) {
+		xRange_ = MPlotMinMax();
+		MPlotSharedXMinMaxSource source(xData(), count());
+		MPlotMinMax::search(&source, &xRange_);
+		xRangeValid_ = true;
+	}
+	return xRange_;
+}
+
+bool MPlotSharedXSeriesTable::reachesXRange(qreal value) const
+{
+	return !xRangeValid_ || !xRange_.isValid() || value <= xRange_.minimum() || value >= xRange_.maximum();
+}
+
+void MPlotSharedXSeriesTable::compact()
+{
+	if(!MPlotFrontCompactionDue(head_, x_.size()))
+		return;
+
+	MPlotRemoveFront(x_, head_);
+	for(int c=0, columnCount=y_.size(); c<columnCount; ++c)
+		MPlotRemoveFront(y_[c], head_);
+	head_ = 0;
+}
+
+#endif // MPLOTSHAREDXSERIESTABLE_CPP
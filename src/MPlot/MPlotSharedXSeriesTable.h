@@ -0,0 +1,157 @@
+#ifndef MPLOTSHAREDXSERIESTABLE_H
+#define MPLOTSHAREDXSERIESTABLE_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+
+#include <QList>
+#include <QVector>
+
+class MPlotSharedXSeriesTable;
+
+/// The number of values identifying a set of x drawing coordinates in an MPlotSharedXCache: the series' x scale, shift and offset, and the x axis min, max, drawing length and log scale.
+#define MPLOT_SHARED_X_KEY_SIZE 7
+/// The number of different x transforms and axis scales an MPlotSharedXCache keeps the drawing coordinates for.
+#define MPLOT_SHARED_X_CACHE_ENTRIES 4
+
+/// This class holds x drawing coordinates shared between series whose data has the same x values.  See MPlotAbstractSeriesData::sharedXCache().
+/*! The first series to draw with a given x transform and x axis scale maps the x values and stores them here; the others drawing during the same paint pass get the same vectors (implicitly shared, not copied) instead of mapping the x values again.  The model owning the cache keeps it in step with its x values. */
+class MPLOTSHARED_EXPORT MPlotSharedXCache {
+public:
+	/// The transformed and mapped x values for one x transform and axis scale.
+	struct Entry {
+		qreal key[MPLOT_SHARED_X_KEY_SIZE];
+		QVector<qreal> transformedX, mappedX;
+	};
+
+	/// Returns the entry for \c key (MPLOT_SHARED_X_KEY_SIZE values), creating an empty one if there isn't one.  The reference is valid until the next call.
+	Entry& entry(const qreal* key);
+	/// Drops the first \c count values of every entry, after the model removed them.
+	void removeFront(int count);
+	/// Throws away all the entries, after x values changed.
+	void clear() { entries_.clear(); }
+
+protected:
+	/// Entries, most recently used first.
+	QList<Entry> entries_;
+};
+
+
+/// This class is one column of an MPlotSharedXSeriesTable, seen as series data: the table's x values, and the column's y values.
+/*! Columns are created and owned by their table (see MPlotSharedXSeriesTable::column()): don't give a series ownership of them. */
+class MPLOTSHARED_EXPORT MPlotSharedXSeriesColumn : public MPlotAbstractSeriesData {
+
+public:
+	/// Returns the table this column belongs to.
+	MPlotSharedXSeriesTable* table() const { return table_; }
+	/// Returns the index of this column in its table.
+	int columnIndex() const { return column_; }
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const;
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the y value at \c index.
+	virtual qreal y(unsigned index) const;
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of rows in the table.
+	virtual int count() const;
+
+	/// Re-implemented to use the x range the table keeps for all its columns, and search only this column's y values.
+	virtual QRectF boundingRect() const;
+	/// Re-implemented to return true: reading the table doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+	/// Re-implemented to share the x drawing coordinates between all the columns of the table.
+	virtual MPlotSharedXCache* sharedXCache() const;
+
+protected:
+	/// Constructor, used by MPlotSharedXSeriesTable.
+	MPlotSharedXSeriesColumn(MPlotSharedXSeriesTable* table, int column);
+
+	/// Returns true if \c value is outside or on the cached y range, ie: adding or removing it may change the range.
+	bool reachesYRange(qreal value) const;
+
+	/// The table.
+	MPlotSharedXSeriesTable* table_;
+	/// The index of this column in the table.
+	int column_;
+	/// The range of y values, when yRangeValid_.
+	mutable MPlotMinMax yRange_;
+	/// False when yRange_ needs a new search.
+	mutable bool yRangeValid_;
+
+	friend class MPlotSharedXSeriesTable;
+};
+
+
+/// This class is a table of points with one column of x values shared by many columns of y values, like channels sampled on a common time base.  Each y column is plotted through its column() series data.
+/*! Compared to one MPlotVectorSeriesData per channel, the x values are stored once, their range is searched once for all the columns, and series drawing the columns on the same x axis map the x values once per paint pass (see MPlotSharedXCache) instead of once per series.
+
+The values are kept column by column, in contiguous QVectors with a movable front (like MPlotRealtimeSeriesData), so appending rows and removing them from the front are amortized constant-time per value, and each column's xValues() and yValues() are straight copies.  Every change is announced by each column with the specific change signals (rowsAppended(), rowsRemovedFront(), valuesChanged() and dataReset()). */
+class MPLOTSHARED_EXPORT MPlotSharedXSeriesTable {
+
+public:
+	/// Constructor. Creates an empty table with \c columnCount y columns.
+	MPlotSharedXSeriesTable(int columnCount);
+	/// Destructor. Deletes the columns: make sure no series is still using them.
+	virtual ~MPlotSharedXSeriesTable();
+
+	/// Returns the number of y columns.
+	int columnCount() const { return columns_.size(); }
+	/// Returns the series data for y column \c column.
+	MPlotSharedXSeriesColumn* column(int column) const { return columns_.at(column); }
+	/// Returns the number of rows.
+	int count() const { return x_.size() - head_; }
+
+	/// Returns the x value of row \c index.
+	qreal x(int index) const { return x_.at(head_+index); }
+	/// Returns the y value of row \c index in column \c column.
+	qreal y(int column, int index) const { return y_.at(column).at(head_+index); }
+	/// Returns a pointer to the count() x values.
+	const qreal* xData() const { return x_.constData() + head_; }
+	/// Returns a pointer to the count() y values of column \c column.
+	const qreal* yData(int column) const { return y_.at(column).constData() + head_; }
+
+	/// Appends a row, with x value \c x and the columnCount() y values \c y.
+	void appendRow(qreal x, const qreal* y) { appendRows(&x, y, 1); }
+	/// Appends \c count rows, with x values \c x and y values \c y, row by row: the y value of row r in column c is y[r*columnCount()+c].
+	void appendRows(const qreal* x, const qreal* y, int count);
+	/// Removes the first \c count rows (or all of them, if there are fewer).  Returns the number of rows removed.
+	int removeRowsFront(int count);
+	/// Removes all the rows.
+	void clear();
+
+	/// Sets the x value of row \c index.
+	void setX(int index, qreal x);
+	/// Sets the y value of row \c index in column \c column.
+	void setY(int column, int index, qreal y);
+
+	/// Returns the range of the x values (NaN values skipped), searched once for all the columns.
+	const MPlotMinMax& xRange() const;
+	/// Returns the x drawing coordinates shared between the series drawing the columns.
+	MPlotSharedXCache* sharedXCache() const { return &sharedXCache_; }
+
+protected:
+	/// Returns true if \c value is outside or on the cached x range, ie: adding or removing it may change the range.
+	bool reachesXRange(qreal value) const;
+	/// Moves the values to the front of the vectors once the removed rows take more space than the others.
+	void compact();
+
+	/// The x values, and the y values of each column, starting at head_.
+	QVector<qreal> x_;
+	QVector<QVector<qreal> > y_;
+	/// Index of the first row in the vectors. The slots before it were removed.
+	int head_;
+	/// Series data for each column.
+	QList<MPlotSharedXSeriesColumn*> columns_;
+
+	/// The range of x values, when xRangeValid_.
+	mutable MPlotMinMax xRange_;
+	/// False when xRange_ needs a new search.
+	mutable bool xRangeValid_;
+	/// Shared x drawing coordinates.
+	mutable MPlotSharedXCache sharedXCache_;
+};
+
+#endif // MPLOTSHAREDXSERIESTABLE_H
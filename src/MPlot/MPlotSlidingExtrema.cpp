@@ -0,0 +1,56 @@
+#ifndef MPLOTSLIDINGEXTREMA_CPP
+#define MPLOTSLIDINGEXTREMA_CPP
+
+#include "MPlot/MPlotSlidingExtrema.h"
+
+MPlotSlidingExtrema::MPlotSlidingExtrema()
+{
+	minimumsHead_ = 0;
+	maximumsHead_ = 0;
+	appendedCount_ = 0;
+}
+
+void MPlotSlidingExtrema::append(qreal minimumValue, qreal maximumValue)
+{
+	// a new value beats every older candidate that isn't strictly better than it: those can never be the extreme again.
+	while(minimums_.size() > minimumsHead_ && minimums_.last().second >= minimumValue)
+		minimums_.remove(minimums_.size()-1);
+	minimums_.append(qMakePair(appendedCount_, minimumValue));
+
+	while(maximums_.size() > maximumsHead_ && maximums_.last().second <= maximumValue)
+		maximums_.remove(maximums_.size()-1);
+	maximums_.append(qMakePair(appendedCount_, maximumValue));
+
+	appendedCount_++;
+}
+
+void MPlotSlidingExtrema::expireBefore(qint64 index)
+{
+	while(minimumsHead_ < minimums_.size() && minimums_.at(minimumsHead_).first < index)
+		minimumsHead_++;
+	while(maximumsHead_ < maximums_.size() && maximums_.at(maximumsHead_).first < index)
+		maximumsHead_++;
+
+	compact(minimums_, minimumsHead_);
+	compact(maximums_, maximumsHead_);
+}
+
+void MPlotSlidingExtrema::clear()
+{
+	minimums_.clear();
+	maximums_.clear();
+	minimumsHead_ = 0;
+	maximumsHead_ = 0;
+	appendedCount_ = 0;
+}
+
+void MPlotSlidingExtrema::compact(QVector<QPair<qint64, qreal> > &queue, int &head)
+{
+	// Moving the live entries down only once the dead ones are the majority keeps this amortized constant time per value.
+	if(head > 32 && head*2 > queue.size()) {
+		queue.remove(0, head);
+		head = 0;
+	}
+}
+
+#endif // MPLOTSLIDINGEXTREMA_CPP
@@ -0,0 +1,60 @@
+#ifndef MPLOTSLIDINGEXTREMA_H
+#define MPLOTSLIDINGEXTREMA_H
+
+#include "MPlot/MPlot_global.h"
+
+#include <QVector>
+#include <QPair>
+
+/// This class tracks the minimum and maximum over a sliding window of values, in amortized constant time per value.
+/*! Values are appended one at a time, and numbered in the order they were appended (starting from 0).  Old values are expired by calling expireBefore() with the number of the oldest value that is still in the window.
+
+Internally, it keeps two monotonic queues: candidates for the minimum (increasing values) and for the maximum (decreasing values).  A new value removes every candidate it beats from the back of the queue, and expired candidates are removed from the front.  Each value is added and removed at most once, so the cost of keeping the extremes up to date doesn't depend on the size of the window.
+
+Use it to track the range of data that scrolls, such as a live spectrogram (one min/max pair per row) or a real-time series with a fixed history.
+*/
+class MPLOTSHARED_EXPORT MPlotSlidingExtrema {
+public:
+	/// Constructor. Starts empty.
+	MPlotSlidingExtrema();
+
+	/// Append a value, which can contribute a different \c minimumValue and \c maximumValue (ex: the minimum and maximum of a whole row of data).
+	void append(qreal minimumValue, qreal maximumValue);
+	/// Append a single value.
+	void append(qreal value) { append(value, value); }
+	/// Remove all values numbered before \c index from the window.
+	void expireBefore(qint64 index);
+
+	/// Returns true if there are no values in the window.
+	bool isEmpty() const { return minimumsHead_ >= minimums_.size(); }
+	/// Returns the minimum of the values in the window. Only valid if !isEmpty().
+	qreal minimum() const { return minimums_.at(minimumsHead_).second; }
+	/// Returns the maximum of the values in the window. Only valid if !isEmpty().
+	qreal maximum() const { return maximums_.at(maximumsHead_).second; }
+	/// Returns the number of the value holding the minimum (the most recent one, if several are equal). Only valid if !isEmpty().
+	qint64 minimumIndex() const { return minimums_.at(minimumsHead_).first; }
+	/// Returns the number of the value holding the maximum (the most recent one, if several are equal). Only valid if !isEmpty().
+	qint64 maximumIndex() const { return maximums_.at(maximumsHead_).first; }
+	/// Returns the number of values appended since construction (or the last clear()). This is also the number that the next value will get.
+	qint64 appendedCount() const { return appendedCount_; }
+
+	/// Removes all values, and starts numbering from 0 again.
+	void clear();
+
+protected:
+	/// Candidates for the minimum: (number, value) in increasing order of both. The front is at minimumsHead_.
+	QVector<QPair<qint64, qreal> > minimums_;
+	/// Candidates for the maximum: (number, value) in increasing number and decreasing value. The front is at maximumsHead_.
+	QVector<QPair<qint64, qreal> > maximums_;
+	/// Index of the front of minimums_. Entries before it have expired.
+	int minimumsHead_;
+	/// Index of the front of maximums_. Entries before it have expired.
+	int maximumsHead_;
+	/// Number of values appended so far.
+	qint64 appendedCount_;
+
+	/// Removes expired entries from the front of \c queue, once they make up more than half of it.
+	static void compact(QVector<QPair<qint64, qreal> >& queue, int& head);
+};
+
+#endif // MPLOTSLIDINGEXTREMA_H
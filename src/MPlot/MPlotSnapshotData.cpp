@@ -0,0 +1,222 @@
+#ifndef MPLOTSNAPSHOTDATA_CPP
+#define MPLOTSNAPSHOTDATA_CPP
+
+#include "MPlot/MPlotSnapshotData.h"
+
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+#include <string.h>
+
+MPlotSnapshotNotifier::MPlotSnapshotNotifier(MPlotSnapshotAdopter *adopter)
+	: QObject(0)
+{
+	adopter_ = adopter;
+}
+
+void MPlotSnapshotNotifier::notifyPublished()
+{
+	if(QThread::currentThread() == thread()) {
+		onPublished();
+		return;
+	}
+
+	// only queue one notification at a time; the model adopts whatever is latest when it runs.
+	if(pending_.testAndSetOrdered(0, 1))
+		QMetaObject::invokeMethod(this, "onPublished", Qt::QueuedConnection);
+}
+
+void MPlotSnapshotNotifier::onPublished()
+{
+	// clear the flag first: a version published while we adopt will queue a new notification.
+	pending_.fetchAndStoreOrdered(0);
+	adopter_->adoptPublishedSnapshot();
+}
+
+
+MPlotSnapshotSeriesData::MPlotSnapshotSeriesData()
+	: MPlotAbstractSeriesData()
+{
+	nextVersion_ = 1;
+	notifier_ = new MPlotSnapshotNotifier(this);
+}
+
+MPlotSnapshotSeriesData::~MPlotSnapshotSeriesData()
+{
+	delete notifier_;
+	notifier_ = 0;
+}
+
+bool MPlotSnapshotSeriesData::publish(const QVector<qreal> &xValues, const QVector<qreal> &yValues)
+{
+	if(xValues.size() != yValues.size()) {
+		qWarning() << "MPlotSnapshotSeriesData: Not publishing x and y values of different sizes.";
+		return false;
+	}
+
+	writeMutex_.lock();
+	setPublished(MPlotSeriesSnapshot(xValues, yValues, nextVersion_++));
+	writeMutex_.unlock();
+
+	notifier_->notifyPublished();
+	return true;
+}
+
+bool MPlotSnapshotSeriesData::publishAppended(const QVector<qreal> &xValues, const QVector<qreal> &yValues)
+{
+	if(xValues.size() != yValues.size()) {
+		qWarning() << "MPlotSnapshotSeriesData: Not appending x and y values of different sizes.";
+		return false;
+	}
+
+	writeMutex_.lock();
+
+	MPlotSeriesSnapshot latest = snapshot();
+	QVector<qreal> newX = latest.xValues();
+	QVector<qreal> newY = latest.yValues();
+	newX += xValues;	// detaches from the latest version; readers holding it are unaffected.
+	newY += yValues;
+
+	setPublished(MPlotSeriesSnapshot(newX, newY, nextVersion_++));
+	writeMutex_.unlock();
+
+	notifier_->notifyPublished();
+	return true;
+}
+
+void MPlotSnapshotSeriesData::setPublished(const MPlotSeriesSnapshot &snapshot)
+{
+	MPlotSeriesSnapshot previous;
+	publishedMutex_.lock();
+	previous = published_;
+	published_ = snapshot;
+	publishedMutex_.unlock();
+	// previous goes out of scope here, outside the lock: if it was the last reference, the old version is freed without holding up readers.
+}
+
+MPlotSeriesSnapshot MPlotSnapshotSeriesData::snapshot() const
+{
+	QMutexLocker locker(&publishedMutex_);
+	return published_;
+}
+
+void MPlotSnapshotSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, current_.xData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotSnapshotSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, current_.yData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotSnapshotSeriesData::adoptPublishedSnapshot()
+{
+	MPlotSeriesSnapshot latest = snapshot();
+	if(latest.version() == current_.version())
+		return;
+
+	current_ = latest;
+	emitDataReset();
+}
+
+
+MPlotSnapshotImageData::MPlotSnapshotImageData()
+	: MPlotAbstractImageData()
+{
+	nextVersion_ = 1;
+	notifier_ = new MPlotSnapshotNotifier(this);
+}
+
+MPlotSnapshotImageData::~MPlotSnapshotImageData()
+{
+	delete notifier_;
+	notifier_ = 0;
+}
+
+bool MPlotSnapshotImageData::publish(const QVector<qreal> &values, const QSize &size, const QRectF &bounds)
+{
+	if(values.size() < qMax(0, size.width())*qMax(0, size.height())) {
+		qWarning() << "MPlotSnapshotImageData: Not publishing fewer values than the size of the image.";
+		return false;
+	}
+
+	writeMutex_.lock();
+	setPublished(MPlotImageSnapshot(values, size, bounds, nextVersion_++));
+	writeMutex_.unlock();
+
+	notifier_->notifyPublished();
+	return true;
+}
+
+bool MPlotSnapshotImageData::publish(const QVector<qreal> &values)
+{
+	writeMutex_.lock();
+	MPlotImageSnapshot latest = snapshot();
+	QPoint c = latest.count();
+	if(values.size() < c.x()*c.y()) {
+		writeMutex_.unlock();
+		qWarning() << "MPlotSnapshotImageData: Not publishing fewer values than the size of the image.";
+		return false;
+	}
+
+	setPublished(MPlotImageSnapshot(values, QSize(c.x(), c.y()), latest.boundingRect(), nextVersion_++));
+	writeMutex_.unlock();
+
+	notifier_->notifyPublished();
+	return true;
+}
+
+void MPlotSnapshotImageData::setPublished(const MPlotImageSnapshot &snapshot)
+{
+	MPlotImageSnapshot previous;
+	publishedMutex_.lock();
+	previous = published_;
+	published_ = snapshot;
+	publishedMutex_.unlock();
+	// the previous version is released here, outside the lock.
+}
+
+MPlotImageSnapshot MPlotSnapshotImageData::snapshot() const
+{
+	QMutexLocker locker(&publishedMutex_);
+	return published_;
+}
+
+void MPlotSnapshotImageData::zValues(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	const qreal* values = current_.data();
+	int width = current_.count().x();
+
+	for(int xx=xStart; xx<=xEnd; ++xx)
+		for(int yy=yStart; yy<=yEnd; ++yy)
+			*(outputValues++) = values[yy*width + xx];
+}
+
+void MPlotSnapshotImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	const qreal* values = current_.data();
+	int width = current_.count().x();
+	int rowLength = xEnd-xStart+1;
+
+	for(int yy=yStart; yy<=yEnd; ++yy) {
+		memcpy(outputValues, values + yy*width + xStart, rowLength*sizeof(qreal));
+		outputValues += rowLength;
+	}
+}
+
+void MPlotSnapshotImageData::adoptPublishedSnapshot()
+{
+	MPlotImageSnapshot latest = snapshot();
+	if(latest.version() == current_.version())
+		return;
+
+	bool boundsChanged = latest.count() != current_.count() || latest.boundingRect() != current_.boundingRect();
+	current_ = latest;
+
+	if(boundsChanged)
+		emitBoundsChanged();
+	emitDataChanged();
+}
+
+#endif // MPLOTSNAPSHOTDATA_CPP
@@ -0,0 +1,182 @@
+#ifndef MPLOTSNAPSHOTDATA_H
+#define MPLOTSNAPSHOTDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+#include "MPlot/MPlotImageData.h"
+
+#include <QObject>
+#include <QMutex>
+#include <QAtomicInt>
+
+/// Interface for models that adopt the snapshot most recently published by a writer thread. Used by MPlotSnapshotNotifier.
+class MPLOTSHARED_EXPORT MPlotSnapshotAdopter {
+public:
+	virtual ~MPlotSnapshotAdopter() {}
+	/// Called in the model's thread after one or more snapshots were published: the model should start using the latest one, and emit its change signals.
+	virtual void adoptPublishedSnapshot() = 0;
+};
+
+/// This class tells a snapshot model, in its own (GUI) thread, that a writer published a new snapshot.
+/*! Writers can publish far more often than the plot can redraw, so notifications are coalesced: while one is waiting in the event queue, further publishes don't queue another one, and the model simply adopts whatever is latest when it runs.  When the writer is already in the model's thread, the model adopts immediately. */
+class MPLOTSHARED_EXPORT MPlotSnapshotNotifier : public QObject {
+	Q_OBJECT
+
+public:
+	/// Constructor. \c adopter is the model to notify. The notifier must be created in the model's thread.
+	MPlotSnapshotNotifier(MPlotSnapshotAdopter* adopter);
+
+	/// Call from any thread after publishing a snapshot.
+	void notifyPublished();
+
+protected slots:
+	/// Runs in the model's thread.
+	void onPublished();
+
+protected:
+	/// The model to notify.
+	MPlotSnapshotAdopter* adopter_;
+	/// 1 while a notification is waiting in the event queue.
+	QAtomicInt pending_;
+};
+
+
+/// This class is a series model that can be written from any thread, by publishing complete versions of the data, while readers in other threads keep reading the versions they already have.
+/*! It's a double-buffered (read-copy-update) model:
+- Writers build the new x and y values privately, and hand them over with publish() or publishAppended().  This stores a new MPlotSeriesSnapshot as the latest version, swapping a single shared pointer under a lock that is held only for the swap.  Several writers take turns, but writers never wait for readers.
+- Readers in any thread call snapshot() to get the latest version in O(1), and then read it without any locking, for as long as they like.  A version stays alive as long as someone holds it.
+- The model interface (x(), y(), count(), boundingRect(), used by the plot) reads the version the GUI thread last adopted.  A new version is adopted in the GUI thread (see MPlotSnapshotNotifier), and announced with dataReset() and dataChanged(), so the plot never sees data change in the middle of a repaint.
+
+Each publish takes the new values as they are (QVectors are shared, not copied), and computes the bounding rect once in the writer's thread.  publishAppended() has to copy the latest version to extend it, so for fast streams, batch up points and publish at about the frame rate. */
+class MPLOTSHARED_EXPORT MPlotSnapshotSeriesData : public MPlotAbstractSeriesData, public MPlotSnapshotAdopter {
+
+public:
+	/// Constructor. Creates an empty model; it must be created in the GUI thread.
+	MPlotSnapshotSeriesData();
+	/// Destructor.
+	virtual ~MPlotSnapshotSeriesData();
+
+	// Writer interface (any thread)
+	/////////////////////////////////
+
+	/// Publishes \c xValues and \c yValues as the new version of the data.  They must be the same size; if not, this does nothing and returns false.  Don't modify the vectors you passed in while readers may be reading them; let them detach instead (ie: modify only copies).
+	bool publish(const QVector<qreal>& xValues, const QVector<qreal>& yValues);
+	/// Publishes a new version made of the latest version with \c xValues and \c yValues appended at the end.  They must be the same size; if not, this does nothing and returns false.
+	bool publishAppended(const QVector<qreal>& xValues, const QVector<qreal>& yValues);
+	/// Publishes an empty version.
+	void publishClear() { publish(QVector<qreal>(), QVector<qreal>()); }
+
+	// Reader interface (any thread)
+	/////////////////////////////////
+
+	/// Returns the latest published version, in O(1).
+	virtual MPlotSeriesSnapshot snapshot() const;
+
+	// Model interface (GUI thread): reads the adopted version.
+	/////////////////////////////////
+
+	/// Returns the x value at \c index.
+	virtual qreal x(unsigned index) const { return current_.x(index); }
+	/// Copies the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the y value at \c index.
+	virtual qreal y(unsigned index) const { return current_.y(index); }
+	/// Copies the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of points.
+	virtual int count() const { return current_.count(); }
+	/// Returns the bounds, which were computed when the version was published.
+	virtual QRectF boundingRect() const { return current_.boundingRect(); }
+	/// Re-implemented to return true: an adopted version never changes.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+protected:
+	/// Adopts the latest published version, and emits dataReset() if it's a new one.
+	virtual void adoptPublishedSnapshot();
+
+	/// Stores \c snapshot as the latest version. Writers call it holding writeMutex_, and notify the GUI thread after releasing it (in case the GUI thread is the writer, and publishes again from a dataChanged() slot).
+	void setPublished(const MPlotSeriesSnapshot& snapshot);
+
+	/// Held by writers while they build a version, so that they take turns (and publishAppended() builds on the latest version). Readers never take it.
+	QMutex writeMutex_;
+	/// Guards only the copy and swap of published_.
+	mutable QMutex publishedMutex_;
+	/// The latest published version.
+	MPlotSeriesSnapshot published_;
+	/// The version used by the model interface. (GUI thread only.)
+	MPlotSeriesSnapshot current_;
+	/// Version number of the next publish. (Guarded by writeMutex_.)
+	quint64 nextVersion_;
+	/// Delivers publish notifications to the GUI thread.
+	MPlotSnapshotNotifier* notifier_;
+};
+
+
+/// This class is an image model that can be written from any thread, by publishing complete versions of the data, while readers in other threads keep reading the versions they already have.
+/*! It works exactly like MPlotSnapshotSeriesData: writers publish() new z values (in scanline order), readers in any thread get the latest MPlotImageSnapshot from snapshot() in O(1), and the model interface reads the version the GUI thread last adopted.  Adopting a new version emits boundsChanged() if the size or bounds changed, and then dataChanged().  The z range is computed once per version, in the writer's thread. */
+class MPLOTSHARED_EXPORT MPlotSnapshotImageData : public MPlotAbstractImageData, public MPlotSnapshotAdopter {
+
+public:
+	/// Constructor. Creates an empty model; it must be created in the GUI thread.
+	MPlotSnapshotImageData();
+	/// Destructor.
+	virtual ~MPlotSnapshotImageData();
+
+	// Writer interface (any thread)
+	/////////////////////////////////
+
+	/// Publishes the \c size.width() x \c size.height() z \c values (in scanline order), covering \c bounds, as the new version of the data.  If there are fewer values than that, this does nothing and returns false.  Don't modify the vector you passed in while readers may be reading it.
+	bool publish(const QVector<qreal>& values, const QSize& size, const QRectF& bounds);
+	/// Publishes new z \c values (in scanline order), with the same size and bounds as the latest version.  If there are fewer values than that, this does nothing and returns false.
+	bool publish(const QVector<qreal>& values);
+
+	// Reader interface (any thread)
+	/////////////////////////////////
+
+	/// Returns the latest published version, in O(1).
+	virtual MPlotImageSnapshot snapshot() const;
+
+	// Model interface (GUI thread): reads the adopted version.
+	/////////////////////////////////
+
+	/// Returns the x value corresponding to \c indexX.
+	virtual qreal x(int indexX) const { return current_.x(indexX); }
+	/// Returns the y value corresponding to \c indexY.
+	virtual qreal y(int indexY) const { return current_.y(indexY); }
+	/// Returns the z value at (\c indexX, \c indexY).
+	virtual qreal z(int indexX, int indexY) const { return current_.z(indexX, indexY); }
+	/// Copies the block of z values from (xStart,yStart) to (xEnd,yEnd) inclusive into \c outputValues, with the x-axis varying the slowest.
+	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to copy straight out of the version's scanline storage.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Returns the number of values in x and y.
+	virtual QPoint count() const { return current_.count(); }
+	/// Returns the bounds of the data.
+	virtual QRectF boundingRect() const { return current_.boundingRect(); }
+	/// Returns the z range, which was computed when the version was published.
+	virtual MPlotInterval range() const { return current_.range(); }
+	/// Re-implemented to return true: an adopted version never changes.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+protected:
+	/// Adopts the latest published version, and emits boundsChanged() and dataChanged() if it's a new one.
+	virtual void adoptPublishedSnapshot();
+
+	/// Stores \c snapshot as the latest version. (See MPlotSnapshotSeriesData::setPublished().)
+	void setPublished(const MPlotImageSnapshot& snapshot);
+
+	/// Held by writers while they build a version. Readers never take it.
+	QMutex writeMutex_;
+	/// Guards only the copy and swap of published_.
+	mutable QMutex publishedMutex_;
+	/// The latest published version.
+	MPlotImageSnapshot published_;
+	/// The version used by the model interface. (GUI thread only.)
+	MPlotImageSnapshot current_;
+	/// Version number of the next publish. (Guarded by writeMutex_.)
+	quint64 nextVersion_;
+	/// Delivers publish notifications to the GUI thread.
+	MPlotSnapshotNotifier* notifier_;
+};
+
+#endif // MPLOTSNAPSHOTDATA_H
@@ -0,0 +1,258 @@
+#ifndef MPLOTSPECTRUMSERIESDATA_CPP
+#define MPLOTSPECTRUMSERIESDATA_CPP
+
+#include "MPlot/MPlotSpectrumSeriesData.h"
+#include "MPlot/MPlotScrollingImageData.h"
+
+#include <string.h>
+#include <math.h>
+
+MPlotSpectrumSeriesData::MPlotSpectrumSeriesData(const MPlotAbstractSeriesData *source, int fftSize, int hop, Window window)
+	: MPlotAbstractDerivedSeriesData(source), fft_(fftSize)
+{
+	hop_ = qMax(0, hop);
+	window_ = window;
+	averages_ = 1;
+	sampleRate_ = 1;
+	spectrogram_ = 0;
+
+	makeWindow();
+	restart();
+}
+
+void MPlotSpectrumSeriesData::setFftSize(int fftSize)
+{
+	fftSize = qMax(1, fftSize);
+	if(fftSize == fft_.size())
+		return;
+
+	fft_.setSize(fftSize);
+	makeWindow();
+	restart();
+	emitDataReset();
+}
+
+void MPlotSpectrumSeriesData::setHop(int hop)
+{
+	// (takes effect after the next spectrum, which is already due.)
+	hop_ = qMax(0, hop);
+}
+
+void MPlotSpectrumSeriesData::setWindow(Window window)
+{
+	if(window == window_)
+		return;
+
+	window_ = window;
+	makeWindow();
+	restart();
+	emitDataReset();
+}
+
+void MPlotSpectrumSeriesData::setAverages(int averages)
+{
+	averages = qMax(1, averages);
+	if(averages == averages_)
+		return;
+
+	averages_ = averages;
+	restart();
+	emitDataReset();
+}
+
+void MPlotSpectrumSeriesData::setSampleRate(qreal sampleRate)
+{
+	if(sampleRate == sampleRate_ || !(sampleRate > 0))
+		return;
+
+	sampleRate_ = sampleRate;
+	emitDataReset();
+}
+
+void MPlotSpectrumSeriesData::setSpectrogram(MPlotScrollingImageData *spectrogram)
+{
+	spectrogram_ = spectrogram;
+}
+
+void MPlotSpectrumSeriesData::xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	qreal dx = sampleRate_/fft_.size();
+	for(unsigned i=indexStart; i<=indexEnd; ++i)
+		*(outputValues++) = i*dx;
+}
+
+void MPlotSpectrumSeriesData::yValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const
+{
+	memcpy(outputValues, magnitudes_.constData()+indexStart, (indexEnd-indexStart+1)*sizeof(qreal));
+}
+
+void MPlotSpectrumSeriesData::sourceRowsAppended(int first, int last)
+{
+	Q_UNUSED(first)
+	Q_UNUSED(last)
+
+	int size = fft_.size();
+	int hop = this->hop();
+	int sourceCount = source_->count();
+
+	// (points removed from the front can leave it before the first full frame.)
+	nextEnd_ = qMax(nextEnd_, size-1);
+	if(nextEnd_ >= sourceCount)
+		return;
+
+	// only the frames that are averaged or go in the spectrogram can be seen: skip the others.
+	int due = (sourceCount-1 - nextEnd_)/hop + 1;
+	int needed = qMax(averages_, spectrogram_ ? spectrogram_->historyRows() : 1);
+	if(due > needed) {
+		nextEnd_ += (due-needed)*hop;
+		due = needed;
+	}
+
+	int rowLength = spectrogram_ ? spectrogram_->rowLength() : 0;
+	rows_.resize(due*rowLength);
+	for(int frame=0; frame<due; ++frame) {
+		const QVector<qreal>& spectrum = computeSpectrum(nextEnd_);
+		nextEnd_ += hop;
+
+		if(rowLength) {
+			int copied = qMin(rowLength, spectrum.size());
+			qreal* row = rows_.data() + frame*rowLength;
+			memcpy(row, spectrum.constData(), copied*sizeof(qreal));
+			for(int i=copied; i<rowLength; ++i)
+				row[i] = 0;
+		}
+	}
+
+	bool wasEmpty = magnitudes_.isEmpty();
+	updateMagnitudes();
+
+	if(rowLength)
+		spectrogram_->appendRows(rows_.constData(), due);
+
+	if(wasEmpty)
+		emitDataReset();
+	else
+		emitValuesChanged(0, count()-1);
+}
+
+void MPlotSpectrumSeriesData::sourceRowsRemovedFront(int count)
+{
+	nextEnd_ -= count;
+}
+
+void MPlotSpectrumSeriesData::sourceReset()
+{
+	restart();
+	MPlotAbstractDerivedSeriesData::sourceReset();
+}
+
+void MPlotSpectrumSeriesData::restart()
+{
+	spectra_ = QVector<QVector<qreal> >(averages_);
+	spectraAdded_ = 0;
+	magnitudes_.clear();
+
+	int size = fft_.size();
+	int hop = this->hop();
+	int sourceCount = source_ ? source_->count() : 0;
+	if(sourceCount < size) {
+		nextEnd_ = size-1;
+		return;
+	}
+
+	// the spectra averaged at the end of the source, oldest first.
+	int frames = qMin(averages_, (sourceCount-size)/hop + 1);
+	for(int frame=frames-1; frame>=0; --frame)
+		computeSpectrum(sourceCount-1 - frame*hop);
+	updateMagnitudes();
+
+	nextEnd_ = sourceCount-1 + hop;
+}
+
+const QVector<qreal>& MPlotSpectrumSeriesData::computeSpectrum(int end)
+{
+	int size = fft_.size();
+	qreal* frame = frame_.data();
+	source_->yValues(end-size+1, end, frame);
+
+	const qreal* window = windowCoefficients_.constData();
+	for(int i=0; i<size; ++i)
+		frame[i] = frame[i] == frame[i] ? frame[i]*window[i] : 0;
+
+	fft_.transformReal(frame, transform_.data());
+
+	// the other half of the spectrum mirrors this one, so each bin stands for two; 0 and size/2 (for even sizes) have no mirror.
+	QVector<qreal>& spectrum = spectra_[int(spectraAdded_ % averages_)];
+	int bins = size/2+1;
+	spectrum.resize(bins);
+	for(int k=0; k<bins; ++k)
+		spectrum[k] = std::abs(transform_.at(k))*amplitudeScale_;
+	spectrum[0] *= 0.5;
+	if(size % 2 == 0 && bins > 1)
+		spectrum[bins-1] *= 0.5;
+
+	++spectraAdded_;
+	return spectrum;
+}
+
+void MPlotSpectrumSeriesData::updateMagnitudes()
+{
+	int used = int(qMin(spectraAdded_, qint64(averages_)));
+	if(used == 0) {
+		magnitudes_.clear();
+		return;
+	}
+
+	int bins = fft_.size()/2+1;
+	magnitudes_.fill(0, bins);
+	qreal* magnitudes = magnitudes_.data();
+	for(int s=0; s<used; ++s) {
+		const qreal* spectrum = spectra_.at(s).constData();
+		for(int k=0; k<bins; ++k)
+			magnitudes[k] += spectrum[k];
+	}
+
+	if(used > 1) {
+		qreal scale = 1.0/used;
+		for(int k=0; k<bins; ++k)
+			magnitudes[k] *= scale;
+	}
+}
+
+void MPlotSpectrumSeriesData::makeWindow()
+{
+	const double pi = 3.14159265358979323846;
+	int size = fft_.size();
+
+	// periodic windows (the period is size, not size-1), which is right for spectra.
+	windowCoefficients_.resize(size);
+	qreal sum = 0;
+	for(int i=0; i<size; ++i) {
+		double phase = 2*pi*i/size;
+		qreal w;
+		switch(window_) {
+		case HannWindow:
+			w = 0.5 - 0.5*cos(phase);
+			break;
+		case HammingWindow:
+			w = 0.54 - 0.46*cos(phase);
+			break;
+		case BlackmanWindow:
+			w = 0.42 - 0.5*cos(phase) + 0.08*cos(2*phase);
+			break;
+		default:
+			w = 1;
+			break;
+		}
+		windowCoefficients_[i] = w;
+		sum += w;
+	}
+
+	// a sine of amplitude A gives a peak of A*sum/2.
+	amplitudeScale_ = sum > 0 ? 2/sum : 0;
+
+	frame_.resize(size);
+	transform_.resize(size/2+1);
+}
+
+#endif // MPLOTSPECTRUMSERIESDATA_CPP
@@ -0,0 +1,115 @@
+#ifndef MPLOTSPECTRUMSERIESDATA_H
+#define MPLOTSPECTRUMSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotDerivedSeriesData.h"
+#include "MPlot/MPlotFFT.h"
+
+#include <QVector>
+
+class MPlotScrollingImageData;
+
+/// The default number of points an MPlotSpectrumSeriesData transforms.
+#define MPLOT_SPECTRUM_DEFAULT_SIZE 1024
+
+/// This class is the magnitude spectrum of the last fftSize() points of its source's y values, updated as points are appended.
+/*! The points of this data are the fftSize()/2+1 frequency bins: x is the frequency (from 0 to sampleRate()/2), and y is the amplitude, scaled so that a sine wave of amplitude A at the frequency of a bin gives A.  It is empty until the source has fftSize() points.  Draw it with MPlotSeriesBasic, like any other series.
+
+A new spectrum is computed each time hop() more points have arrived, not on every append: with a hop of fftSize()/2 (the default), consecutive frames overlap by half.  The points are multiplied by window() first (NaN values count as 0).  With averages() > 1, the y values are the mean of the last averages() spectra.  The transform (MPlotFFT), the window coefficients and the buffers are kept between spectra, so computing one doesn't allocate.  When a large block arrives at once, only the frames that can still be seen (the averaged ones, and the rows of the spectrogram) are computed.
+
+With setSpectrogram(), each new spectrum is also appended as a row of an MPlotScrollingImageData, for a live spectrogram.
+
+Points removed from the front of the source don't change the spectrum.  Any other change to the source restarts it from the end of the source. */
+class MPLOTSHARED_EXPORT MPlotSpectrumSeriesData : public MPlotAbstractDerivedSeriesData {
+
+public:
+	/// The windows the points can be multiplied by before the transform.
+	enum Window { RectangularWindow, HannWindow, HammingWindow, BlackmanWindow };
+
+	/// Constructor. Spectrum of the last \c fftSize points of \c source, every \c hop points (fftSize/2 if 0), with \c window.
+	MPlotSpectrumSeriesData(const MPlotAbstractSeriesData* source = 0, int fftSize = MPLOT_SPECTRUM_DEFAULT_SIZE, int hop = 0, Window window = HannWindow);
+
+	/// Returns the number of points transformed.
+	int fftSize() const { return fft_.size(); }
+	/// Sets the number of points transformed (fast for sizes with small prime factors, like powers of 2).  Restarts the spectrum.
+	void setFftSize(int fftSize);
+	/// Returns the number of new points between spectra.
+	int hop() const { return hop_ > 0 ? hop_ : qMax(1, fft_.size()/2); }
+	/// Sets the number of new points between spectra (fftSize()/2 if 0).
+	void setHop(int hop);
+	/// Returns the window the points are multiplied by.
+	Window window() const { return window_; }
+	/// Sets the window the points are multiplied by.  Restarts the spectrum.
+	void setWindow(Window window);
+	/// Returns the number of spectra averaged.
+	int averages() const { return averages_; }
+	/// Sets the number of spectra averaged (1 for none).  Restarts the spectrum.
+	void setAverages(int averages);
+	/// Returns the sample rate of the source, which sets the frequency scale.
+	qreal sampleRate() const { return sampleRate_; }
+	/// Sets the sample rate of the source.  The default is 1, for frequencies in cycles per point.
+	void setSampleRate(qreal sampleRate);
+
+	/// Returns the spectrogram new spectra are appended to, or 0.
+	MPlotScrollingImageData* spectrogram() const { return spectrogram_; }
+	/// Appends each new spectrum as a row of \c spectrogram from now on (or stops, if 0).  Its rowLength() should be fftSize()/2+1; otherwise, the rows are cut or padded with 0.  It isn't owned: set it to 0 before deleting it.
+	void setSpectrogram(MPlotScrollingImageData* spectrogram);
+
+	/// Returns the frequency of bin \c index.
+	virtual qreal x(unsigned index) const { return index*sampleRate_/fft_.size(); }
+	/// Copies the frequencies of bins \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the amplitude in bin \c index.
+	virtual qreal y(unsigned index) const { return magnitudes_.at(index); }
+	/// Copies the amplitudes in bins \c indexStart to \c indexEnd (inclusive) into \c outputValues.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const;
+	/// Returns the number of bins: fftSize()/2+1, or 0 before the first spectrum.
+	virtual int count() const { return magnitudes_.size(); }
+	/// Re-implemented: the frequencies are evenly spaced.
+	virtual bool uniformXSpacing(qreal& x0, qreal& dx) const { x0 = 0; dx = sampleRate_/fft_.size(); return true; }
+	/// Re-implemented to return true: reading the spectrum doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+
+protected:
+	/// Re-implemented to compute the spectra that are due.
+	virtual void sourceRowsAppended(int first, int last);
+	/// Re-implemented to keep the spectrum.
+	virtual void sourceRowsRemovedFront(int count);
+	/// Re-implemented to restart the spectrum.
+	virtual void sourceReset();
+
+	/// Throws away the spectra, and computes the ones averaged at the end of the source (without adding them to the spectrogram).
+	void restart();
+	/// Computes the spectrum of source points \c end-fftSize()+1 to \c end, and adds it to the average.  Returns the new spectrum.
+	const QVector<qreal>& computeSpectrum(int end);
+	/// Averages the spectra into magnitudes_.
+	void updateMagnitudes();
+	/// Computes the window coefficients, and the scale from transform to amplitude.
+	void makeWindow();
+
+	/// Spectrum parameters.  (hop_ is 0 for fftSize()/2.)
+	int hop_;
+	Window window_;
+	int averages_;
+	qreal sampleRate_;
+	MPlotScrollingImageData* spectrogram_;
+
+	/// The transform.
+	MPlotFFT fft_;
+	/// Window coefficients, and the factor turning the magnitude of a transform bin into an amplitude.
+	QVector<qreal> windowCoefficients_;
+	qreal amplitudeScale_;
+	/// Work buffers.
+	QVector<qreal> frame_, rows_;
+	QVector<MPlotFFT::Complex> transform_;
+
+	/// The last averages_ spectra, in a ring: the newest one is at (spectraAdded_-1) % averages_.
+	QVector<QVector<qreal> > spectra_;
+	qint64 spectraAdded_;
+	/// The y values: the mean of the spectra.
+	QVector<qreal> magnitudes_;
+	/// Index of the source point where the next spectrum ends.
+	int nextEnd_;
+};
+
+#endif // MPLOTSPECTRUMSERIESDATA_H
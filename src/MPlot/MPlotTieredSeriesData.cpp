@@ -0,0 +1,284 @@
+#ifndef MPLOTTIEREDSERIESDATA_CPP
+#define MPLOTTIEREDSERIESDATA_CPP
+
+#include "MPlot/MPlotTieredSeriesData.h"
+
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QDebug>
+
+void MPlotTieredLoadQueue::add(const Result &result)
+{
+	QMutexLocker locker(&mutex_);
+	results_ << result;
+	// one notification for everything that arrives before the receiver runs.
+	if(receiver_ && results_.size() == 1)
+		QMetaObject::invokeMethod(receiver_, "onBlocksLoaded", Qt::QueuedConnection);
+}
+
+QList<MPlotTieredLoadQueue::Result> MPlotTieredLoadQueue::take()
+{
+	QMutexLocker locker(&mutex_);
+	QList<Result> results = results_;
+	results_.clear();
+	return results;
+}
+
+void MPlotTieredLoadQueue::detach()
+{
+	QMutexLocker locker(&mutex_);
+	receiver_ = 0;
+}
+
+
+/// Reads one cold block from the file, on a QThreadPool thread.
+class MPlotTieredLoadTask : public QRunnable {
+public:
+	MPlotTieredLoadTask(const QString& fileName, qint64 offset, int words, int block, int generation, QSharedPointer<MPlotTieredLoadQueue> queue)
+		: QRunnable(), fileName_(fileName), offset_(offset), words_(words), queue_(queue) {
+		result_.block = block;
+		result_.generation = generation;
+	}
+
+	virtual void run() {
+		QFile file(fileName_);
+		result_.bits.resize(words_);
+		qint64 bytes = qint64(words_)*sizeof(quint64);
+		// if this fails, the result stays empty, and the block is read again when it's needed.
+		if(!file.open(QIODevice::ReadOnly) || !file.seek(offset_) || file.read(reinterpret_cast<char*>(result_.bits.data()), bytes) != bytes)
+			result_.bits.clear();
+		queue_->add(result_);
+	}
+
+protected:
+	QString fileName_;
+	qint64 offset_;
+	int words_;
+	MPlotTieredLoadQueue::Result result_;
+	QSharedPointer<MPlotTieredLoadQueue> queue_;
+};
+
+
+MPlotTieredSeriesLoader::MPlotTieredSeriesLoader(MPlotTieredSeriesData *data)
+	: QObject(0)
+{
+	data_ = data;
+}
+
+void MPlotTieredSeriesLoader::onBlocksLoaded()
+{
+	data_->onBlocksLoaded();
+}
+
+
+MPlotTieredSeriesData::MPlotTieredSeriesData(const QString &fileName, int hotPoints, int blockSize)
+	: MPlotCompressedSeriesData(blockSize)
+{
+	hotPoints_ = qMax(0, hotPoints);
+	coldBlocks_ = 0;
+	coldBytes_ = 0;
+	loadedBytes_ = 0;
+	memoryLimit_ = MPLOT_TIERED_MEMORY_LIMIT;
+	generation_ = 0;
+
+	if(fileName.isEmpty()) {
+		QTemporaryFile* temporaryFile = new QTemporaryFile();
+		file_ = temporaryFile;
+		if(!temporaryFile->open()) {
+			qWarning() << "MPlotTieredSeriesData: Could not create a temporary file. All the points will stay in memory.";
+			delete file_;
+			file_ = 0;
+		}
+	}
+	else {
+		file_ = new QFile(fileName);
+		if(!file_->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+			qWarning() << "MPlotTieredSeriesData: Could not open" << fileName << ". All the points will stay in memory.";
+			delete file_;
+			file_ = 0;
+		}
+	}
+
+	loader_ = new MPlotTieredSeriesLoader(this);
+	loadQueue_ = QSharedPointer<MPlotTieredLoadQueue>(new MPlotTieredLoadQueue(loader_));
+}
+
+MPlotTieredSeriesData::~MPlotTieredSeriesData()
+{
+	// blocks still being loaded are dropped.
+	loadQueue_->detach();
+	delete loader_;
+	loader_ = 0;
+
+	delete file_;
+	file_ = 0;
+}
+
+QString MPlotTieredSeriesData::fileName() const
+{
+	return file_ ? file_->fileName() : QString();
+}
+
+void MPlotTieredSeriesData::setMemoryLimit(qint64 bytes)
+{
+	memoryLimit_ = qMax(qint64(0), bytes);
+
+	while(loadedBytes_ > memoryLimit_ && !loadedOrder_.isEmpty()) {
+		int block = loadedOrder_.takeLast();
+		loadedBytes_ -= loaded_.take(block).size()*sizeof(quint64);
+	}
+}
+
+void MPlotTieredSeriesData::blockSealed(int block)
+{
+	Q_UNUSED(block)
+
+	if(!file_)
+		return;
+
+	int hotBlocks = hotPoints_/blockSize_;
+	while(coldBlocks_ < blocks_.size() - hotBlocks) {
+		QVector<quint64>& bits = blocks_[coldBlocks_].bits;
+		qint64 bytes = qint64(bits.size())*sizeof(quint64);
+
+		qint64 offset = file_->size();
+		if(!file_->seek(offset) || file_->write(reinterpret_cast<const char*>(bits.constData()), bytes) != bytes) {
+			qWarning() << "MPlotTieredSeriesData: Could not write to" << file_->fileName() << ". The blocks will stay in memory.";
+			file_->resize(offset);
+			return;
+		}
+
+		coldOffsets_ << offset;
+		coldSizes_ << bits.size();
+		coldBytes_ += bytes;
+		compressedBytes_ -= bytes;
+		bits = QVector<quint64>();
+		++coldBlocks_;
+	}
+
+	// the loading tasks read the file through their own handles.
+	file_->flush();
+}
+
+const quint64 * MPlotTieredSeriesData::blockBits(int block) const
+{
+	if(block >= coldBlocks_)
+		return MPlotCompressedSeriesData::blockBits(block);
+
+	QHash<int, QVector<quint64> >::const_iterator loaded = loaded_.constFind(block);
+	if(loaded != loaded_.constEnd()) {
+		loadedOrder_.removeOne(block);
+		loadedOrder_.prepend(block);
+		return loaded.value().constData();
+	}
+
+	// not loaded: we have to wait for the file.
+	QVector<quint64> bits(coldSizes_.at(block));
+	qint64 bytes = qint64(bits.size())*sizeof(quint64);
+	if(!file_->seek(coldOffsets_.at(block)) || file_->read(reinterpret_cast<char*>(bits.data()), bytes) != bytes) {
+		qWarning() << "MPlotTieredSeriesData: Could not read from" << file_->fileName();
+		bits.fill(0);	// decodes as zeros, rather than garbage.
+	}
+
+	keepLoaded(block, bits);
+	return loaded_.constFind(block).value().constData();
+}
+
+void MPlotTieredSeriesData::keepLoaded(int block, const QVector<quint64> &bits) const
+{
+	if(loaded_.contains(block)) {
+		loadedBytes_ -= loaded_.value(block).size()*sizeof(quint64);
+		loadedOrder_.removeOne(block);
+	}
+
+	loaded_.insert(block, bits);
+	loadedOrder_.prepend(block);
+	loadedBytes_ += bits.size()*sizeof(quint64);
+
+	// drop the least recently used ones, but never the one just added.
+	while(loadedBytes_ > memoryLimit_ && loadedOrder_.size() > 1) {
+		int oldest = loadedOrder_.takeLast();
+		loadedBytes_ -= loaded_.take(oldest).size()*sizeof(quint64);
+	}
+}
+
+bool MPlotTieredSeriesData::prefetch(int first, int last) const
+{
+	int firstBlock = qMax(0, first)/blockSize_;
+	int lastBlock = qMin(last/blockSize_, coldBlocks_-1);
+	if(firstBlock > lastBlock)
+		return true;
+
+	// if the blocks can't all be in memory at once, loading them would only push each other out, over and over.
+	qint64 bytes = 0;
+	for(int block = firstBlock; block <= lastBlock; ++block)
+		bytes += coldSizes_.at(block)*sizeof(quint64);
+	if(bytes > memoryLimit_)
+		return false;
+
+	bool ready = true;
+	for(int block = firstBlock; block <= lastBlock; ++block) {
+		if(loaded_.contains(block)) {
+			loadedOrder_.removeOne(block);
+			loadedOrder_.prepend(block);
+			continue;
+		}
+
+		ready = false;
+		if(!loading_.contains(block)) {
+			loading_.insert(block);
+			QThreadPool::globalInstance()->start(new MPlotTieredLoadTask(file_->fileName(), coldOffsets_.at(block), coldSizes_.at(block), block, generation_, loadQueue_));
+		}
+	}
+
+	return ready;
+}
+
+void MPlotTieredSeriesData::onBlocksLoaded()
+{
+	QList<MPlotTieredLoadQueue::Result> results = loadQueue_->take();
+
+	int firstBlock = -1, lastBlock = -1;
+	for(int i=0, size=results.size(); i<size; ++i) {
+		const MPlotTieredLoadQueue::Result& result = results.at(i);
+		// loaded before clear()?
+		if(result.generation != generation_)
+			continue;
+
+		loading_.remove(result.block);
+		if(result.bits.isEmpty())
+			continue;
+
+		keepLoaded(result.block, result.bits);
+		if(firstBlock < 0 || result.block < firstBlock)
+			firstBlock = result.block;
+		if(result.block > lastBlock)
+			lastBlock = result.block;
+	}
+
+	// the values didn't change, but they can now be read quickly: have the series draw them.
+	if(firstBlock >= 0)
+		emitValuesChanged(firstBlock*blockSize_, (lastBlock+1)*blockSize_-1, true);
+}
+
+void MPlotTieredSeriesData::clear()
+{
+	++generation_;
+	loading_.clear();
+	loaded_.clear();
+	loadedOrder_.clear();
+	loadedBytes_ = 0;
+
+	coldOffsets_.clear();
+	coldSizes_.clear();
+	coldBlocks_ = 0;
+	coldBytes_ = 0;
+	if(file_)
+		file_->resize(0);
+
+	MPlotCompressedSeriesData::clear();
+}
+
+#endif // MPLOTTIEREDSERIESDATA_CPP
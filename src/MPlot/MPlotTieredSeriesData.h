@@ -0,0 +1,142 @@
+#ifndef MPLOTTIEREDSERIESDATA_H
+#define MPLOTTIEREDSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotCompressedSeriesData.h"
+
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QSharedPointer>
+
+/// The default number of most recent points an MPlotTieredSeriesData keeps in memory.
+#define MPLOT_TIERED_HOT_POINTS (1 << 20)
+/// The default memory, in bytes, an MPlotTieredSeriesData uses for the blocks it pages back in from the file.
+#define MPLOT_TIERED_MEMORY_LIMIT (64 << 20)
+
+class MPlotTieredSeriesData;
+
+/// Loaded blocks waiting to be handed over to an MPlotTieredSeriesData. Shared with the loading tasks, so that it outlives the model if needed.
+class MPlotTieredLoadQueue {
+public:
+	/// A block read from the file.
+	struct Result {
+		int block;
+		int generation;
+		QVector<quint64> bits;
+	};
+
+	/// Constructor. \c receiver gets an onBlocksLoaded() call (queued) when results arrive.
+	MPlotTieredLoadQueue(QObject* receiver) : receiver_(receiver) {}
+
+	/// Called by the loading tasks, in their threads.
+	void add(const Result& result);
+	/// Returns the results added so far, and forgets them.
+	QList<Result> take();
+	/// Stops notifying the receiver. Called when it is deleted.
+	void detach();
+
+protected:
+	QMutex mutex_;
+	QList<Result> results_;
+	QObject* receiver_;
+};
+
+/// This class receives, in the model's thread, the blocks that an MPlotTieredSeriesData loaded in the background.
+class MPLOTSHARED_EXPORT MPlotTieredSeriesLoader : public QObject {
+	Q_OBJECT
+
+public:
+	/// Constructor. The loader must be created in the model's thread.
+	MPlotTieredSeriesLoader(MPlotTieredSeriesData* data);
+
+protected slots:
+	/// Hands the loaded blocks over to the model.
+	void onBlocksLoaded();
+
+protected:
+	MPlotTieredSeriesData* data_;
+};
+
+
+/// This class is a compressed series model for recordings that outgrow memory: the most recent points stay in memory, and older blocks are moved to a file.
+/*! It's an MPlotCompressedSeriesData with two tiers:
+- Hot: the tail, and the sealed blocks holding the last hotPoints() points, are in memory, as in MPlotCompressedSeriesData.
+- Cold: older sealed blocks are appended to a file as they age, and their compressed points are freed.  (The file is only ever appended to, until clear().)
+
+The block summaries always stay in memory, so boundingRect(), blockSummaries() and zoomed-out drawing never touch the file.  When a series needs the points of cold blocks (ex: the user zooms into old history), it calls prefetch(): the blocks are read on a QThreadPool thread, and announced with valuesChanged() when they are ready.  Meanwhile, MPlotSeriesBasic draws them from their summaries.  Cold blocks read back are kept, most recently used first, within memoryLimit() bytes.
+
+Reading the points of a cold block that isn't loaded yet through x(), y(), xValues() or yValues() reads it from the file right away, in the calling thread.
+
+With no file name, a temporary file is used, and removed with the model.  If the file can't be opened, all the blocks stay in memory. */
+class MPLOTSHARED_EXPORT MPlotTieredSeriesData : public MPlotCompressedSeriesData {
+
+public:
+	/// Constructor. Keeps the last \c hotPoints points in memory, and moves older blocks to \c fileName (created or truncated), or to a temporary file if empty.
+	MPlotTieredSeriesData(const QString& fileName = QString(), int hotPoints = MPLOT_TIERED_HOT_POINTS, int blockSize = MPLOT_COMPRESSED_BLOCK_SIZE);
+	/// Destructor.
+	virtual ~MPlotTieredSeriesData();
+
+	/// Loads the cold blocks holding points \c first to \c last in the background, if they aren't in memory.  Returns true if they all are.
+	virtual bool prefetch(int first, int last) const;
+	/// Removes all the points, and empties the file.
+	virtual void clear();
+
+	/// Returns the number of most recent points kept in memory.
+	int hotPoints() const { return hotPoints_; }
+	/// Returns the memory used by the cold blocks read back from the file, at most.
+	qint64 memoryLimit() const { return memoryLimit_; }
+	/// Sets the memory used by the cold blocks read back from the file, at most.  The least recently used ones are dropped first.
+	void setMemoryLimit(qint64 bytes);
+
+	/// Returns the number of bytes of compressed points moved to the file.
+	qint64 coldBytes() const { return coldBytes_; }
+	/// Returns the number of cold blocks currently read back into memory.
+	int loadedColdBlocks() const { return loaded_.size(); }
+	/// Returns the file holding the cold blocks.
+	QString fileName() const;
+
+protected:
+	/// Moves the blocks that aren't among the hotPoints() most recent points to the file.
+	virtual void blockSealed(int block);
+	/// Returns the compressed points of \c block, reading them from the file if needed.
+	virtual const quint64* blockBits(int block) const;
+
+	/// Keeps the \c bits of cold block \c block in memory, dropping the least recently used blocks beyond memoryLimit().
+	void keepLoaded(int block, const QVector<quint64>& bits) const;
+	/// Called by MPlotTieredSeriesLoader with the blocks loaded in the background.
+	void onBlocksLoaded();
+	friend class MPlotTieredSeriesLoader;
+
+	/// The file, open for appending cold blocks and reading them back.
+	QFile* file_;
+	/// Number of most recent points kept in memory.
+	int hotPoints_;
+	/// Number of blocks moved to the file so far (they are the first ones).
+	int coldBlocks_;
+	/// Position and size, in words, of each cold block in the file.
+	QVector<qint64> coldOffsets_;
+	QVector<int> coldSizes_;
+	/// Total size of the cold blocks.
+	qint64 coldBytes_;
+
+	/// Cold blocks read back into memory, and the order they were used in (most recent first).
+	mutable QHash<int, QVector<quint64> > loaded_;
+	mutable QList<int> loadedOrder_;
+	/// Size of loaded_.
+	mutable qint64 loadedBytes_;
+	/// Maximum size of loaded_.
+	qint64 memoryLimit_;
+
+	/// Cold blocks being loaded in the background.
+	mutable QSet<int> loading_;
+	/// Incremented by clear(), so that blocks still being loaded from before are dropped.
+	int generation_;
+	/// Receives the blocks loaded in the background.
+	MPlotTieredSeriesLoader* loader_;
+	QSharedPointer<MPlotTieredLoadQueue> loadQueue_;
+};
+
+#endif // MPLOTTIEREDSERIESDATA_H
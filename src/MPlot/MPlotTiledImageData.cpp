@@ -0,0 +1,323 @@
+#ifndef MPLOTTILEDIMAGEDATA_CPP
+#define MPLOTTILEDIMAGEDATA_CPP
+
+#include "MPlot/MPlotTiledImageData.h"
+
+#include <limits>
+
+// Levels with this many tiles or fewer are pinned in memory, instead of being subject to the LRU cache.
+#define MPLOT_TILED_PINNED_TILES 16
+// Default memory budget for the tile cache, in kilobytes. (256 MB)
+#define MPLOT_TILED_CACHE_LIMIT 262144
+
+MPlotTiledImageData::MPlotTiledImageData(MPlotImageTileSource *source, const QRectF &dataBounds, int tileSize)
+	: MPlotAbstractImageData(),
+	  bounds_(dataBounds)
+{
+	source_ = source;
+	size_ = source_->size();
+
+	tileSize_ = 16;
+	while(tileSize_ < tileSize)
+		tileSize_ *= 2;
+
+	computeLevels();
+	setTileCacheLimit(MPLOT_TILED_CACHE_LIMIT);
+}
+
+MPlotTiledImageData::~MPlotTiledImageData()
+{
+	clearTiles();
+	delete source_;
+	source_ = 0;
+}
+
+void MPlotTiledImageData::computeLevels()
+{
+	levelCount_ = 1;
+	while(levelSize(levelCount_-1).width() > tileSize_ || levelSize(levelCount_-1).height() > tileSize_)
+		levelCount_++;
+
+	firstPinnedLevel_ = levelCount_-1;
+	while(firstPinnedLevel_ > 0) {
+		QSize tiles = levelTileCount(firstPinnedLevel_-1);
+		if(tiles.width()*tiles.height() > MPLOT_TILED_PINNED_TILES)
+			break;
+		firstPinnedLevel_--;
+	}
+}
+
+QSize MPlotTiledImageData::levelSize(int level) const
+{
+	if(size_.width() < 1 || size_.height() < 1)
+		return QSize(0,0);
+
+	// each level rounds up, so that the last value in a level can summarize a partial block.
+	return QSize(((size_.width()-1) >> level) + 1, ((size_.height()-1) >> level) + 1);
+}
+
+QSize MPlotTiledImageData::levelTileCount(int level) const
+{
+	QSize s = levelSize(level);
+	return QSize((s.width()+tileSize_-1)/tileSize_, (s.height()+tileSize_-1)/tileSize_);
+}
+
+void MPlotTiledImageData::setTileCacheLimit(int kilobytes)
+{
+	// a reduced tile holds three channels of values.
+	int minimumLimit = 4*(int(tileSize_*tileSize_*3*sizeof(qreal)/1024) + 1);
+	tileCache_.setMaxCost(qMax(kilobytes, minimumLimit));
+}
+
+void MPlotTiledImageData::clearTiles()
+{
+	tileCache_.clear();
+	qDeleteAll(pinnedTiles_);
+	pinnedTiles_.clear();
+	tileRanges_.clear();
+}
+
+void MPlotTiledImageData::sourceChanged()
+{
+	clearTiles();
+
+	QSize oldSize = size_;
+	size_ = source_->size();
+	computeLevels();
+
+	if(size_ != oldSize)
+		emitBoundsChanged();
+	emitDataChanged();
+}
+
+qreal MPlotTiledImageData::x(int indexX) const
+{
+	return bounds_.left() + bounds_.width()*indexX/size_.width();
+}
+
+qreal MPlotTiledImageData::y(int indexY) const
+{
+	return bounds_.top() + bounds_.height()*indexY/size_.height();
+}
+
+QPoint MPlotTiledImageData::count() const
+{
+	return QPoint(size_.width(), size_.height());
+}
+
+QRectF MPlotTiledImageData::boundingRect() const
+{
+	return bounds_;
+}
+
+MPlotInterval MPlotTiledImageData::range() const
+{
+	if(size_.width() < 1 || size_.height() < 1)
+		return MPlotInterval(0,1);
+
+	return tileRange(0, 0, levelCount_-1);
+}
+
+MPlotInterval MPlotTiledImageData::tileRange(int tileX, int tileY, int level) const
+{
+	MPlotImageTileKey key(level, tileX, tileY);
+
+	if(!tileRanges_.contains(key))
+		tile(level, tileX, tileY);
+
+	return tileRanges_.value(key);
+}
+
+const MPlotImageTile * MPlotTiledImageData::tile(int level, int tileX, int tileY) const
+{
+	MPlotImageTileKey key(level, tileX, tileY);
+
+	if(level >= firstPinnedLevel_) {
+		MPlotImageTile* t = pinnedTiles_.value(key, 0);
+		if(!t) {
+			t = buildTile(level, tileX, tileY);
+			pinnedTiles_.insert(key, t);
+		}
+		return t;
+	}
+
+	MPlotImageTile* t = tileCache_.object(key);
+	if(!t) {
+		t = buildTile(level, tileX, tileY);
+		// setTileCacheLimit() makes sure there's always room for this tile, so the insert can't fail and delete it.
+		tileCache_.insert(key, t, t->cost());
+	}
+	return t;
+}
+
+MPlotImageTile * MPlotTiledImageData::buildTile(int level, int tileX, int tileY) const
+{
+	QSize s = levelSize(level);
+	int x0 = tileX*tileSize_;
+	int y0 = tileY*tileSize_;
+	int width = qMin(tileSize_, s.width()-x0);
+	int height = qMin(tileSize_, s.height()-y0);
+
+	MPlotImageTile* t;
+	const qreal infinity = std::numeric_limits<qreal>::infinity();
+	const qreal nan = std::numeric_limits<qreal>::quiet_NaN();
+
+	if(level == 0) {
+		t = new MPlotImageTile(width, height, false);
+		source_->readBlock(x0, y0, x0+width-1, y0+height-1, t->mean_.data());
+	}
+	else {
+		t = new MPlotImageTile(width, height, true);
+		QSize childTiles = levelTileCount(level-1);
+		int halfTile = tileSize_/2;
+
+		// Each of the (up to) four child tiles below covers one quadrant of this tile.  Use each child as soon as we get it: getting the next one could evict it from the cache.
+		for(int j=0; j<2; ++j) {
+			for(int i=0; i<2; ++i) {
+				int childX = 2*tileX+i;
+				int childY = 2*tileY+j;
+				if(childX >= childTiles.width() || childY >= childTiles.height())
+					continue;
+
+				const MPlotImageTile* child = tile(level-1, childX, childY);
+				int cw = child->width();
+				int ch = child->height();
+				const qreal* childMean = child->values(ReduceMean);
+				const qreal* childMin = child->values(ReduceMinimum);
+				const qreal* childMax = child->values(ReduceMaximum);
+
+				int quadrantWidth = (cw+1)/2;
+				int quadrantHeight = (ch+1)/2;
+
+				for(int qy=0; qy<quadrantHeight; ++qy) {
+					int cy0 = 2*qy;
+					int cy1 = qMin(cy0+1, ch-1);
+					int offset = (j*halfTile+qy)*width + i*halfTile;
+
+					for(int qx=0; qx<quadrantWidth; ++qx) {
+						int cx0 = 2*qx;
+						int cx1 = qMin(cx0+1, cw-1);
+
+						// Blocks at the right and bottom edges can be partial; the mean is over the values that exist.  (This weights a partial block the same as a full one at the next level up, which is a good enough approximation for display.)  NaN values are skipped, as in reduceBlock(); a block of only NaN values stays NaN.
+						qreal sum = 0, minimum = infinity, maximum = -infinity;
+						int n = 0;
+						for(int cy=cy0; cy<=cy1; ++cy) {
+							for(int cx=cx0; cx<=cx1; ++cx) {
+								int c = cy*cw+cx;
+								if(childMean[c] == childMean[c]) {
+									sum += childMean[c];
+									n++;
+								}
+								if(childMin[c] < minimum) minimum = childMin[c];
+								if(childMax[c] > maximum) maximum = childMax[c];
+							}
+						}
+
+						t->mean_[offset+qx] = n ? sum/n : nan;
+						t->minimum_[offset+qx] = n ? minimum : nan;
+						t->maximum_[offset+qx] = n ? maximum : nan;
+					}
+				}
+			}
+		}
+	}
+
+	// remember this tile's summary, even after the tile is evicted.
+	const qreal* minimums = t->values(ReduceMinimum);
+	const qreal* maximums = t->values(ReduceMaximum);
+	MPlotInterval r(infinity, -infinity);
+	int n = width*height;
+	for(int i=0; i<n; ++i) {
+		if(minimums[i] < r.first) r.first = minimums[i];
+		if(maximums[i] > r.second) r.second = maximums[i];
+	}
+	if(r.first > r.second)	// (only NaN in the tile.)
+		r = MPlotInterval(nan, nan);
+	tileRanges_.insert(MPlotImageTileKey(level, tileX, tileY), r);
+
+	return t;
+}
+
+void MPlotTiledImageData::levelValues(int level, ReductionMode mode, int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int rowLength = xEnd-xStart+1;
+
+	for(int tileY=yStart/tileSize_; tileY<=yEnd/tileSize_; ++tileY) {
+		for(int tileX=xStart/tileSize_; tileX<=xEnd/tileSize_; ++tileX) {
+			const MPlotImageTile* t = tile(level, tileX, tileY);
+			const qreal* values = t->values(mode);
+			int x0 = tileX*tileSize_;
+			int y0 = tileY*tileSize_;
+
+			int c0 = qMax(xStart, x0);
+			int c1 = qMin(xEnd, x0+t->width()-1);
+			int r0 = qMax(yStart, y0);
+			int r1 = qMin(yEnd, y0+t->height()-1);
+
+			for(int r=r0; r<=r1; ++r)
+				memcpy(outputValues + (r-yStart)*rowLength + (c0-xStart), values + (r-y0)*t->width() + (c0-x0), (c1-c0+1)*sizeof(qreal));
+		}
+	}
+}
+
+qreal MPlotTiledImageData::z(int indexX, int indexY) const
+{
+	const MPlotImageTile* t = tile(0, indexX/tileSize_, indexY/tileSize_);
+	return t->mean_.at((indexY%tileSize_)*t->width() + indexX%tileSize_);
+}
+
+void MPlotTiledImageData::zValues(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	int columnLength = yEnd-yStart+1;
+
+	for(int tileX=xStart/tileSize_; tileX<=xEnd/tileSize_; ++tileX) {
+		for(int tileY=yStart/tileSize_; tileY<=yEnd/tileSize_; ++tileY) {
+			const MPlotImageTile* t = tile(0, tileX, tileY);
+			const qreal* values = t->mean_.constData();
+			int x0 = tileX*tileSize_;
+			int y0 = tileY*tileSize_;
+
+			int c0 = qMax(xStart, x0);
+			int c1 = qMin(xEnd, x0+t->width()-1);
+			int r0 = qMax(yStart, y0);
+			int r1 = qMin(yEnd, y0+t->height()-1);
+
+			for(int r=r0; r<=r1; ++r) {
+				const qreal* row = values + (r-y0)*t->width() - x0;
+				qreal* output = outputValues + (r-yStart);
+				for(int c=c0; c<=c1; ++c)
+					output[(c-xStart)*columnLength] = row[c];
+			}
+		}
+	}
+}
+
+void MPlotTiledImageData::zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal *outputValues) const
+{
+	levelValues(0, ReduceMean, xStart, yStart, xEnd, yEnd, outputValues);
+}
+
+void MPlotTiledImageData::zValuesReduced(int xStart, int yStart, int xEnd, int yEnd, int outputWidth, int outputHeight, ReductionMode mode, qreal *outputValues) const
+{
+	// find the coarsest level where one value still covers no more source values than one output value does.
+	int factor = qMin((xEnd-xStart+1)/outputWidth, (yEnd-yStart+1)/outputHeight);
+	int level = 0;
+	while(level+1 < levelCount_ && (2 << level) <= factor)
+		level++;
+
+	int levelXStart = xStart >> level;
+	int levelYStart = yStart >> level;
+	int levelWidth = (xEnd >> level) - levelXStart + 1;
+	int levelHeight = (yEnd >> level) - levelYStart + 1;
+
+	if(levelWidth == outputWidth && levelHeight == outputHeight) {
+		levelValues(level, mode, levelXStart, levelYStart, levelXStart+levelWidth-1, levelYStart+levelHeight-1, outputValues);
+		return;
+	}
+
+	QVector<qreal> dataBuffer(levelWidth*levelHeight);
+	levelValues(level, mode, levelXStart, levelYStart, levelXStart+levelWidth-1, levelYStart+levelHeight-1, dataBuffer.data());
+	reduceBlock(dataBuffer.constData(), levelWidth, levelHeight, outputWidth, outputHeight, mode, outputValues);
+}
+
+#endif // MPLOTTILEDIMAGEDATA_CPP
@@ -0,0 +1,207 @@
+#ifndef MPLOTTILEDIMAGEDATA_H
+#define MPLOTTILEDIMAGEDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotImageData.h"
+
+#include <QCache>
+#include <QHash>
+#include <QSize>
+
+
+/// This class defines where an MPlotTiledImageData gets its full-resolution values from.  Re-implement it to read from a file, a database, or an acquisition buffer.
+/*! The tiled image data only asks for blocks the size of one tile (or less, at the right and bottom edges), and only when that tile is not already cached.  The source is owned and deleted by the MPlotTiledImageData that uses it. */
+class MPLOTSHARED_EXPORT MPlotImageTileSource {
+public:
+	/// Destructor.
+	virtual ~MPlotImageTileSource() {}
+
+	/// Return the number of values in x and y.
+	virtual QSize size() const = 0;
+	/// Copy the block of values from (\c xStart, \c yStart) to (\c xEnd, \c yEnd) inclusive into \c outputValues, in scanline order (ie: with y varying the slowest, as in MPlotAbstractImageData::zValuesByScanline()).  Can assume the indexes are in range, and that \c outputValues has enough room.
+	virtual void readBlock(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const = 0;
+};
+
+
+/// This is a tile source that reads from any existing MPlotAbstractImageData model.  Useful to get multi-resolution access to an existing model.  The \c data model is not owned, and must remain valid for the lifetime of the source.
+class MPLOTSHARED_EXPORT MPlotImageDataTileSource : public MPlotImageTileSource {
+public:
+	/// Constructor.
+	MPlotImageDataTileSource(const MPlotAbstractImageData* data) : data_(data) {}
+
+	/// Return the number of values in x and y.
+	virtual QSize size() const { return data_->size(); }
+	/// Reads the block using MPlotAbstractImageData::zValuesByScanline().
+	virtual void readBlock(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const { data_->zValuesByScanline(xStart, yStart, xEnd, yEnd, outputValues); }
+
+protected:
+	/// The model we're reading from.
+	const MPlotAbstractImageData* data_;
+};
+
+
+/// Identifies one tile of an MPlotTiledImageData: the pyramid level, and the tile's position within that level.
+class MPlotImageTileKey {
+public:
+	/// Constructor.
+	MPlotImageTileKey(int level = 0, int tileX = 0, int tileY = 0) : level_(level), tileX_(tileX), tileY_(tileY) {}
+
+	/// The pyramid level. (0 is full resolution; each level above is reduced by 2 in each direction.)
+	int level() const { return level_; }
+	/// The tile's column within its level.
+	int tileX() const { return tileX_; }
+	/// The tile's row within its level.
+	int tileY() const { return tileY_; }
+
+	/// Two keys are equal when they refer to the same tile.
+	bool operator==(const MPlotImageTileKey& other) const { return level_ == other.level_ && tileX_ == other.tileX_ && tileY_ == other.tileY_; }
+
+protected:
+	/// The pyramid level.
+	int level_;
+	/// The tile's column within its level.
+	int tileX_;
+	/// The tile's row within its level.
+	int tileY_;
+};
+
+/// Hash function, so that MPlotImageTileKey can be used in a QCache or QHash.
+inline uint qHash(const MPlotImageTileKey& key) {
+	return uint(key.tileX()) ^ (uint(key.tileY()) << 12) ^ (uint(key.level()) << 26);
+}
+
+
+/// One tile of values, at one level of an MPlotTiledImageData pyramid.
+/*! Values are stored in scanline order.  At level 0 (full resolution) only the mean channel is stored, since the minimum and maximum of a single value are the value itself.  At reduced levels, each value summarizes a 2x2 block of the level below, and the minimum and maximum channels are kept as well. */
+class MPlotImageTile {
+public:
+	/// Constructor. Allocates \c width x \c height values, with the minimum and maximum channels only if \c summarized.
+	MPlotImageTile(int width, int height, bool summarized) : width_(width), height_(height), mean_(width*height) {
+		if(summarized) {
+			minimum_.resize(width*height);
+			maximum_.resize(width*height);
+		}
+	}
+
+	/// Number of values in x.
+	int width() const { return width_; }
+	/// Number of values in y.
+	int height() const { return height_; }
+
+	/// Returns the channel of values to use for the given reduction \c mode.
+	const qreal* values(MPlotAbstractImageData::ReductionMode mode) const {
+		if(mode == MPlotAbstractImageData::ReduceMinimum && !minimum_.isEmpty())
+			return minimum_.constData();
+		if(mode == MPlotAbstractImageData::ReduceMaximum && !maximum_.isEmpty())
+			return maximum_.constData();
+		return mean_.constData();
+	}
+
+	/// Memory used by this tile, in kilobytes. (Used as the cost in the tile cache.)
+	int cost() const { return int((mean_.size() + minimum_.size() + maximum_.size())*sizeof(qreal)/1024) + 1; }
+
+	/// Number of values in x.
+	int width_;
+	/// Number of values in y.
+	int height_;
+	/// Mean values (or the values themselves, at level 0).
+	QVector<qreal> mean_;
+	/// Minimum values. Empty at level 0.
+	QVector<qreal> minimum_;
+	/// Maximum values. Empty at level 0.
+	QVector<qreal> maximum_;
+};
+
+
+/// This class implements MPlotAbstractImageData for very large 2D data sets, which are loaded in fixed-size tiles on demand, and summarized in a multi-resolution (mip) pyramid.
+/*! The full-resolution values come from an MPlotImageTileSource, one square tile (tileSize() x tileSize()) at a time.  Above the full-resolution level 0, each pyramid level reduces the level below by 2 in each direction, keeping the mean, minimum and maximum of each 2x2 block.  The top level fits in a single tile.
+
+Tiles are computed lazily (a pyramid tile is built from the four tiles below it when first needed) and kept in an LRU cache limited to tileCacheLimit() kilobytes.  The coarse levels, which contain only a few tiles, are pinned in memory and never evicted.
+
+zValuesReduced() reads from the coarsest level that still has at least the requested resolution, so an MPlotImageBasic showing a zoomed-out view only touches a handful of small tiles.  The minimum and maximum of each tile are remembered after it is first built (see tileRange()), and range() comes from the top of the pyramid instead of a search through every value.
+
+If the values in the source change, call sourceChanged().
+*/
+class MPLOTSHARED_EXPORT MPlotTiledImageData : public MPlotAbstractImageData {
+
+public:
+	/// Constructor: represent the values from \c source (which becomes owned by this object) with physical coordinate boundaries \c dataBounds. \c tileSize is the width and height of a tile, and is rounded up to a power of 2 (minimum 16).
+	MPlotTiledImageData(MPlotImageTileSource* source, const QRectF& dataBounds, int tileSize = 256);
+	/// Destructor. Deletes the source.
+	virtual ~MPlotTiledImageData();
+
+	/// Return the x (independent data value) corresponding to \c indexX.
+	virtual qreal x(int indexX) const;
+	/// Return the y (independendent data value) corresponding to \c indexY.
+	virtual qreal y(int indexY) const;
+	/// Return the z = f(x,y) dependent data value corresponding (\c indexX, \c indexY). Loads the tile containing it if required.
+	virtual qreal z(int indexX, int indexY) const;
+
+	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues, with the x-axis varying the slowest.
+	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to copy straight out of the full-resolution tiles.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Re-implemented to read from the coarsest pyramid level that still has at least the requested resolution, and reduce from there.
+	virtual void zValuesReduced(int xStart, int yStart, int xEnd, int yEnd, int outputWidth, int outputHeight, ReductionMode mode, qreal* outputValues) const;
+
+	/// Return the number of elements in x and y
+	virtual QPoint count() const;
+	/// Return the bounds of the data (the rectangle containing the max/min x- and y-values)
+	virtual QRectF boundingRect() const;
+	/// Return the minimum and maximum z values, from the top of the pyramid. (The first call builds the pyramid, which reads every tile once.)
+	virtual MPlotInterval range() const;
+
+	/// Returns the width and height of the tiles.
+	int tileSize() const { return tileSize_; }
+	/// Returns the number of pyramid levels, including the full-resolution level 0.
+	int levelCount() const { return levelCount_; }
+	/// Returns the number of values in x and y at pyramid \c level.
+	QSize levelSize(int level) const;
+	/// Returns the number of tiles in x and y at pyramid \c level.
+	QSize levelTileCount(int level) const;
+
+	/// Returns the minimum and maximum of the full-resolution values in tile (\c tileX, \c tileY) at pyramid \c level, skipping NaN values.  Loads the tile if it has never been loaded; after that, the summary is remembered even if the tile is evicted.
+	MPlotInterval tileRange(int tileX, int tileY, int level = 0) const;
+
+	/// Returns the memory budget for cached (un-pinned) tiles, in kilobytes.
+	int tileCacheLimit() const { return tileCache_.maxCost(); }
+	/// Sets the memory budget for cached (un-pinned) tiles, in kilobytes.  The budget is never less than what's needed to hold four tiles.
+	void setTileCacheLimit(int kilobytes);
+
+	/// Call this when the values in the source have changed.  Discards all tiles and summaries, and emits dataChanged().
+	void sourceChanged();
+
+protected:
+	/// The source of full-resolution values.
+	MPlotImageTileSource* source_;
+	/// The number of values in x and y, at full resolution.
+	QSize size_;
+	/// the (min/max) (x/y) values, in physical(data) coordinates. bounds_.upperLeft is == (minX, minY)
+	QRectF bounds_;
+	/// Width and height of a tile. (A power of 2.)
+	int tileSize_;
+	/// Number of pyramid levels.
+	int levelCount_;
+	/// Levels at and above this one are pinned in memory instead of cached.
+	int firstPinnedLevel_;
+
+	/// LRU cache of un-pinned tiles, with costs in kilobytes.
+	mutable QCache<MPlotImageTileKey, MPlotImageTile> tileCache_;
+	/// Tiles in the coarse levels, which are never evicted.
+	mutable QHash<MPlotImageTileKey, MPlotImageTile*> pinnedTiles_;
+	/// The minimum and maximum of every tile that has been built.
+	mutable QHash<MPlotImageTileKey, MPlotInterval> tileRanges_;
+
+	/// Returns the tile at (\c tileX, \c tileY) in pyramid \c level, building it if it's not in memory.  The pointer is only valid until the next call to tile(), since building another tile can evict this one.
+	const MPlotImageTile* tile(int level, int tileX, int tileY) const;
+	/// Builds the tile at (\c tileX, \c tileY) in pyramid \c level: from the source for level 0, or by reducing the four tiles below it.
+	MPlotImageTile* buildTile(int level, int tileX, int tileY) const;
+	/// Copies the block of values from (\c xStart, \c yStart) to (\c xEnd, \c yEnd) inclusive at pyramid \c level into \c outputValues, in scanline order, using the channel for \c mode.
+	void levelValues(int level, ReductionMode mode, int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const;
+	/// Works out the number of pyramid levels, and which are pinned, from size_ and tileSize_.
+	void computeLevels();
+	/// Discards all tiles and summaries.
+	void clearTiles();
+};
+
+#endif // MPLOTTILEDIMAGEDATA_H
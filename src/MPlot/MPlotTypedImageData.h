@@ -0,0 +1,139 @@
+#ifndef MPLOTTYPEDIMAGEDATA_H
+#define MPLOTTYPEDIMAGEDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotImageData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <QVector>
+
+#include <limits>
+
+
+/// Describes how values of type \c T are stored, for MPlotTypedImageData.  IntegerDepth is the number of bits for unsigned integer types that image plots can colorize through a lookup table, or 0 otherwise.
+template<typename T>
+struct MPlotImageValueTraits { enum { IntegerDepth = 0 }; };
+
+/// 8-bit unsigned values can be colorized through a 256-entry lookup table.
+template<>
+struct MPlotImageValueTraits<quint8> { enum { IntegerDepth = 8 }; };
+
+/// 16-bit unsigned values can be colorized through a 65536-entry lookup table.
+template<>
+struct MPlotImageValueTraits<quint16> { enum { IntegerDepth = 16 }; };
+
+
+/// This class is a 2D array of values stored natively as type \c T, which implements the MPlotAbstractImageData interface.
+/*! Use it when your values arrive in a narrower type than qreal (ex: detector frames of 16-bit unsigned integers), to avoid widening every value to 8 bytes.  Values are stored in scanline order (rows of constant y), so zValuesByScanline() is a straight conversion.
+
+For quint8 and quint16 data, integerDepth() is 8 or 16, and MPlotImageBasic colorizes the raw values through a lookup table without any floating-point math.
+
+Use the typedefs MPlotUInt8ImageData, MPlotUInt16ImageData, MPlotInt32ImageData, MPlotFloatImageData and MPlotDoubleImageData.
+*/
+template<typename T>
+class MPlotTypedImageData : public MPlotAbstractImageData {
+
+public:
+	/// Constructor: represent image data with physical coordinate boundaries \c dataBounds, and a resolution (number of "pixels") \c resolution.  Data values are initialized to 0.
+	MPlotTypedImageData(const QRectF& dataBounds, const QSize& resolution)
+		: MPlotAbstractImageData(),
+		  size_(resolution.expandedTo(QSize(1,1))),
+		  bounds_(dataBounds),
+		  d_(size_.width()*size_.height(), T(0))
+	{
+	}
+
+	/// Return the x (independent data value) corresponding to \c indexX.
+	virtual qreal x(int indexX) const { return bounds_.left() + bounds_.width()*indexX/size_.width(); }
+	/// Return the y (independendent data value) corresponding to \c indexY.
+	virtual qreal y(int indexY) const { return bounds_.top() + bounds_.height()*indexY/size_.height(); }
+	/// Return the z = f(x,y) dependent data value corresponding (\c indexX, \c indexY). Can assume (\c indexX, \c indexY) are valid.
+	virtual qreal z(int indexX, int indexY) const { return qreal(d_.at(indexY*size_.width() + indexX)); }
+
+	/// Copy an entire block of z = f(x,y) values from (xStart,yStart) to (xEnd,yEnd) inclusive, into \c outputValues, with the x-axis varying the slowest.
+	virtual void zValues(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const {
+		const T* values = d_.constData();
+		int width = size_.width();
+		for(int xx=xStart; xx<=xEnd; ++xx)
+			for(int yy=yStart; yy<=yEnd; ++yy)
+				*(outputValues++) = qreal(values[yy*width + xx]);
+	}
+	/// Re-implemented to convert straight out of our row storage, without any transposing.
+	virtual void zValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, qreal* outputValues) const {
+		const T* values = d_.constData();
+		int width = size_.width();
+		for(int yy=yStart; yy<=yEnd; ++yy) {
+			const T* row = values + yy*width;
+			for(int xx=xStart; xx<=xEnd; ++xx)
+				*(outputValues++) = qreal(row[xx]);
+		}
+	}
+
+	/// Returns 8 for quint8 data, 16 for quint16 data, and 0 otherwise.
+	virtual int integerDepth() const { return MPlotImageValueTraits<T>::IntegerDepth; }
+	/// Copies the raw values, for quint8 and quint16 data.
+	virtual void integerValuesByScanline(int xStart, int yStart, int xEnd, int yEnd, quint16* outputValues) const {
+		const T* values = d_.constData();
+		int width = size_.width();
+		for(int yy=yStart; yy<=yEnd; ++yy) {
+			const T* row = values + yy*width;
+			for(int xx=xStart; xx<=xEnd; ++xx)
+				*(outputValues++) = quint16(row[xx]);
+		}
+	}
+
+	/// Return the number of elements in x and y
+	virtual QPoint count() const { return QPoint(size_.width(), size_.height()); }
+	/// Return the bounds of the data (the rectangle containing the max/min x- and y-values)
+	virtual QRectF boundingRect() const { return bounds_; }
+
+	/// Returns the value at (\c indexX, \c indexY), in its native type.
+	T value(int indexX, int indexY) const { return d_.at(indexY*size_.width() + indexX); }
+	/// Direct read access to the values, in scanline order. (size().width()*size().height() values)
+	const T* constData() const { return d_.constData(); }
+
+	/// Write interface: set the z value at (\c indexX, \c indexY).
+	void setZ(T value, int indexX, int indexY) {
+		d_[indexY*size_.width() + indexX] = value;
+		emitDataChanged();
+	}
+	/// Write interface: replace all the values at once (ex: with a new frame from a detector).  \c values must hold size().width()*size().height() values, in scanline order.  Emits dataChanged() once.
+	void setValues(const T* values) {
+		memcpy(d_.data(), values, d_.size()*sizeof(T));
+		emitDataChanged();
+	}
+
+protected:
+	/// resolution: number of values in x and y
+	QSize size_;
+	/// the (min/max) (x/y) values, in physical(data) coordinates. bounds_.upperLeft is == (minX, minY)
+	QRectF bounds_;
+	/// Stores raw data, in scanline order. (d_.count() == size_.width()*size_.height())
+	QVector<T> d_;
+
+	/// Re-implemented to search the native values directly, without converting them to qreal.  NaN values are skipped.
+	virtual void minMaxSearch() const {
+		T minZ, maxZ;
+		// (all NaN: NaN bounds, like the MPlotMinMax search of the base class.)
+		if(MPlotMinMax::searchNative(d_.constData(), d_.size(), minZ, maxZ)) {
+			minMaxCache_.first = qreal(minZ);
+			minMaxCache_.second = qreal(maxZ);
+		}
+		else
+			minMaxCache_.first = minMaxCache_.second = std::numeric_limits<qreal>::quiet_NaN();
+		minMaxCacheUpdateRequired_ = false;
+	}
+};
+
+/// Image data stored as 8-bit unsigned integers.
+typedef MPlotTypedImageData<quint8> MPlotUInt8ImageData;
+/// Image data stored as 16-bit unsigned integers.
+typedef MPlotTypedImageData<quint16> MPlotUInt16ImageData;
+/// Image data stored as 32-bit signed integers.
+typedef MPlotTypedImageData<qint32> MPlotInt32ImageData;
+/// Image data stored as single-precision floating point.
+typedef MPlotTypedImageData<float> MPlotFloatImageData;
+/// Image data stored as double-precision floating point.
+typedef MPlotTypedImageData<double> MPlotDoubleImageData;
+
+#endif // MPLOTTYPEDIMAGEDATA_H
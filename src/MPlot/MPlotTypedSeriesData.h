@@ -0,0 +1,186 @@
+#ifndef MPLOTTYPEDSERIESDATA_H
+#define MPLOTTYPEDSERIESDATA_H
+
+#include "MPlot/MPlot_global.h"
+#include "MPlot/MPlotSeriesData.h"
+#include "MPlot/MPlotMinMax.h"
+
+#include <QVector>
+
+/// This class is an implementation of MPlotAbstractSeriesData that stores the x and y values in their native types \c TX and \c TY, instead of as qreal.
+/*! Use it when your values arrive in a narrower type (ex: int16 ADC samples), to avoid widening every value to 8 bytes.  Each axis has a linear scaling from the stored values to plot values: plotValue = offset + scale*storedValue. The scaling is applied while copying out in xValues() and yValues(), in a simple loop that the compiler can vectorize.
+
+If you only set y values (setYValues()), no x values are stored at all: x is computed from the index, as xOffset + xScale*index.  A 100 million point int16 trace then takes 200 MB.
+
+The boundingRect() is searched in the native types (skipping NaN values, as MPlotMinMax does), and cached until the data or scaling changes.  If all the x or y values are NaN, it is empty.
+
+Use the typedefs MPlotFloatSeriesData, MPlotInt16SeriesData and MPlotInt32SeriesData, or instantiate your own.
+*/
+template<typename TX, typename TY>
+class MPlotTypedSeriesData : public MPlotAbstractSeriesData {
+
+public:
+	/// Constructs an empty data model, with no scaling (scale 1, offset 0).
+	MPlotTypedSeriesData() : MPlotAbstractSeriesData() {
+		xScale_ = yScale_ = 1;
+		xOffset_ = yOffset_ = 0;
+	}
+
+	/// Implements MPlotAbstractSeriesData: returns the x value at \c index.
+	virtual qreal x(unsigned index) const { return xOffset_ + xScale_*(xValues_.isEmpty() ? qreal(index) : qreal(xValues_.at(index))); }
+	/// Copy all the x values from \c indexStart to \c indexEnd (inclusive) into \c outputValues, applying the x scaling.
+	virtual void xValues(unsigned indexStart, unsigned indexEnd, qreal *outputValues) const {
+		int n = indexEnd-indexStart+1;
+		if(xValues_.isEmpty()) {
+			for(int i=0; i<n; ++i)
+				outputValues[i] = xOffset_ + xScale_*qreal(indexStart+i);
+			return;
+		}
+		const TX* source = xValues_.constData() + indexStart;
+		for(int i=0; i<n; ++i)
+			outputValues[i] = xOffset_ + xScale_*qreal(source[i]);
+	}
+	/// Implements MPlotAbstractSeriesData: returns the y value at \c index.
+	virtual qreal y(unsigned index) const { return yOffset_ + yScale_*qreal(yValues_.at(index)); }
+	/// Copy all the y values from \c indexStart to \c indexEnd (inclusive) into \c outputValues, applying the y scaling.
+	virtual void yValues(unsigned indexStart, unsigned indexEnd, qreal* outputValues) const {
+		int n = indexEnd-indexStart+1;
+		const TY* source = yValues_.constData() + indexStart;
+		for(int i=0; i<n; ++i)
+			outputValues[i] = yOffset_ + yScale_*qreal(source[i]);
+	}
+
+	/// Implements MPlotAbstractSeriesData: returns the number of data points.
+	virtual int count() const { return yValues_.count(); }
+
+	/// Re-implemented to search the stored values in their native types (one pass per axis), and then apply the scaling.
+	virtual QRectF boundingRect() const {
+		int size = count();
+		if(size == 0)
+			return QRectF();
+
+		if(cachedDataRectUpdateRequired_) {
+			qreal minX, maxX, minY, maxY;
+			// (all NaN on either axis: nothing to bound.)
+			bool valid = true;
+
+			if(xValues_.isEmpty()) {
+				minX = xOffset_;
+				maxX = xOffset_ + xScale_*(size-1);
+			}
+			else {
+				TX nativeMin = TX(), nativeMax = TX();
+				valid = MPlotMinMax::searchNative(xValues_.constData(), xValues_.count(), nativeMin, nativeMax);
+				minX = xOffset_ + xScale_*qreal(nativeMin);
+				maxX = xOffset_ + xScale_*qreal(nativeMax);
+			}
+
+			TY nativeMin = TY(), nativeMax = TY();
+			valid = MPlotMinMax::searchNative(yValues_.constData(), yValues_.count(), nativeMin, nativeMax) && valid;
+			minY = yOffset_ + yScale_*qreal(nativeMin);
+			maxY = yOffset_ + yScale_*qreal(nativeMax);
+
+			// a negative scale flips the order:
+			if(minX > maxX) qSwap(minX, maxX);
+			if(minY > maxY) qSwap(minY, maxY);
+
+			// as in MPlotAbstractSeriesData::boundingRect(): make sure a single data point still has a valid rectangle.
+			if(valid)
+				cachedDataRect_ = QRectF(minX,
+										 minY,
+										 qMax(maxX-minX, std::numeric_limits<qreal>::min()),
+										 qMax(maxY-minY, std::numeric_limits<qreal>::min()));
+			else
+				cachedDataRect_ = QRectF();
+			cachedDataRectUpdateRequired_ = false;
+		}
+
+		return cachedDataRect_;
+	}
+	/// Re-implemented to return true: reading the vectors doesn't modify anything.
+	virtual bool concurrentReadsSafe() const { return true; }
+	/// Re-implemented to return true when no x values are stored, since x is then xOffset + xScale*index.
+	virtual bool uniformXSpacing(qreal& x0, qreal& dx) const {
+		if(!xValues_.isEmpty())
+			return false;
+		x0 = xOffset_;
+		dx = xScale_;
+		return true;
+	}
+
+	/// Set the X and Y values. \c xValues and \c yValues must have the same size(); if not, this does nothing and returns false.
+	bool setValues(const QVector<TX>& xValues, const QVector<TY>& yValues) {
+		if(xValues.count() != yValues.count())
+			return false;
+
+		xValues_ = xValues;
+		yValues_ = yValues;
+		emitDataReset();
+		return true;
+	}
+	/// Set only the Y values. No x values are stored; x is computed from the index using the x scaling.
+	void setYValues(const QVector<TY>& yValues) {
+		xValues_.clear();
+		yValues_ = yValues;
+		emitDataReset();
+	}
+	/// Set a specfic X value. \c index must be in range for the current data, and x values must be stored (not computed from the index), otherwise does nothing and returns false.
+	bool setXValue(int index, TX xValue) {
+		if(index < 0 || index >= xValues_.count())
+			return false;
+
+		xValues_[index] = xValue;
+		emitValuesChanged(index, index);
+		return true;
+	}
+	/// Set a specific Y value. \c index must be in range for the current data, otherwise does nothing and returns false.
+	bool setYValue(int index, TY yValue) {
+		if(index < 0 || index >= yValues_.count())
+			return false;
+
+		yValues_[index] = yValue;
+		emitValuesChanged(index, index);
+		return true;
+	}
+
+	/// Returns the scale applied to stored x values.
+	qreal xScale() const { return xScale_; }
+	/// Returns the offset added to scaled x values.
+	qreal xOffset() const { return xOffset_; }
+	/// Returns the scale applied to stored y values.
+	qreal yScale() const { return yScale_; }
+	/// Returns the offset added to scaled y values.
+	qreal yOffset() const { return yOffset_; }
+	/// Sets the x scaling: plotted x = \c offset + \c scale*(stored x, or the index if no x values are stored).
+	void setXScaling(qreal scale, qreal offset) { xScale_ = scale; xOffset_ = offset; emitDataReset(); }
+	/// Sets the y scaling: plotted y = \c offset + \c scale*(stored y).
+	void setYScaling(qreal scale, qreal offset) { yScale_ = scale; yOffset_ = offset; emitDataReset(); }
+
+	/// Direct read access to the stored x values. Empty if x is computed from the index.
+	const QVector<TX>& storedXValues() const { return xValues_; }
+	/// Direct read access to the stored y values.
+	const QVector<TY>& storedYValues() const { return yValues_; }
+
+protected:
+	/// Stored x values. Empty if x is computed from the index.
+	QVector<TX> xValues_;
+	/// Stored y values.
+	QVector<TY> yValues_;
+	/// Scale applied to stored x values.
+	qreal xScale_;
+	/// Offset added to scaled x values.
+	qreal xOffset_;
+	/// Scale applied to stored y values.
+	qreal yScale_;
+	/// Offset added to scaled y values.
+	qreal yOffset_;
+};
+
+/// Series data stored as single-precision floating point.  Stored float x values are only exact integers up to 2^24 (about 16.7 million): beyond that, neighbouring sample numbers or timestamps collapse together.  Use it for x values that stay within that resolution, or set only y values and let x be computed from the index.
+typedef MPlotTypedSeriesData<float, float> MPlotFloatSeriesData;
+/// Series data with 16-bit signed integer y values (ex: ADC samples), and double-precision x values (or x computed from the index), so that long traces keep a distinct x for every sample.
+typedef MPlotTypedSeriesData<double, qint16> MPlotInt16SeriesData;
+/// Series data with 32-bit signed integer y values, and double-precision x values (or x computed from the index).
+typedef MPlotTypedSeriesData<double, qint32> MPlotInt32SeriesData;
+
+#endif // MPLOTTYPEDSERIESDATA_H